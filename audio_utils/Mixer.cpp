@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_Mixer"
+
+#include <algorithm>
+#include <errno.h>
+#include <sstream>
+
+#include <audio_utils/format.h>
+#include <audio_utils/Mixer.h>
+#include <audio_utils/primitives.h>
+#include <log/log.h>
+
+namespace android::audio_utils {
+
+namespace {
+
+// The accumulator of a tile is kept within this size, so that it stays in the L1 data cache
+// while every track is added to it.
+constexpr size_t kTileBytes = 8192;
+
+// Tiles are a multiple of this many frames, to keep the vector kernels on their fast path.
+constexpr size_t kTileAlignFrames = 16;
+
+bool isSupportedFormat(audio_format_t format)
+{
+    switch (format) {
+    case AUDIO_FORMAT_PCM_16_BIT:
+    case AUDIO_FORMAT_PCM_8_BIT:
+    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+    case AUDIO_FORMAT_PCM_32_BIT:
+    case AUDIO_FORMAT_PCM_8_24_BIT:
+    case AUDIO_FORMAT_PCM_FLOAT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t channelCountFromMask(audio_channel_mask_t channelMask)
+{
+    const uint32_t channelCount = audio_channel_count_from_out_mask(channelMask);
+    return channelCount <= AUDIO_CHANNEL_COUNT_MAX ? channelCount : 0;
+}
+
+size_t tileFramesFromChannelCount(uint32_t channelCount)
+{
+    const size_t frames = kTileBytes / (channelCount * sizeof(float));
+    return std::max(kTileAlignFrames, frames / kTileAlignFrames * kTileAlignFrames);
+}
+
+} // namespace
+
+Mixer::Mixer(audio_format_t format, audio_channel_mask_t channelMask, size_t maxTracks)
+    : mFormat(format)
+    , mChannelMask(channelMask)
+    , mChannelCount(channelCountFromMask(channelMask))
+    , mFrameSize(mChannelCount * audio_bytes_per_sample(format))
+    , mTileFrames(tileFramesFromChannelCount(std::max(mChannelCount, 1u)))
+    , mTracks(maxTracks)
+    , mAccumulator(mTileFrames * mChannelCount)
+    , mConverted(mTileFrames * mChannelCount)
+{
+    LOG_ALWAYS_FATAL_IF(!isSupportedFormat(format), "invalid format %#x", format);
+    LOG_ALWAYS_FATAL_IF(mChannelCount == 0, "invalid channel mask %#x", channelMask);
+}
+
+int Mixer::addTrack(audio_format_t format, audio_channel_mask_t channelMask)
+{
+    const uint32_t channelCount = channelCountFromMask(channelMask);
+    if (!isSupportedFormat(format) || channelCount == 0) {
+        return -EINVAL;
+    }
+    const auto it = std::find_if(mTracks.begin(), mTracks.end(),
+            [](const Track &track) { return !track.active; });
+    if (it == mTracks.end()) {
+        return -ENOSPC;
+    }
+
+    Track track;
+    if (memcpy_by_index_array_initialization_from_channel_mask(track.idxary,
+            std::size(track.idxary), mChannelMask, channelMask) == 0) {
+        return -EINVAL;
+    }
+    track.remap = channelMask != mChannelMask;
+    if (channelCount == 1 && track.remap
+            && audio_channel_mask_get_representation(mChannelMask)
+                    == AUDIO_CHANNEL_REPRESENTATION_POSITION
+            && (mChannelMask & AUDIO_CHANNEL_OUT_STEREO) == AUDIO_CHANNEL_OUT_STEREO) {
+        // Mono plays on both front left and front right, which are the first two channels.
+        track.idxary[0] = 0;
+        track.idxary[1] = 0;
+    }
+    if (track.remap && memcpy_by_index_array_plan_init(&track.remapPlan,
+            mChannelCount, channelCount, track.idxary, sizeof(float)) != 0) {
+        return -EINVAL;
+    }
+    track.active = true;
+    track.format = format;
+    track.channelMask = channelMask;
+    track.channelCount = channelCount;
+    track.frameSize = channelCount * audio_bytes_per_sample(format);
+    if (track.remap && mScratch.size() < mTileFrames * channelCount) {
+        mScratch.resize(mTileFrames * channelCount);
+    }
+    *it = track;
+    return it - mTracks.begin();
+}
+
+int Mixer::removeTrack(int track)
+{
+    if (!isValidTrack(track)) {
+        return -EINVAL;
+    }
+    mTracks[track] = Track{};
+    return 0;
+}
+
+int Mixer::setBuffer(int track, const void *buffer)
+{
+    if (!isValidTrack(track)) {
+        return -EINVAL;
+    }
+    mTracks[track].buffer = buffer;
+    return 0;
+}
+
+int Mixer::setVolume(int track, float volume, size_t rampFrames)
+{
+    if (!isValidTrack(track)) {
+        return -EINVAL;
+    }
+    Track &t = mTracks[track];
+    if (rampFrames == 0) {
+        t.rampFrames = 0;
+    } else {
+        // During the ramp, the volume is volume - rampIncrement * (frames remaining).
+        const float current = t.volume - t.rampIncrement * t.rampFrames;
+        t.rampIncrement = (volume - current) / rampFrames;
+        t.rampFrames = rampFrames;
+    }
+    t.volume = volume;
+    return 0;
+}
+
+void Mixer::process(void *buffer, size_t frames)
+{
+    uint8_t *out = (uint8_t *)buffer;
+    for (size_t offset = 0; offset < frames; offset += mTileFrames) {
+        const size_t tileFrames = std::min(frames - offset, mTileFrames);
+        std::fill(mAccumulator.begin(), mAccumulator.begin() + tileFrames * mChannelCount, 0.f);
+        for (Track &track : mTracks) {
+            if (track.active && track.buffer != nullptr) {
+                mixTrack(track, (const uint8_t *)track.buffer + offset * track.frameSize,
+                        tileFrames);
+            }
+        }
+        memcpy_by_audio_format(out, mFormat, mAccumulator.data(), AUDIO_FORMAT_PCM_FLOAT,
+                tileFrames * mChannelCount);
+        out += tileFrames * mFrameSize;
+    }
+}
+
+void Mixer::mixTrack(Track &track, const uint8_t *src, size_t frames)
+{
+    float *acc = mAccumulator.data();
+    const size_t count = frames * mChannelCount;
+
+    if (!track.remap && track.rampFrames == 0) {
+        // Convert and accumulate in a single pass for the common formats.
+        switch (track.format) {
+        case AUDIO_FORMAT_PCM_16_BIT:
+            accumulate_float_from_i16(acc, (const int16_t *)src, count, track.volume);
+            return;
+        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+            accumulate_float_from_p24(acc, src, count, track.volume);
+            return;
+        case AUDIO_FORMAT_PCM_32_BIT:
+            accumulate_float_from_i32(acc, (const int32_t *)src, count, track.volume);
+            return;
+        case AUDIO_FORMAT_PCM_FLOAT:
+            accumulate_float_from_float(acc, (const float *)src, count, track.volume);
+            return;
+        default:
+            break;
+        }
+    }
+
+    // Otherwise convert to float in the output channels first.
+    const float *converted;
+    if (track.remap) {
+        memcpy_by_audio_format(mScratch.data(), AUDIO_FORMAT_PCM_FLOAT, src, track.format,
+                frames * track.channelCount);
+        memcpy_by_index_array_with_plan(mConverted.data(), mScratch.data(),
+                &track.remapPlan, frames);
+        converted = mConverted.data();
+    } else if (track.format == AUDIO_FORMAT_PCM_FLOAT) {
+        converted = (const float *)src;
+    } else {
+        memcpy_by_audio_format(mConverted.data(), AUDIO_FORMAT_PCM_FLOAT, src, track.format,
+                count);
+        converted = mConverted.data();
+    }
+
+    size_t rampFrames = std::min(frames, track.rampFrames);
+    track.rampFrames -= rampFrames;
+    for (; rampFrames > 0; --rampFrames) {
+        const float volume =
+                track.volume - track.rampIncrement * (track.rampFrames + rampFrames - 1);
+        for (uint32_t i = 0; i < mChannelCount; ++i) {
+            *acc++ += *converted++ * volume;
+        }
+        --frames;
+    }
+    accumulate_float_from_float(acc, converted, frames * mChannelCount, track.volume);
+}
+
+std::string Mixer::toString() const
+{
+    std::stringstream ss;
+    ss << "format " << mFormat << " channelMask " << mChannelMask
+            << " tileFrames " << mTileFrames << " tracks:";
+    for (size_t i = 0; i < mTracks.size(); ++i) {
+        const Track &track = mTracks[i];
+        if (track.active) {
+            ss << "\n  " << i << ": format " << track.format
+                    << " channelMask " << track.channelMask << " volume " << track.volume;
+            if (track.rampFrames > 0) {
+                ss << " rampFrames " << track.rampFrames;
+            }
+        }
+    }
+    return ss.str();
+}
+
+} // namespace android::audio_utils
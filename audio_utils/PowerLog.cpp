@@ -23,13 +23,19 @@
 #include <math.h>
 #include <sstream>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <vector>
 
 #include <audio_utils/clock.h>
+#include <audio_utils/fixedfft.h>
+#include <audio_utils/format.h>
 #include <audio_utils/LogPlot.h>
 #include <audio_utils/power.h>
 #include <audio_utils/PowerLog.h>
+#include <audio_utils/roundup.h>
+
+#include "private/fifo_torn.h"
 
 namespace android {
 
@@ -44,7 +50,10 @@ PowerLog::PowerLog(uint32_t sampleRate,
         uint32_t channelCount,
         audio_format_t format,
         size_t entries,
-        size_t framesPerEntry)
+        size_t framesPerEntry,
+        bool lockFree,
+        bool perChannel,
+        uint32_t bands)
     : mCurrentTime(0)
     , mCurrentEnergy(0)
     , mCurrentFrames(0)
@@ -55,15 +64,206 @@ PowerLog::PowerLog(uint32_t sampleRate,
     , mFormat(format)
     , mFramesPerEntry(framesPerEntry)
     , mEntries(entries)
+    , mEntryCount(0)
+    , mLockFree(lockFree)
+    , mPerChannel(perChannel)
+    , mBands(bands)
+    , mDetailCount((perChannel ? channelCount : 0) + bands)
+    , mCurrentDetails(mDetailCount)
+    , mLastBandShares(bands)
+    , mDetails(entries * mDetailCount)
+    , mFftFrames(0)
 {
-    (void)mSampleRate; // currently unused, for future use
     LOG_ALWAYS_FATAL_IF(!audio_utils_is_compute_power_format_supported(format),
             "unsupported format: %#x", format);
+    LOG_ALWAYS_FATAL_IF(bands > kMaxBands, "bands %u > %u", bands, kMaxBands);
+    if (mPerChannel) {
+        mChannelEnergies.resize(channelCount);
+    }
+    if (mBands > 0) {
+        mScratch.resize(kFftFrames * channelCount);
+        mFftSamples.resize(kFftFrames);
+        mFft.resize(kFftFrames / 2);
+        mWindow.resize(kFftFrames);
+        for (size_t i = 0; i < kFftFrames; ++i) {
+            mWindow[i] = 0.5f - 0.5f * cosf(2.f * (float) M_PI * i / kFftFrames);
+        }
+        // The spectrum has kFftFrames / 2 + 1 bins from DC to Nyquist.  The bands are spaced
+        // evenly on a log scale of the bin number, each with at least one bin.
+        const uint32_t bins = kFftFrames / 2 + 1;
+        mBandEdges[0] = 0;
+        for (uint32_t b = 1; b < mBands; ++b) {
+            const uint32_t edge = lroundf(powf(bins, (float) b / mBands));
+            mBandEdges[b] = std::min(std::max(edge, mBandEdges[b - 1] + 1), bins - (mBands - b));
+        }
+        mBandEdges[mBands] = bins;
+    }
+    if (mLockFree) {
+        // One more than the history, as drain() discards the oldest bin of a full ring,
+        // which log() may be overwriting.  A power of 2 keeps the fifo indices simple.
+        const uint32_t frameCount = roundup(entries + 1);
+        // Each frame is an Entry followed by its details, padded to keep Entry aligned.
+        const size_t words = (sizeof(Entry) + mDetailCount * sizeof(float) + sizeof(uint64_t) - 1)
+                / sizeof(uint64_t);
+        mRingBuffer.reset(new uint64_t[frameCount * words]);
+        mRing.reset(new audio_utils_fifo(frameCount, words * sizeof(uint64_t), mRingBuffer.get(),
+                false /*throttlesWriter*/));
+        mRingWriter.reset(new audio_utils_fifo_writer(*mRing));
+        mRingReader.reset(new audio_utils_fifo_reader(*mRing, false /*throttlesWriter*/));
+        mRingFrame.resize(words);
+        mDrainFrames.resize(words * kDrainFrames);
+    }
+}
+
+void PowerLog::append(int64_t time, float energy, const float *details)
+{
+    if (mLockFree) {
+        // Never blocks, as the reader does not throttle the writer.
+        // Written one bin at a time, so that drain() knows which slot may be in use.
+        const Entry entry = {time, energy};
+        uint8_t *frame = (uint8_t *) mRingFrame.data();
+        memcpy(frame, &entry, sizeof(entry));
+        if (details != nullptr) {
+            memcpy(frame + sizeof(entry), details, mDetailCount * sizeof(float));
+        } else {
+            memset(frame + sizeof(entry), 0, mDetailCount * sizeof(float));
+        }
+        (void)mRingWriter->write(frame, 1 /*count*/);
+    } else {
+        appendHistory(time, energy, details);
+    }
+}
+
+void PowerLog::appendHistory(int64_t time, float energy, const float *details) const
+{
+    float *entryDetails = mDetails.data() + mIdx * mDetailCount;
+    for (size_t i = 0; i < mDetailCount; ++i) {
+        entryDetails[i] = details != nullptr ? details[i] : 0.f;
+    }
+    mEntries[mIdx++] = std::make_pair(time, energy);
+    if (mIdx >= mEntries.size()) {
+        mIdx -= mEntries.size();
+    }
+    if (mEntryCount < mEntries.size()) {
+        ++mEntryCount;
+    }
+}
+
+void PowerLog::drain() const
+{
+    if (!mLockFree) {
+        return;
+    }
+    const size_t words = mRingFrame.size();
+    for (;;) {
+        ssize_t actual = mRingReader->read(mDrainFrames.data(), kDrainFrames, NULL /*timeout*/);
+        if (actual == -EOVERFLOW) {
+            // Some bins were overwritten before being read, so terminate the signal
+            // sequence rather than join its parts.  The reader has caught up for the next read.
+            if (mEntries[(mIdx + mEntries.size() - 1) % mEntries.size()].second != 0.f) {
+                appendHistory(0 /*time*/, 0.f /*energy*/, nullptr /*details*/);
+            }
+            continue;
+        }
+        if (actual <= 0) {
+            break;
+        }
+        const size_t torn = fifoTornFrames(*mRingReader, actual);
+        if (torn > 0 && mEntries[(mIdx + mEntries.size() - 1) % mEntries.size()].second != 0.f) {
+            appendHistory(0 /*time*/, 0.f /*energy*/, nullptr /*details*/);
+        }
+        for (size_t i = torn; i < (size_t) actual; ++i) {
+            const uint8_t *frame = (const uint8_t *) (mDrainFrames.data() + i * words);
+            Entry entry;
+            memcpy(&entry, frame, sizeof(entry));
+            appendHistory(entry.mTime, entry.mEnergy, (const float *) (frame + sizeof(entry)));
+        }
+    }
+}
+
+void PowerLog::analyzeBands(const void *buffer, size_t frames)
+{
+    const size_t bytesPerFrame = audio_bytes_per_sample(mFormat) * mChannelCount;
+    while (frames > 0) {
+        const size_t process = std::min(kFftFrames - mFftFrames, frames);
+        memcpy_by_audio_format(mScratch.data(), AUDIO_FORMAT_PCM_FLOAT, buffer, mFormat,
+                process * mChannelCount);
+        for (size_t i = 0; i < process; ++i) {
+            float sum = 0.f;
+            for (uint32_t ch = 0; ch < mChannelCount; ++ch) {
+                sum += mScratch[i * mChannelCount + ch];
+            }
+            mFftSamples[mFftFrames + i] = sum;
+        }
+        mFftFrames += process;
+        if (mFftFrames == kFftFrames) {
+            analyzeWindow();
+            mFftFrames = 0;
+        }
+        frames -= process;
+        buffer = (const uint8_t *)buffer + process * bytesPerFrame;
+    }
+}
+
+void PowerLog::analyzeWindow()
+{
+    float peak = 0.f;
+    for (size_t i = 0; i < kFftFrames; ++i) {
+        mFftSamples[i] *= mWindow[i];
+        peak = std::max(peak, fabsf(mFftSamples[i]));
+    }
+    if (peak == 0.f) {
+        return; // keep the shares of the previous window
+    }
+    // fixed_fft_real() takes 16 bit samples, so normalize the window to full scale
+    // to keep the precision of quiet signals, and undo the gain on the spectrum.
+    const float gain = 32767.f / peak;
+    for (size_t i = 0; i < kFftFrames / 2; ++i) {
+        const int32_t re = lroundf(mFftSamples[2 * i] * gain);
+        const int32_t im = lroundf(mFftSamples[2 * i + 1] * gain);
+        mFft[i] = (int32_t) ((uint32_t) re << 16 | (uint16_t) im);
+    }
+    fixed_fft_real(kFftFrames / 2, mFft.data());
+
+    // Bin 0 holds DC in its real part and Nyquist in its imaginary part.
+    const uint32_t bins = kFftFrames / 2 + 1;
+    float bands[kMaxBands] = {};
+    float total = 0.f;
+    uint32_t band = 0;
+    for (uint32_t k = 0; k < bins; ++k) {
+        float energy;
+        if (k == 0 || k == bins - 1) {
+            const int16_t value = k == 0 ? mFft[0] >> 16 : (int16_t) mFft[0];
+            energy = (float) value * value;
+        } else {
+            const float re = (int16_t) (mFft[k] >> 16);
+            const float im = (int16_t) mFft[k];
+            // The other half of the spectrum mirrors this bin.
+            energy = 2.f * (re * re + im * im);
+        }
+        while (k >= mBandEdges[band + 1]) {
+            ++band;
+        }
+        bands[band] += energy;
+        total += energy;
+    }
+    if (total == 0.f) {
+        return;
+    }
+    // Only the shares of the bands matter, so the gain need not be undone.
+    const size_t offset = mPerChannel ? mChannelCount : 0;
+    for (uint32_t b = 0; b < mBands; ++b) {
+        mLastBandShares[b] = bands[b] / total;
+        mCurrentDetails[offset + b] += mLastBandShares[b];
+    }
 }
 
 void PowerLog::log(const void *buffer, size_t frames, int64_t nowNs)
 {
-    std::lock_guard<std::mutex> guard(mLock);
+    std::unique_lock<std::mutex> guard(mLock, std::defer_lock);
+    if (!mLockFree) {
+        guard.lock();
+    }
 
     const size_t bytes_per_sample = audio_bytes_per_sample(mFormat);
     while (frames > 0) {
@@ -74,8 +274,20 @@ void PowerLog::log(const void *buffer, size_t frames, int64_t nowNs)
         if (mCurrentTime == 0) {
             mCurrentTime = nowNs;
         }
-        mCurrentEnergy +=
-                audio_utils_compute_energy_mono(buffer, mFormat, process * mChannelCount);
+        if (mPerChannel) {
+            audio_utils_compute_energy_by_channel(buffer, mFormat, process, mChannelCount,
+                    mChannelEnergies.data());
+            for (uint32_t ch = 0; ch < mChannelCount; ++ch) {
+                mCurrentEnergy += mChannelEnergies[ch];
+                mCurrentDetails[ch] += mChannelEnergies[ch];
+            }
+        } else {
+            mCurrentEnergy +=
+                    audio_utils_compute_energy_mono(buffer, mFormat, process * mChannelCount);
+        }
+        if (mBands > 0) {
+            analyzeBands(buffer, process);
+        }
         mCurrentFrames += process;
 
         ALOGV("nowNs:%lld, required:%zu, process:%zu, mCurrentEnergy:%f, mCurrentFrames:%zu",
@@ -88,28 +300,40 @@ void PowerLog::log(const void *buffer, size_t frames, int64_t nowNs)
         // zero terminated. Consecutive zeroes are ignored.
         if (mCurrentEnergy == 0.f) {
             if (mConsecutiveZeroes++ == 0) {
-                mEntries[mIdx++] = std::make_pair(nowNs, 0.f);
+                append(nowNs, 0.f, nullptr /*details*/);
                 // zero terminate the signal sequence.
             }
         } else {
             mConsecutiveZeroes = 0;
-            mEntries[mIdx++] = std::make_pair(mCurrentTime, mCurrentEnergy);
+            if (mBands > 0) {
+                // Split the energy of the bin between the bands, according to their mean
+                // shares over the windows which ended in the bin, if any, else the last ones.
+                float *bands = mCurrentDetails.data() + (mPerChannel ? mChannelCount : 0);
+                float total = 0.f;
+                for (uint32_t b = 0; b < mBands; ++b) {
+                    total += bands[b];
+                }
+                for (uint32_t b = 0; b < mBands; ++b) {
+                    bands[b] = mCurrentEnergy
+                            * (total > 0.f ? bands[b] / total : mLastBandShares[b]);
+                }
+            }
+            append(mCurrentTime, mCurrentEnergy, mCurrentDetails.data());
             ALOGV("writing %lld %f", (long long)mCurrentTime, mCurrentEnergy);
         }
-        if (mIdx >= mEntries.size()) {
-            mIdx -= mEntries.size();
-        }
         mCurrentTime = 0;
         mCurrentEnergy = 0;
         mCurrentFrames = 0;
+        std::fill(mCurrentDetails.begin(), mCurrentDetails.end(), 0.f);
         frames -= process;
-        buffer = (const uint8_t *)buffer + mCurrentFrames * mChannelCount * bytes_per_sample;
+        buffer = (const uint8_t *)buffer + process * mChannelCount * bytes_per_sample;
     }
 }
 
 std::string PowerLog::dumpToString(const char *prefix, size_t lines, int64_t limitNs) const
 {
     std::lock_guard<std::mutex> guard(mLock);
+    drain();
 
     const size_t maxColumns = 10;
     const size_t numberOfEntries = mEntries.size();
@@ -241,6 +465,104 @@ status_t PowerLog::dump(int fd, const char *prefix, size_t lines, int64_t limitN
     return NO_ERROR;
 }
 
+namespace {
+
+void appendVarint(std::vector<uint8_t> *out, uint64_t value)
+{
+    for (; value >= 0x80; value >>= 7) {
+        out->push_back((uint8_t) (value | 0x80));
+    }
+    out->push_back((uint8_t) value);
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+// Power of an energy in units of 0.1 dB, as in the text dump.
+int32_t quantizePower(float energy)
+{
+    if (!(energy > 0.f)) {
+        return PowerLog::kBinaryMinPower;
+    }
+    return std::max((int32_t) lroundf(10.f * audio_utils_power_from_energy(energy)),
+            PowerLog::kBinaryMinPower);
+}
+
+} // namespace
+
+std::vector<uint8_t> PowerLog::dumpToBinary(int64_t limitNs) const
+{
+    std::lock_guard<std::mutex> guard(mLock);
+    drain();
+
+    // Skip the bins before limitNs, and the zeroes which would lead the remaining bins.
+    const size_t numberOfEntries = mEntries.size();
+    const size_t oldest = mIdx >= mEntryCount
+            ? mIdx - mEntryCount : mIdx + numberOfEntries - mEntryCount;
+    size_t first = 0;
+    for (; first < mEntryCount; ++first) {
+        const auto &entry = mEntries[(oldest + first) % numberOfEntries];
+        if (entry.second != 0.f && entry.first >= limitNs) {
+            break;
+        }
+    }
+
+    std::vector<uint8_t> out = {'P', 'W', 'R', kBinaryVersion};
+    appendVarint(&out, mSampleRate);
+    appendVarint(&out, mChannelCount);
+    appendVarint(&out, mFramesPerEntry);
+    appendVarint(&out, mPerChannel);
+    appendVarint(&out, mBands);
+    appendVarint(&out, mEntryCount - first);
+
+    const int64_t binNs = mSampleRate == 0
+            ? 0 : (int64_t) mFramesPerEntry * NANOS_PER_SECOND / mSampleRate;
+    const size_t channelDetails = mPerChannel ? mChannelCount : 0;
+    int64_t time = 0;
+    int32_t power = 0;
+    std::vector<int32_t> detailPowers(mDetailCount);
+    for (size_t i = first; i < mEntryCount; ++i) {
+        const size_t idx = (oldest + i) % numberOfEntries;
+        const float energy = mEntries[idx].second;
+        if (energy == 0.f) {
+            out.push_back(0);
+            continue;
+        }
+        const int32_t entryPower = quantizePower(energy / (mChannelCount * mFramesPerEntry));
+        // Track the decoded time rather than the actual one, so that errors do not accumulate.
+        const int64_t predicted = time + binNs;
+        const int64_t residualMs =
+                llround((double) (mEntries[idx].first - predicted) / NANOS_PER_MILLISECOND);
+        time = predicted + residualMs * NANOS_PER_MILLISECOND;
+        appendVarint(&out, 1 + (zigzag(entryPower - power) << 1 | (residualMs != 0)));
+        if (residualMs != 0) {
+            appendVarint(&out, zigzag(residualMs));
+        }
+        power = entryPower;
+
+        const float *details = mDetails.data() + idx * mDetailCount;
+        for (size_t d = 0; d < mDetailCount; ++d) {
+            const size_t samples = d < channelDetails
+                    ? mFramesPerEntry : mChannelCount * mFramesPerEntry;
+            const int32_t detailPower = quantizePower(details[d] / samples);
+            appendVarint(&out, zigzag(detailPower - detailPowers[d]));
+            detailPowers[d] = detailPower;
+        }
+    }
+    return out;
+}
+
+status_t PowerLog::dumpBinary(int fd, int64_t limitNs) const
+{
+    const std::vector<uint8_t> out = dumpToBinary(limitNs);
+    if (write(fd, out.data(), out.size()) < 0) {
+        return -errno;
+    }
+    return NO_ERROR;
+}
+
 } // namespace android
 
 using namespace android;
@@ -0,0 +1,338 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// #define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_SimpleLog"
+
+#include <audio_utils/SimpleLog.h>
+
+#include "private/fifo_torn.h"
+
+namespace android {
+
+void SimpleLog::parseSpec(const char *format, RtSpec *spec)
+{
+    spec->mStart = format++;
+    spec->mStars = 0;
+    spec->mPrecision = -1;
+    while (*format != '\0' && strchr("-+ #0'", *format) != nullptr) {
+        ++format;
+    }
+    if (*format == '*') {
+        ++spec->mStars;
+        ++format;
+    }
+    while (*format >= '0' && *format <= '9') {
+        ++format;
+    }
+    if (*format == '.') {
+        ++format;
+        if (*format == '*') {
+            ++spec->mStars;
+            ++format;
+        } else {
+            spec->mPrecision = 0;
+            while (*format >= '0' && *format <= '9') {
+                spec->mPrecision = spec->mPrecision * 10 + (*format++ - '0');
+            }
+        }
+    }
+    spec->mLength = format;
+    spec->mLengthModifier = 0;
+    if (format[0] == 'h' && format[1] == 'h') {
+        spec->mLengthModifier = 'H';
+        format += 2;
+    } else if (format[0] == 'l' && format[1] == 'l') {
+        spec->mLengthModifier = 'q';
+        format += 2;
+    } else if (*format != '\0' && strchr("hlqjztL", *format) != nullptr) {
+        spec->mLengthModifier = *format++;
+    }
+    spec->mConversion = *format;
+    if (*format != '\0') {
+        ++format;
+    }
+    spec->mEnd = format;
+
+    switch (spec->mConversion) {
+    case '%':
+        spec->mKind = RT_KIND_NONE;
+        break;
+    case 'd': case 'i': case 'c':
+        spec->mKind = RT_KIND_SIGNED;
+        break;
+    case 'u': case 'o': case 'x': case 'X':
+        spec->mKind = RT_KIND_UNSIGNED;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec->mKind = RT_KIND_DOUBLE;
+        break;
+    case 's':
+        spec->mKind = spec->mLengthModifier == 0 ? RT_KIND_STRING : RT_KIND_UNSUPPORTED;
+        break;
+    case 'p':
+        spec->mKind = RT_KIND_POINTER;
+        break;
+    case 'n':
+        spec->mKind = RT_KIND_COUNT;
+        break;
+    default:
+        spec->mKind = RT_KIND_UNSUPPORTED;
+        break;
+    }
+    if (spec->mConversion == 'c' && spec->mLengthModifier != 0) {
+        spec->mKind = RT_KIND_UNSUPPORTED;
+    }
+    if (spec->mEnd - spec->mStart >= (ptrdiff_t) kMaxSpecLength - 2) {
+        spec->mKind = RT_KIND_UNSUPPORTED;
+    }
+}
+
+int64_t SimpleLog::readSigned(char lengthModifier, va_list *args)
+{
+    switch (lengthModifier) {
+    case 'H': return (signed char) va_arg(*args, int);
+    case 'h': return (short) va_arg(*args, int);
+    case 'l': return va_arg(*args, long);
+    case 'q': return va_arg(*args, long long);
+    case 'j': return va_arg(*args, intmax_t);
+    case 'z': return va_arg(*args, ssize_t);
+    case 't': return va_arg(*args, ptrdiff_t);
+    default: return va_arg(*args, int);
+    }
+}
+
+uint64_t SimpleLog::readUnsigned(char lengthModifier, va_list *args)
+{
+    switch (lengthModifier) {
+    case 'H': return (unsigned char) va_arg(*args, unsigned);
+    case 'h': return (unsigned short) va_arg(*args, unsigned);
+    case 'l': return va_arg(*args, unsigned long);
+    case 'q': return va_arg(*args, unsigned long long);
+    case 'j': return va_arg(*args, uintmax_t);
+    case 'z': return va_arg(*args, size_t);
+    case 't': return (uint64_t) va_arg(*args, ptrdiff_t);
+    default: return va_arg(*args, unsigned);
+    }
+}
+
+uint32_t SimpleLog::copyString(RtEntry *entry, const char *s, size_t maxLength)
+{
+    if (entry->mStringBytes == kRtStringBytes) {
+        // The last byte of a full mStrings terminates the last string copied,
+        // so it serves as an empty string.
+        return kRtStringBytes - 1;
+    }
+    const uint32_t offset = entry->mStringBytes;
+    const size_t length = strnlen(s, std::min(maxLength, kRtStringBytes - 1 - offset));
+    memcpy(entry->mStrings + offset, s, length);
+    entry->mStrings[offset + length] = '\0';
+    entry->mStringBytes += length + 1;
+    return offset;
+}
+
+void SimpleLog::logRt(int64_t nowNs, const char *format, va_list args)
+{
+    RtEntry entry;
+    entry.mTime = nowNs == -1 ? audio_utils_get_real_time_ns() : nowNs;
+    entry.mFormat = format;
+    entry.mArgCount = 0;
+    entry.mStringBytes = 0;
+    // A copy, as the helpers reading the arguments need a pointer to the va_list.
+    va_list ap;
+    va_copy(ap, args);
+    for (const char *p = strchr(format, '%'); p != nullptr; ) {
+        RtSpec spec;
+        parseSpec(p, &spec);
+        if (spec.mKind == RT_KIND_UNSUPPORTED
+                || entry.mArgCount + spec.mStars + (spec.mKind != RT_KIND_NONE) > kRtMaxArgs) {
+            break;
+        }
+        for (uint32_t i = 0; i < spec.mStars; ++i) {
+            entry.mArgs[entry.mArgCount++].mSigned = va_arg(ap, int);
+        }
+        // A '*' precision is the last of the stars.
+        if (spec.mStars > 0 && spec.mPrecision == -1 && spec.mLength[-1] == '*'
+                && spec.mLength[-2] == '.') {
+            spec.mPrecision = (int) entry.mArgs[entry.mArgCount - 1].mSigned;
+        }
+        switch (spec.mKind) {
+        case RT_KIND_SIGNED:
+            entry.mArgs[entry.mArgCount++].mSigned = readSigned(spec.mLengthModifier, &ap);
+            break;
+        case RT_KIND_UNSIGNED:
+            entry.mArgs[entry.mArgCount++].mUnsigned =
+                    readUnsigned(spec.mLengthModifier, &ap);
+            break;
+        case RT_KIND_DOUBLE:
+            entry.mArgs[entry.mArgCount++].mDouble = spec.mLengthModifier == 'L'
+                    ? (double) va_arg(ap, long double) : va_arg(ap, double);
+            break;
+        case RT_KIND_STRING: {
+            const char *s = va_arg(ap, const char *);
+            entry.mArgs[entry.mArgCount++].mStringOffset = copyString(&entry,
+                    s != nullptr ? s : "(null)",
+                    spec.mPrecision >= 0 ? (size_t) spec.mPrecision : SIZE_MAX);
+        } break;
+        case RT_KIND_POINTER:
+        case RT_KIND_COUNT:
+            entry.mArgs[entry.mArgCount++].mPointer = va_arg(ap, const void *);
+            break;
+        default:
+            break;
+        }
+        p = strchr(spec.mEnd, '%');
+    }
+    va_end(ap);
+    // Never blocks, as the reader does not throttle the writer.
+    (void)mRingWriter->write(&entry, 1 /*count*/);
+}
+
+void SimpleLog::logRtString(int64_t nowNs, const char *s)
+{
+    RtEntry entry;
+    entry.mTime = nowNs == -1 ? audio_utils_get_real_time_ns() : nowNs;
+    entry.mFormat = "%s";
+    entry.mArgCount = 1;
+    entry.mStringBytes = 0;
+    entry.mArgs[0].mStringOffset = copyString(&entry, s, SIZE_MAX);
+    (void)mRingWriter->write(&entry, 1 /*count*/);
+}
+
+template <typename T>
+void SimpleLog::formatArg(std::string *out, const char *spec, uint32_t stars,
+        const int *starArgs, T value)
+{
+    char buffer[kMaxStringLength];
+    int length;
+    switch (stars) {
+    case 0:
+        length = snprintf(buffer, sizeof(buffer), spec, value);
+        break;
+    case 1:
+        length = snprintf(buffer, sizeof(buffer), spec, starArgs[0], value);
+        break;
+    default:
+        length = snprintf(buffer, sizeof(buffer), spec, starArgs[0], starArgs[1], value);
+        break;
+    }
+    if (length > 0) {
+        out->append(buffer, std::min((size_t) length, sizeof(buffer) - 1));
+    }
+}
+
+std::string SimpleLog::formatRt(const RtEntry &entry)
+{
+    std::string out;
+    const char *format = entry.mFormat;
+    uint32_t arg = 0;
+    for (const char *p = strchr(format, '%'); ; p = strchr(format, '%')) {
+        if (p == nullptr) {
+            out.append(format);
+            break;
+        }
+        out.append(format, p - format);
+        RtSpec spec;
+        parseSpec(p, &spec);
+        if (spec.mKind == RT_KIND_UNSUPPORTED
+                || arg + spec.mStars + (spec.mKind != RT_KIND_NONE) > entry.mArgCount) {
+            break;
+        }
+        format = spec.mEnd;
+        int starArgs[2];
+        for (uint32_t i = 0; i < spec.mStars; ++i) {
+            starArgs[i] = (int) entry.mArgs[arg++].mSigned;
+        }
+
+        // The specification without its length modifier, then that of the stored type.
+        char s[kMaxSpecLength];
+        size_t length = spec.mLength - spec.mStart;
+        memcpy(s, spec.mStart, length);
+        if (spec.mKind == RT_KIND_SIGNED && spec.mConversion != 'c') {
+            s[length++] = 'l';
+            s[length++] = 'l';
+        } else if (spec.mKind == RT_KIND_UNSIGNED) {
+            s[length++] = 'l';
+            s[length++] = 'l';
+        }
+        s[length++] = spec.mConversion;
+        s[length] = '\0';
+
+        switch (spec.mKind) {
+        case RT_KIND_NONE:
+            out.push_back('%');
+            break;
+        case RT_KIND_SIGNED:
+            if (spec.mConversion == 'c') {
+                formatArg(&out, s, spec.mStars, starArgs, (int) entry.mArgs[arg++].mSigned);
+            } else {
+                formatArg(&out, s, spec.mStars, starArgs,
+                        (long long) entry.mArgs[arg++].mSigned);
+            }
+            break;
+        case RT_KIND_UNSIGNED:
+            formatArg(&out, s, spec.mStars, starArgs,
+                    (unsigned long long) entry.mArgs[arg++].mUnsigned);
+            break;
+        case RT_KIND_DOUBLE:
+            formatArg(&out, s, spec.mStars, starArgs, entry.mArgs[arg++].mDouble);
+            break;
+        case RT_KIND_STRING:
+            formatArg(&out, s, spec.mStars, starArgs,
+                    entry.mStrings + entry.mArgs[arg++].mStringOffset);
+            break;
+        case RT_KIND_POINTER:
+            formatArg(&out, s, spec.mStars, starArgs, entry.mArgs[arg++].mPointer);
+            break;
+        default: // RT_KIND_COUNT
+            ++arg;
+            break;
+        }
+    }
+
+    // as logv()
+    if (out.size() >= kMaxStringLength) {
+        out.resize(kMaxStringLength - 1);
+    }
+    while (!out.empty() && out.back() == '\n') {
+        out.pop_back();
+    }
+    return out;
+}
+
+void SimpleLog::drainLocked() const
+{
+    if (!mRealTime) {
+        return;
+    }
+    for (;;) {
+        const ssize_t actual = mRingReader->read(mDrainEntries.get(), kDrainEntries,
+                NULL /*timeout*/);
+        if (actual == -EOVERFLOW) {
+            // The reader has caught up for the next read.
+            continue;
+        }
+        if (actual <= 0) {
+            break;
+        }
+        const size_t torn = fifoTornFrames(*mRingReader, actual);
+        for (size_t i = torn; i < (size_t) actual; ++i) {
+            appendLocked(mDrainEntries[i].mTime, formatRt(mDrainEntries[i]));
+        }
+    }
+}
+
+} // namespace android
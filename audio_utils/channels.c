@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <audio_utils/channels.h>
+#include "private/primitives_backend.h"
 #include "private/private.h"
 
 /*
@@ -345,7 +346,7 @@ static inline uint8x3_t int32_to_uint8x3(int32_t in) {
     for (src_index = 0; src_index < num_in_samples; src_index += in_buff_chans) { \
         temp = uint8x3_to_int32(*src_ptr++); \
         temp += uint8x3_to_int32(*src_ptr++); \
-        *dst_ptr = int32_to_uint8x3(temp >> 1); \
+        *dst_ptr++ = int32_to_uint8x3(temp >> 1); \
         src_ptr += num_skip_samples; \
     } \
     /* return number of *bytes* generated */ \
@@ -659,10 +660,38 @@ static size_t expand_channels_non_destructive(const void* in_buff, size_t in_buf
     }
 }
 
+/*
+ * Convert a buffer of N-channel, interleaved samples to M-channel with the vector kernels
+ * of the active primitives backend, which cover common channel counts (1 and 2, 2 and 4,
+ * 2 and 6, 2 and 8) and are bit exact with expand_channels() and contract_channels().
+ * returns
+ *   the number of BYTES of output data, or 0 if there is no vector kernel.
+ */
+static size_t adjust_channels_vector(const void* in_buff, size_t in_buff_chans,
+                                     void* out_buff, size_t out_buff_chans,
+                                     unsigned sample_size_in_bytes, size_t num_in_bytes)
+{
+    const primitives_table_t *table = primitives_get_table();
+    if (table->adjust_channels == NULL || in_buff_chans == 0 || sample_size_in_bytes == 0) {
+        return 0;
+    }
+    const size_t num_frames = num_in_bytes / (in_buff_chans * sample_size_in_bytes);
+    if (table->adjust_channels(out_buff, in_buff, in_buff_chans, out_buff_chans,
+            sample_size_in_bytes, num_frames) != 0) {
+        return 0;
+    }
+    return num_frames * out_buff_chans * sample_size_in_bytes;
+}
+
 size_t adjust_channels(const void* in_buff, size_t in_buff_chans,
                        void* out_buff, size_t out_buff_chans,
                        unsigned sample_size_in_bytes, size_t num_in_bytes)
 {
+    const size_t num_out_bytes = adjust_channels_vector(in_buff, in_buff_chans,
+            out_buff, out_buff_chans, sample_size_in_bytes, num_in_bytes);
+    if (num_out_bytes != 0) {
+        return num_out_bytes;
+    }
     if (out_buff_chans > in_buff_chans) {
         return expand_channels(in_buff, in_buff_chans, out_buff,  out_buff_chans,
                                sample_size_in_bytes, num_in_bytes);
@@ -0,0 +1,679 @@
+/*
+** Copyright 2011, The Android Open-Source Project
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "echo_reference"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <log/log.h>
+#include <system/audio.h>
+#include <audio_utils/clock.h>
+#include <audio_utils/fifo.h>
+#include <audio_utils/primitives.h>
+#include <audio_utils/resampler.h>
+#include <audio_utils/roundup.h>
+#include <audio_utils/Statistics.h>
+#include <audio_utils/echo_reference.h>
+
+// The writer and the reader of the echo reference run on the playback and capture threads,
+// and share no lock: write() pushes the frames as written and their render time into fifos,
+// and read() drains them, converts and resamples the frames to the read format on the capture
+// thread, and aligns them with the capture time of the frames read.
+// With the drift compensation, the reader also fits the frames written and read against their
+// time stamps, and trims the ratio of the resampler by the drift of the clocks.
+
+namespace {
+
+// The duration of the frames fifo, which bounds the playback and capture delays.
+constexpr uint32_t kFifoMs = 500;
+// The render times kept in the render time fifo, of the most recent writes: as many as the
+// writes of 1 ms or more held by the frames fifo, so that it overflows only with the frames fifo.
+constexpr uint32_t kRenderTimeCount = 512;
+// The frames drained from the frames fifo at once.
+constexpr size_t kChunkFrames = 256;
+
+// delay jump threshold to update ref buffer: 6 samples at 8kHz in nsecs
+constexpr int64_t kMinDelayDeltaNs = 375000 * 2;
+// number of consecutive delta with same sign between expected and actual delay before adjusting
+// the buffer
+constexpr uint16_t kMinDeltaNum = 4;
+
+// The weight of the previous time stamps in the clock fits, about 10 s of 10 ms periods.
+constexpr double kClockFitAlpha = 0.999;
+// The time stamps fitted before estimating the rate of a clock.
+constexpr int64_t kMinClockFitCount = 8;
+// The time over which the trim of the resampler corrects a deviation of the alignment.
+constexpr int64_t kDriftCorrectionNs = 5000000000;
+
+// The render time of the first frame of a write.
+struct RenderTime {
+    int64_t mPosition;      // of the frame in the frames written
+    int64_t mRenderNs;      // on the clock of the time stamps
+};
+
+// Estimates the rate of a clock from the positions of its frames at time stamps.
+class ClockRateEstimator {
+public:
+    ClockRateEstimator() : mFit(kClockFitAlpha) { }
+
+    void reset() {
+        mFit.reset();
+    }
+
+    void add(int64_t position, int64_t timeNs) {
+        // Relative to the first, so that the fit keeps its precision.
+        if (mFit.getN() == 0) {
+            mBasePosition = position;
+            mBaseNs = timeNs;
+        }
+        mFit.add({(timeNs - mBaseNs) * 1e-9, (double) (position - mBasePosition)});
+    }
+
+    // Returns the rate in frames per second, or 0 if not yet estimated.
+    double getRate() const {
+        if (mFit.getN() < kMinClockFitCount) {
+            return 0.;
+        }
+        double a, b, r2;
+        mFit.computeYLine(a, b, r2);
+        return b;
+    }
+
+private:
+    android::audio_utils::LinearLeastSquaresFit<double> mFit;
+    int64_t mBasePosition = 0;
+    int64_t mBaseNs = 0;
+};
+
+class EchoReference : public echo_reference_itfe {
+public:
+    EchoReference(uint32_t rdChannelCount, uint32_t rdSamplingRate,
+            uint32_t wrChannelCount, uint32_t wrSamplingRate);
+    ~EchoReference();
+
+    int init();
+    int writeBuffer(echo_reference_buffer *buffer);
+    int readBuffer(echo_reference_buffer *buffer);
+    int setDriftCompensation(bool enabled);
+    float getDriftPpm() const {
+        return mDriftPpm.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Called by the reader only.
+
+    // Discards the frames converted, and restarts the alignment.
+    void reset();
+    // Converts the frames written into mBuffer, returning false if frames were lost.
+    bool drain();
+    // Appends frames in the read format to mBuffer, after those to skip.
+    void append(const int16_t *frames, size_t frameCount);
+    // Aligns mBuffer with the capture time of the frames read.
+    void align(const echo_reference_buffer *buffer);
+    // Trims the resampler by the drift of the clocks, and the deviation of the alignment.
+    void trim(int64_t deltaNs);
+
+    const uint32_t mRdChannelCount;
+    const uint32_t mRdSamplingRate;
+    const uint32_t mWrChannelCount;
+    const uint32_t mWrSamplingRate;
+
+    // The frames written, and their render times.
+    std::unique_ptr<int16_t[]> mFramesBuffer;
+    std::unique_ptr<audio_utils_fifo> mFrames;
+    std::unique_ptr<audio_utils_fifo_writer> mFramesWriter;
+    std::unique_ptr<audio_utils_fifo_reader> mFramesReader;
+    RenderTime mRenderTimesBuffer[kRenderTimeCount];
+    std::unique_ptr<audio_utils_fifo> mRenderTimes;
+    std::unique_ptr<audio_utils_fifo_writer> mRenderTimesWriter;
+    std::unique_ptr<audio_utils_fifo_reader> mRenderTimesReader;
+
+    std::atomic<bool> mReading;                 // set by the reader
+    std::atomic<bool> mWriting;                 // set by the writer
+    std::atomic<uint32_t> mWriteGeneration;     // incremented by the writer at each start
+    std::atomic<float> mDriftPpm;               // set by the reader
+
+    // Accessed by the writer only.
+    bool mHasTimeStamp;                         // a write had a valid time stamp
+
+    // Accessed by the reader only.
+    uint32_t mReadGeneration;                   // the write generation of mBuffer
+    struct resampler_itfe *mResampler;          // from the write to the read sampling rate
+    std::vector<int16_t> mScratch;              // frames downmixed to the read channel count
+    std::vector<int16_t> mBuffer;               // frames converted to the read format
+    size_t mBufferFrames;                       // number of frames in mBuffer
+    size_t mSkipFrames;                         // frames to discard before appending to mBuffer
+    RenderTime mRenderTime;                     // of the most recent write
+    bool mHasRenderTime;                        // mRenderTime is valid
+    bool mAligned;                              // mBuffer was aligned since reset()
+    int16_t mPrevDeltaSign;                     // sign of previous delay difference:
+                                                //  1: positive, -1: negative, 0: unknown
+    uint16_t mDeltaCount;                       // number of consecutive delay differences
+                                                // with same sign
+    bool mDriftCompensation;                    // the resampler is trimmed by the drift
+    ClockRateEstimator mWriteRate;              // of the frames written, from the render times
+    ClockRateEstimator mReadRate;               // of the frames read, from the capture times
+    int64_t mFramesRead;                        // since reset()
+};
+
+EchoReference::EchoReference(uint32_t rdChannelCount, uint32_t rdSamplingRate,
+        uint32_t wrChannelCount, uint32_t wrSamplingRate)
+    : mRdChannelCount(rdChannelCount)
+    , mRdSamplingRate(rdSamplingRate)
+    , mWrChannelCount(wrChannelCount)
+    , mWrSamplingRate(wrSamplingRate)
+    , mReading(false)
+    , mWriting(false)
+    , mWriteGeneration(0)
+    , mDriftPpm(0.f)
+    , mHasTimeStamp(false)
+    , mReadGeneration(0)
+    , mResampler(NULL)
+    , mBufferFrames(0)
+    , mSkipFrames(0)
+    , mRenderTime{}
+    , mHasRenderTime(false)
+    , mAligned(false)
+    , mPrevDeltaSign(0)
+    , mDeltaCount(0)
+    , mDriftCompensation(false)
+    , mFramesRead(0)
+{
+    // The reader does not throttle the writer, which overwrites the frames of a late reader.
+    // A power of 2 keeps the frames lost, and so the position of the reader, exact.
+    const uint32_t frameCount = roundup((uint32_t) ((uint64_t) wrSamplingRate * kFifoMs / 1000));
+    mFramesBuffer.reset(new int16_t[frameCount * wrChannelCount]);
+    mFrames.reset(new audio_utils_fifo(frameCount, wrChannelCount * sizeof(int16_t),
+            mFramesBuffer.get(), false /*throttlesWriter*/));
+    mFramesWriter.reset(new audio_utils_fifo_writer(*mFrames));
+    mFramesReader.reset(new audio_utils_fifo_reader(*mFrames, false /*throttlesWriter*/));
+    mRenderTimes.reset(new audio_utils_fifo(kRenderTimeCount, sizeof(RenderTime),
+            mRenderTimesBuffer, false /*throttlesWriter*/));
+    mRenderTimesWriter.reset(new audio_utils_fifo_writer(*mRenderTimes));
+    // On overflow, the reader keeps the most recent render times rather than flushing them all.
+    mRenderTimesReader.reset(new audio_utils_fifo_reader(*mRenderTimes,
+            false /*throttlesWriter*/, false /*flush*/));
+
+    // mBuffer holds as many frames as the fifo, and a resampled chunk.
+    mScratch.resize(kChunkFrames * rdChannelCount);
+    mBuffer.resize(((size_t) frameCount * rdSamplingRate / wrSamplingRate + kChunkFrames * 2)
+            * rdChannelCount);
+}
+
+EchoReference::~EchoReference()
+{
+    release_resampler(mResampler);
+}
+
+int EchoReference::init()
+{
+    if (mRdSamplingRate != mWrSamplingRate) {
+        ALOGV("init() new ReSampler(%d, %d)", mWrSamplingRate, mRdSamplingRate);
+        // The polyphase resampler, as its ratio is trimmed without a discontinuity
+        // when the drift is compensated.
+        int rc = create_polyphase_resampler(mWrSamplingRate, mRdSamplingRate, mRdChannelCount,
+                RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &mResampler);
+        if (rc != 0) {
+            ALOGW("init() failure to create resampler %d", rc);
+            return -ENODEV;
+        }
+    }
+    return 0;
+}
+
+int EchoReference::writeBuffer(echo_reference_buffer *buffer)
+{
+    if (buffer == NULL) {
+        ALOGV("echo_reference_write() stop write");
+        mWriting.store(false, std::memory_order_release);
+        mHasTimeStamp = false;
+        return 0;
+    }
+
+    ALOGV("echo_reference_write() START trying to write %zu frames", buffer->frame_count);
+
+    // discard writes until a valid time stamp is provided.
+    const bool hasTimeStamp = buffer->time_stamp.tv_sec != 0 || buffer->time_stamp.tv_nsec != 0;
+    if (!hasTimeStamp && !mHasTimeStamp) {
+        return 0;
+    }
+    mHasTimeStamp = true;
+
+    if (!mWriting.load(std::memory_order_relaxed)) {
+        ALOGV("echo_reference_write() start write");
+        mWriteGeneration.fetch_add(1, std::memory_order_relaxed);
+        mWriting.store(true, std::memory_order_release);
+    }
+
+    if (!mReading.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    const int64_t position = mFramesWriter->totalReleased();
+    const int16_t *src = (const int16_t *) buffer->raw;
+    for (size_t frames = buffer->frame_count; frames > 0; ) {
+        const ssize_t written = mFramesWriter->write(src, frames);
+        if (written <= 0) {
+            break;
+        }
+        src += written * mWrChannelCount;
+        frames -= written;
+    }
+    if (hasTimeStamp) {
+        const RenderTime renderTime = {position,
+                audio_utils_ns_from_timespec(&buffer->time_stamp) + buffer->delay_ns};
+        mRenderTimesWriter->write(&renderTime, 1);
+    }
+    ALOGV("echo_reference_write() END frames written:[%zu], playback delay:[%" PRId32 "]",
+            buffer->frame_count, buffer->delay_ns);
+    return 0;
+}
+
+void EchoReference::reset()
+{
+    ALOGV("echo_reference reset()");
+    mBufferFrames = 0;
+    mSkipFrames = 0;
+    mAligned = false;
+    mDeltaCount = 0;
+    mPrevDeltaSign = 0;
+    mWriteRate.reset();
+    mReadRate.reset();
+    mFramesRead = 0;
+    if (mResampler != NULL) {
+        mResampler->reset(mResampler);
+        if (mDriftCompensation) {
+            mResampler->set_input_drift_ppm(mResampler, 0.f);
+        }
+    }
+}
+
+int EchoReference::setDriftCompensation(bool enabled)
+{
+    if (enabled && mResampler == NULL) {
+        // The drift is compensated by the resampler, even at the same sampling rates.
+        int rc = create_polyphase_resampler(mWrSamplingRate, mRdSamplingRate, mRdChannelCount,
+                RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &mResampler);
+        if (rc != 0) {
+            ALOGW("setDriftCompensation() failure to create resampler %d", rc);
+            return -ENODEV;
+        }
+    }
+    if (!enabled && mResampler != NULL && mWrSamplingRate == mRdSamplingRate) {
+        // Without drift compensation the frames are copied; the frames held by the resampler
+        // are lost, so the alignment restarts.
+        release_resampler(mResampler);
+        mResampler = NULL;
+        reset();
+    } else if (mResampler != NULL) {
+        int rc = mResampler->set_input_drift_ppm(mResampler, 0.f);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    mDriftCompensation = enabled;
+    mDriftPpm.store(0.f, std::memory_order_relaxed);
+    return 0;
+}
+
+void EchoReference::trim(int64_t deltaNs)
+{
+    const double writeRate = mWriteRate.getRate();
+    const double readRate = mReadRate.getRate();
+    double driftPpm = 0.;
+    if (writeRate > 0. && readRate > 0.) {
+        driftPpm = ((writeRate / mWrSamplingRate) / (readRate / mRdSamplingRate) - 1.) * 1e6;
+        mDriftPpm.store(driftPpm, std::memory_order_relaxed);
+    }
+    // A reference rendered after the capture is ahead of it, so must be consumed slower,
+    // as for a slower writer, and one rendered before it faster.
+    const double correctionPpm = -1e6 * deltaNs / kDriftCorrectionNs;
+    const double trimPpm = std::max(-(double) RESAMPLER_MAX_DRIFT_PPM,
+            std::min((double) RESAMPLER_MAX_DRIFT_PPM, driftPpm + correctionPpm));
+    ALOGV("echo_reference trim(): drift %f ppm, correction %f ppm", driftPpm, correctionPpm);
+    mResampler->set_input_drift_ppm(mResampler, trimPpm);
+}
+
+void EchoReference::append(const int16_t *frames, size_t frameCount)
+{
+    const size_t skip = std::min(mSkipFrames, frameCount);
+    mSkipFrames -= skip;
+    frames += skip * mRdChannelCount;
+    frameCount -= skip;
+
+    // Discards the oldest frames if mBuffer is full, as for a lost write.
+    const size_t capacity = mBuffer.size() / mRdChannelCount;
+    if (frameCount > capacity - mBufferFrames) {
+        const size_t discard = std::min(mBufferFrames, frameCount - (capacity - mBufferFrames));
+        memmove(mBuffer.data(), &mBuffer[discard * mRdChannelCount],
+                (mBufferFrames - discard) * mRdChannelCount * sizeof(int16_t));
+        mBufferFrames -= discard;
+        frameCount = std::min(frameCount, capacity - mBufferFrames);
+    }
+    memcpy(&mBuffer[mBufferFrames * mRdChannelCount], frames,
+            frameCount * mRdChannelCount * sizeof(int16_t));
+    mBufferFrames += frameCount;
+}
+
+bool EchoReference::drain()
+{
+    RenderTime renderTime;
+    for (;;) {
+        const ssize_t count = mRenderTimesReader->read(&renderTime, 1);
+        if (count == -EOVERFLOW) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        mRenderTime = renderTime;
+        mHasRenderTime = true;
+        if (mDriftCompensation) {
+            mWriteRate.add(renderTime.mPosition, renderTime.mRenderNs);
+        }
+    }
+
+    for (;;) {
+        audio_utils_iovec iovec[2];
+        size_t lost;
+        const ssize_t count = mFramesReader->obtain(iovec, kChunkFrames, NULL /*timeout*/, &lost);
+        if (count == -EOVERFLOW) {
+            ALOGV("echo_reference drain() lost %zu frames", lost);
+            return false;
+        }
+        if (count <= 0) {
+            return true;
+        }
+        for (const audio_utils_iovec &part : iovec) {
+            if (part.mLength == 0) {
+                continue;
+            }
+            int16_t *src = &mFramesBuffer[part.mOffset * mWrChannelCount];
+            if (mRdChannelCount != mWrChannelCount) {
+                // must be stereo to mono
+                downmix_to_mono_i16_from_stereo_i16(mScratch.data(), src, part.mLength);
+                src = mScratch.data();
+            }
+            if (mResampler == NULL) {
+                append(src, part.mLength);
+                continue;
+            }
+            int16_t out[kChunkFrames * 2];
+            const size_t outCapacity = sizeof(out) / sizeof(out[0]) / mRdChannelCount;
+            for (size_t frames = part.mLength; frames > 0; ) {
+                size_t inFrames = frames;
+                size_t outFrames = outCapacity;
+                mResampler->resample_from_input(mResampler, src, &inFrames, out, &outFrames);
+                append(out, outFrames);
+                src += inFrames * mRdChannelCount;
+                frames -= inFrames;
+            }
+        }
+        mFramesReader->release(count);
+    }
+}
+
+void EchoReference::align(const echo_reference_buffer *buffer)
+{
+    // The position of the first frame of mBuffer in the frames written, at the write rate,
+    // behind the frames drained by those buffered in the resampler and in mBuffer.
+    double position = (double) mFramesReader->totalReleased()
+            - (double) mBufferFrames * mWrSamplingRate / mRdSamplingRate;
+    if (mResampler != NULL) {
+        position -= 1e-9 * mResampler->delay_ns(mResampler) * mWrSamplingRate;
+    }
+    const int64_t renderNs = mRenderTime.mRenderNs
+            + (int64_t) ((position - mRenderTime.mPosition) * 1e9 / mWrSamplingRate);
+    const int64_t captureNs = audio_utils_ns_from_timespec(&buffer->time_stamp)
+            - buffer->delay_ns;
+    const int64_t deltaNs = renderNs - captureNs;
+
+    ALOGV("echo_reference_read(): EchoPathDelayDeviation between reference and DMA [%"
+            PRId64 "]", deltaNs);
+    if (mDriftCompensation) {
+        mReadRate.add(mFramesRead, captureNs);
+        if (mAligned) {
+            trim(deltaNs);
+        }
+    }
+    if (mAligned) {
+        if (llabs(deltaNs) < kMinDelayDeltaNs) {
+            mDeltaCount = 0;
+            mPrevDeltaSign = 0;
+            return;
+        }
+        // smooth the variation and update the reference buffer only
+        // if a deviation in the same direction is observed for more than kMinDeltaNum
+        // consecutive reads.
+        const int16_t deltaSign = (deltaNs >= 0) ? 1 : -1;
+        if (deltaSign == mPrevDeltaSign) {
+            mDeltaCount++;
+        } else {
+            mDeltaCount = 1;
+        }
+        mPrevDeltaSign = deltaSign;
+        if (mDeltaCount <= kMinDeltaNum) {
+            return;
+        }
+    }
+    mAligned = true;
+    mDeltaCount = 0;
+    mPrevDeltaSign = 0;
+
+    const int64_t offset = llround(deltaNs * 1e-9 * mRdSamplingRate);
+    if (offset > 0) {
+        // The first frame buffered is rendered after the first frame captured:
+        // pushing ref buffer by zeros.
+        const size_t frames = std::min((size_t) offset,
+                mBuffer.size() / mRdChannelCount - mBufferFrames);
+        memmove(&mBuffer[frames * mRdChannelCount], mBuffer.data(),
+                mBufferFrames * mRdChannelCount * sizeof(int16_t));
+        memset(mBuffer.data(), 0, frames * mRdChannelCount * sizeof(int16_t));
+        mBufferFrames += frames;
+        ALOGV("echo_reference_read(): pushing ref buffer by [%zu]", frames);
+    } else if (offset < 0) {
+        // The first frame buffered is rendered before the first frame captured:
+        // shifting ref buffer, and skipping the frames not yet written.
+        const size_t frames = std::min((size_t) -offset, mBufferFrames);
+        memmove(mBuffer.data(), &mBuffer[frames * mRdChannelCount],
+                (mBufferFrames - frames) * mRdChannelCount * sizeof(int16_t));
+        mBufferFrames -= frames;
+        mSkipFrames = -offset - frames;
+        ALOGV("echo_reference_read(): shifting ref buffer by [%zu], skipping [%zu]",
+                frames, mSkipFrames);
+    }
+}
+
+int EchoReference::readBuffer(echo_reference_buffer *buffer)
+{
+    if (buffer == NULL) {
+        ALOGV("echo_reference_read() stop read");
+        mReading.store(false, std::memory_order_release);
+        return 0;
+    }
+
+    ALOGV("echo_reference_read() START, delayCapture:[%" PRId32 "], "
+            "frames buffered:[%zu], buffer->frame_count:[%zu]",
+            buffer->delay_ns, mBufferFrames, buffer->frame_count);
+
+    if (!mReading.load(std::memory_order_relaxed)) {
+        ALOGV("echo_reference_read() start read");
+        mFramesReader->flush();
+        mRenderTimesReader->flush();
+        mHasRenderTime = false;
+        reset();
+        mReading.store(true, std::memory_order_release);
+    }
+
+    const uint32_t generation = mWriteGeneration.load(std::memory_order_relaxed);
+    if (!mWriting.load(std::memory_order_acquire)) {
+        memset(buffer->raw, 0, buffer->frame_count * mRdChannelCount * sizeof(int16_t));
+        buffer->delay_ns = 0;
+        return 0;
+    }
+    if (generation != mReadGeneration) {
+        // The writer restarted: the frames written are no longer contiguous in time.
+        mReadGeneration = generation;
+        reset();
+    }
+
+    if (!drain()) {
+        reset();
+    }
+
+    // allow some time for new frames to arrive if not enough frames are ready for read
+    if (mBufferFrames < buffer->frame_count) {
+        const uint32_t timeoutMs =
+                (uint32_t) ((1000 * buffer->frame_count) / mRdSamplingRate / 2);
+        const struct timespec timeout = {(time_t) (timeoutMs / 1000),
+                (long) (timeoutMs % 1000) * 1000000};
+        audio_utils_iovec iovec[2];
+        if (mFramesReader->obtain(iovec, 1, &timeout) > 0 && !drain()) {
+            reset();
+        }
+        ALOGV_IF(mBufferFrames < buffer->frame_count,
+                "echo_reference_read() waited %u ms but still not enough frames"
+                " frames buffered: %zu, buffer->frame_count = %zu",
+                timeoutMs, mBufferFrames, buffer->frame_count);
+    }
+
+    if (mHasRenderTime &&
+            (buffer->time_stamp.tv_sec != 0 || buffer->time_stamp.tv_nsec != 0)) {
+        align(buffer);
+    }
+
+    mFramesRead += buffer->frame_count;
+    const size_t frames = std::min(mBufferFrames, buffer->frame_count);
+    memcpy(buffer->raw, mBuffer.data(), frames * mRdChannelCount * sizeof(int16_t));
+    // filling up the reference buffer with 0s, realigned by a later read.
+    memset((int16_t *) buffer->raw + frames * mRdChannelCount, 0,
+            (buffer->frame_count - frames) * mRdChannelCount * sizeof(int16_t));
+    mBufferFrames -= frames;
+    memmove(mBuffer.data(), &mBuffer[frames * mRdChannelCount],
+            mBufferFrames * mRdChannelCount * sizeof(int16_t));
+
+    // As the reference buffer is now time aligned to the microphone signal there is a zero delay
+    buffer->delay_ns = 0;
+
+    ALOGV("echo_reference_read() END %zu frames, total frames buffered %zu",
+            buffer->frame_count, mBufferFrames);
+    return 0;
+}
+
+int echo_reference_write(struct echo_reference_itfe *echo_reference,
+        struct echo_reference_buffer *buffer)
+{
+    if (echo_reference == NULL) {
+        return -EINVAL;
+    }
+    return static_cast<EchoReference *>(echo_reference)->writeBuffer(buffer);
+}
+
+int echo_reference_read(struct echo_reference_itfe *echo_reference,
+        struct echo_reference_buffer *buffer)
+{
+    if (echo_reference == NULL) {
+        return -EINVAL;
+    }
+    return static_cast<EchoReference *>(echo_reference)->readBuffer(buffer);
+}
+
+} // namespace
+
+int create_echo_reference(audio_format_t rdFormat,
+                            uint32_t rdChannelCount,
+                            uint32_t rdSamplingRate,
+                            audio_format_t wrFormat,
+                            uint32_t wrChannelCount,
+                            uint32_t wrSamplingRate,
+                            struct echo_reference_itfe **echo_reference)
+{
+    ALOGV("create_echo_reference()");
+
+    if (echo_reference == NULL) {
+        return -EINVAL;
+    }
+
+    *echo_reference = NULL;
+
+    if (rdFormat != AUDIO_FORMAT_PCM_16_BIT ||
+            rdFormat != wrFormat) {
+        ALOGW("create_echo_reference bad format rd %d, wr %d", rdFormat, wrFormat);
+        return -EINVAL;
+    }
+    if ((rdChannelCount != 1 && rdChannelCount != 2) ||
+            wrChannelCount != 2) {
+        ALOGW("create_echo_reference bad channel count rd %d, wr %d", rdChannelCount,
+                wrChannelCount);
+        return -EINVAL;
+    }
+    if (rdSamplingRate == 0 || wrSamplingRate == 0) {
+        ALOGW("create_echo_reference bad sampling rate rd %d, wr %d", rdSamplingRate,
+                wrSamplingRate);
+        return -EINVAL;
+    }
+
+    EchoReference *er = new (std::nothrow) EchoReference(rdChannelCount, rdSamplingRate,
+            wrChannelCount, wrSamplingRate);
+    if (er == NULL) {
+        return -ENOMEM;
+    }
+    int rc = er->init();
+    if (rc != 0) {
+        delete er;
+        return rc;
+    }
+    er->read = echo_reference_read;
+    er->write = echo_reference_write;
+    *echo_reference = er;
+    return 0;
+}
+
+void release_echo_reference(struct echo_reference_itfe *echo_reference) {
+    if (echo_reference == NULL) {
+        return;
+    }
+
+    ALOGV("EchoReference dstor");
+    delete static_cast<EchoReference *>(echo_reference);
+}
+
+int echo_reference_set_drift_compensation(struct echo_reference_itfe *echo_reference,
+                                          int enabled)
+{
+    if (echo_reference == NULL) {
+        return -EINVAL;
+    }
+    return static_cast<EchoReference *>(echo_reference)->setDriftCompensation(enabled != 0);
+}
+
+float echo_reference_get_drift_ppm(struct echo_reference_itfe *echo_reference)
+{
+    if (echo_reference == NULL) {
+        return 0.f;
+    }
+    return static_cast<EchoReference *>(echo_reference)->getDriftPpm();
+}
@@ -17,19 +17,35 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "audio_utils_fifo"
 
+#include <algorithm>
 #include <errno.h>
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <audio_utils/clock.h>
 #include <audio_utils/clock_nanosleep.h>
 #include <audio_utils/fifo.h>
+#include <audio_utils/fifo_mirrored_buffer.h>
 #include <audio_utils/futex.h>
 #include <audio_utils/roundup.h>
 #include <log/log.h>
 #include <system/audio.h> // FALLTHROUGH_INTENDED
 #include <utils/Errors.h>
 
+// Number of polls of an index between readings of the clock, while spinning.  Must be a power of 2.
+static const unsigned kPollsPerClock = 16;
+
+// Hint to the CPU that we are spinning, to save power and yield to a sibling hardware thread.
+static inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
 audio_utils_fifo_base::audio_utils_fifo_base(uint32_t frameCount,
         audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront)
         __attribute__((no_sanitize("integer"))) :
@@ -128,10 +144,17 @@ void audio_utils_fifo_base::shutdown() const
 ////////////////////////////////////////////////////////////////////////////////
 
 audio_utils_fifo::audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
-        audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront)
+        audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront) :
+    audio_utils_fifo(frameCount, frameSize, buffer, writerRear, throttleFront,
+        false /*mirrored*/)
+{
+}
+
+audio_utils_fifo::audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
+        audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront, bool mirrored)
         __attribute__((no_sanitize("integer"))) :
     audio_utils_fifo_base(frameCount, writerRear, throttleFront),
-    mFrameSize(frameSize), mBuffer(buffer)
+    mFrameSize(frameSize), mBuffer(buffer), mMirrored(mirrored)
 {
     // maximum value of frameCount * frameSize is INT32_MAX (2^31 - 1), not 2^31, because we need to
     // be able to distinguish successful and error return values from read and write.
@@ -140,9 +163,28 @@ audio_utils_fifo::audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void
 }
 
 audio_utils_fifo::audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
+        audio_utils_fifo_control& control, bool throttlesWriter) :
+    audio_utils_fifo(frameCount, frameSize, buffer, control.mRear,
+        throttlesWriter ? &control.mFront : NULL)
+{
+}
+
+audio_utils_fifo::audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
+        bool throttlesWriter) :
+    audio_utils_fifo(frameCount, frameSize, buffer, mSingleProcessControl, throttlesWriter)
+{
+}
+
+audio_utils_fifo::audio_utils_fifo(const audio_utils_fifo_mirrored_buffer& buffer,
+        audio_utils_fifo_control& control, bool throttlesWriter) :
+    audio_utils_fifo(buffer.frameCount(), buffer.frameSize(), buffer.buffer(), control.mRear,
+        throttlesWriter ? &control.mFront : NULL, true /*mirrored*/)
+{
+}
+
+audio_utils_fifo::audio_utils_fifo(const audio_utils_fifo_mirrored_buffer& buffer,
         bool throttlesWriter) :
-    audio_utils_fifo(frameCount, frameSize, buffer, mSingleProcessSharedRear,
-        throttlesWriter ?  &mSingleProcessSharedFront : NULL)
+    audio_utils_fifo(buffer, mSingleProcessControl, throttlesWriter)
 {
 }
 
@@ -164,15 +206,18 @@ audio_utils_fifo_provider::~audio_utils_fifo_provider()
 ////////////////////////////////////////////////////////////////////////////////
 
 audio_utils_fifo_writer::audio_utils_fifo_writer(audio_utils_fifo& fifo) :
-    audio_utils_fifo_provider(fifo), mLocalRear(0),
+    audio_utils_fifo_provider(fifo), mLocalRear(0), mCachedFront(0),
     mArmLevel(fifo.mFrameCount), mTriggerLevel(0),
     mIsArmed(true), // because initial fill level of zero is < mArmLevel
-    mEffectiveFrames(fifo.mFrameCount)
+    mEffectiveFrames(fifo.mFrameCount),
+    mWriterRearWake(fifo.mWriterRear), mWakeBatchFrames(0), mDeferredFrames(0),
+    mTotalWakes(0), mTotalWakesAvoided(0)
 {
 }
 
 audio_utils_fifo_writer::~audio_utils_fifo_writer()
 {
+    wakeNowIfNeeded();
 }
 
 ssize_t audio_utils_fifo_writer::write(const void *buffer, size_t count,
@@ -203,9 +248,14 @@ ssize_t audio_utils_fifo_writer::obtain(audio_utils_iovec iovec[2], size_t count
     size_t availToWrite;
     if (mFifo.mThrottleFront != NULL) {
         int retries = kRetries;
-        uint32_t front;
+        uint32_t front = mCachedFront;
+        // The cached front index is used first, and is enough if it leaves room for count frames.
+        bool cached = true;
         for (;;) {
-            front = mFifo.mThrottleFront->loadAcquire();
+            if (!cached) {
+                front = mFifo.mThrottleFront->loadAcquire();
+                mCachedFront = front;
+            }
             // returns -EIO if mIsShutdown
             int32_t filled = mFifo.diff(mLocalRear, front);
             if (filled < 0) {
@@ -216,11 +266,20 @@ ssize_t audio_utils_fifo_writer::obtain(audio_utils_iovec iovec[2], size_t count
             }
             availToWrite = mEffectiveFrames > (uint32_t) filled ?
                     mEffectiveFrames - (uint32_t) filled : 0;
+            if (cached) {
+                cached = false;
+                if (availToWrite < count) {
+                    continue;
+                }
+            }
             // TODO pull out "count == 0"
             if (count == 0 || availToWrite > 0 || timeout == NULL ||
                     (timeout->tv_sec == 0 && timeout->tv_nsec == 0)) {
                 break;
             }
+            // The reader may be blocked waiting for a deferred wake, so wake it before we block
+            // waiting for it.
+            wakeNowIfNeeded();
             // TODO add comments
             // TODO abstract out switch and replace by general sync object
             //      the high level code (synchronization, sleep, futex, iovec) should be completely
@@ -284,7 +343,7 @@ ssize_t audio_utils_fifo_writer::obtain(audio_utils_iovec iovec[2], size_t count
         availToWrite = count;
     }
     uint32_t rearOffset = mLocalRear & (mFifo.mFrameCountP2 - 1);
-    size_t part1 = mFifo.mFrameCount - rearOffset;
+    size_t part1 = mFifo.mMirrored ? availToWrite : mFifo.mFrameCount - rearOffset;
     if (part1 > availToWrite) {
         part1 = availToWrite;
     }
@@ -311,9 +370,12 @@ void audio_utils_fifo_writer::release(size_t count)
             return;
         }
         if (mFifo.mThrottleFront != NULL) {
-            uint32_t front = mFifo.mThrottleFront->loadAcquire();
             // returns -EIO if mIsShutdown
-            int32_t filled = mFifo.diff(mLocalRear, front);
+            int32_t filled = mFifo.diff(mLocalRear, mCachedFront);
+            if (filled >= 0 && needsFreshFront(filled, count)) {
+                mCachedFront = mFifo.mThrottleFront->loadAcquire();
+                filled = mFifo.diff(mLocalRear, mCachedFront);
+            }
             mLocalRear = mFifo.sum(mLocalRear, count);
             mFifo.mWriterRear.storeRelease(mLocalRear);
             // TODO add comments
@@ -330,15 +392,21 @@ void audio_utils_fifo_writer::release(size_t count)
                         mIsArmed = true;
                     }
                     if (mIsArmed && filled + count > mTriggerLevel) {
-                        int err = mFifo.mWriterRear.wake(op, INT32_MAX /*waiters*/);
-                        // err is number of processes woken up
-                        if (err < 0) {
-                            LOG_ALWAYS_FATAL("%s: unexpected err=%d errno=%d",
-                                    __func__, err, errno);
+                        if (mWriterRearWake.wakePending()) {
+                            mTotalWakesAvoided++;
                         }
+                        mWriterRearWake.wakeDeferred(op, INT32_MAX /*waiters*/);
                         mIsArmed = false;
                     }
                 }
+                if (mWriterRearWake.wakePending()) {
+                    if (mDeferredFrames >= mWakeBatchFrames ||
+                            count >= mWakeBatchFrames - mDeferredFrames) {
+                        wakeNowIfNeeded();
+                    } else {
+                        mDeferredFrames += count;
+                    }
+                }
                 break;
             default:
                 LOG_ALWAYS_FATAL("mFifo.mWriterRearSync=%d", mFifo.mWriterRearSync);
@@ -353,6 +421,30 @@ void audio_utils_fifo_writer::release(size_t count)
     }
 }
 
+void audio_utils_fifo_writer::wakeNowIfNeeded()
+{
+    if (mWriterRearWake.wakePending()) {
+        int err = mWriterRearWake.wakeNowIfNeeded();
+        // err is number of processes woken up
+        if (err < 0) {
+            LOG_ALWAYS_FATAL("%s: unexpected err=%d errno=%d", __func__, err, errno);
+        }
+        mTotalWakes++;
+        mDeferredFrames = 0;
+    }
+}
+
+bool audio_utils_fifo_writer::needsFreshFront(uint32_t filled, size_t count) const
+{
+    // The actual fill level is in the range [0, filled], so may arm where filled does not ...
+    if (filled >= mArmLevel && mArmLevel > 0) {
+        return true;
+    }
+    // ... or may not trigger where filled does.
+    const bool armed = mIsArmed || filled < mArmLevel;
+    return armed && filled + count > mTriggerLevel && count <= mTriggerLevel;
+}
+
 ssize_t audio_utils_fifo_writer::available()
 {
     // iovec == NULL is not part of the public API, but internally it means don't set mObtained
@@ -418,12 +510,15 @@ audio_utils_fifo_reader::audio_utils_fifo_reader(audio_utils_fifo& fifo, bool th
     // where reader starts out more than one buffer behind writer.  The initial catch-up does not
     // contribute towards the totalLost, totalFlushed, or totalReleased counters.
     mLocalFront(throttlesWriter ? 0 : mFifo.mWriterRear.loadConsume()),
+    mCachedRear(mLocalFront),
 
     mThrottleFront(throttlesWriter ? mFifo.mThrottleFront : NULL),
     mFlush(flush),
     mArmLevel(-1), mTriggerLevel(mFifo.mFrameCount),
     mIsArmed(true), // because initial fill level of zero is > mArmLevel
-    mTotalLost(0), mTotalFlushed(0)
+    mTotalLost(0), mTotalFlushed(0),
+    mSpinNs(0), mTotalWaits(0), mTotalWaitsAvoided(0),
+    mSlot(NULL)
 {
 }
 
@@ -469,9 +564,12 @@ void audio_utils_fifo_reader::release(size_t count)
             return;
         }
         if (mThrottleFront != NULL) {
-            uint32_t rear = mFifo.mWriterRear.loadAcquire();
             // returns -EIO if mIsShutdown
-            int32_t filled = mFifo.diff(rear, mLocalFront);
+            int32_t filled = mFifo.diff(mCachedRear, mLocalFront);
+            if (filled >= 0 && needsFreshRear(filled, count)) {
+                mCachedRear = mFifo.mWriterRear.loadAcquire();
+                filled = mFifo.diff(mCachedRear, mLocalFront);
+            }
             mLocalFront = mFifo.sum(mLocalFront, count);
             mThrottleFront->storeRelease(mLocalFront);
             // TODO add comments
@@ -504,6 +602,7 @@ void audio_utils_fifo_reader::release(size_t count)
             }
         } else {
             mLocalFront = mFifo.sum(mLocalFront, count);
+            publish();
         }
         mObtained -= count;
         mTotalReleased += count;
@@ -517,9 +616,25 @@ ssize_t audio_utils_fifo_reader::obtain(audio_utils_iovec iovec[2], size_t count
 {
     int err = 0;
     int retries = kRetries;
+    bool canSpin = mSpinNs > 0;
+    struct timespec remaining;
     uint32_t rear;
+    // A throttling reader uses the cached rear index first, and it is enough if it has count
+    // frames.  Other readers must load the rear index to detect lost frames.
+    bool cached = mThrottleFront != NULL;
     for (;;) {
+        if (cached) {
+            cached = false;
+            rear = mCachedRear;
+            int32_t filled = mFifo.diff(rear, mLocalFront);
+            if (filled >= 0 && (size_t) filled >= count) {
+                break;
+            }
+        }
         rear = mFifo.mWriterRear.loadAcquire();
+        if (mThrottleFront != NULL) {
+            mCachedRear = rear;
+        }
         // TODO pull out "count == 0"
         if (count == 0 || rear != mLocalFront || timeout == NULL ||
                 (timeout->tv_sec == 0 && timeout->tv_nsec == 0)) {
@@ -542,9 +657,23 @@ ssize_t audio_utils_fifo_reader::obtain(audio_utils_iovec iovec[2], size_t count
             op = FUTEX_WAIT_PRIVATE;
             FALLTHROUGH_INTENDED;
         case AUDIO_UTILS_FIFO_SYNC_SHARED:
+            if (canSpin) {
+                canSpin = false;
+                if (spin(rear, timeout, &remaining)) {
+                    mTotalWaitsAvoided++;
+                    // bypass the "timeout = NULL;" below
+                    continue;
+                }
+                if (remaining.tv_sec == 0 && remaining.tv_nsec == 0) {
+                    err = -ETIMEDOUT;
+                    break;
+                }
+                timeout = &remaining;
+            }
             if (timeout->tv_sec == LONG_MAX) {
                 timeout = NULL;
             }
+            mTotalWaits++;
             err = mFifo.mWriterRear.wait(op, rear, timeout);
             if (err < 0) {
                 switch (errno) {
@@ -585,6 +714,7 @@ ssize_t audio_utils_fifo_reader::obtain(audio_utils_iovec iovec[2], size_t count
         if (filled == -EOVERFLOW) {
             // catch up with writer, but preserve the still valid frames in buffer
             mLocalFront = rear - (mFlush ? 0 : mFifo.mFrameCountP2 /*sic*/);
+            publish();
         }
         // on error, return an empty slice
         err = filled;
@@ -595,7 +725,7 @@ ssize_t audio_utils_fifo_reader::obtain(audio_utils_iovec iovec[2], size_t count
         availToRead = count;
     }
     uint32_t frontOffset = mLocalFront & (mFifo.mFrameCountP2 - 1);
-    size_t part1 = mFifo.mFrameCount - frontOffset;
+    size_t part1 = mFifo.mMirrored ? availToRead : mFifo.mFrameCount - frontOffset;
     if (part1 > availToRead) {
         part1 = availToRead;
     }
@@ -611,6 +741,66 @@ ssize_t audio_utils_fifo_reader::obtain(audio_utils_iovec iovec[2], size_t count
     return availToRead > 0 ? availToRead : err;
 }
 
+bool audio_utils_fifo_reader::needsFreshRear(uint32_t filled, size_t count) const
+{
+    // The actual fill level is in the range [filled, mFifo.mFrameCount], so may arm where filled
+    // does not ...
+    if ((int32_t) filled <= mArmLevel && (uint32_t) mArmLevel < mFifo.mFrameCount) {
+        return true;
+    }
+    // ... or may not trigger where filled does.
+    const bool armed = mIsArmed || (int32_t) filled > mArmLevel;
+    return armed && filled - count < mTriggerLevel && mFifo.mFrameCount - count >= mTriggerLevel;
+}
+
+bool audio_utils_fifo_reader::spin(uint32_t rear, const struct timespec *timeout,
+        struct timespec *remaining)
+{
+    const bool infinite = timeout->tv_sec == LONG_MAX;
+    int64_t limitNs = mSpinNs;
+    if (!infinite) {
+        const int64_t timeoutNs = audio_utils_ns_from_timespec(timeout);
+        if (limitNs > timeoutNs) {
+            limitNs = timeoutNs;
+        }
+    }
+    struct timespec now;
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    const int64_t startNs = audio_utils_ns_from_timespec(&now);
+    int64_t elapsedNs = 0;
+    // Check the time only every few polls, as a poll is much cheaper than reading the clock.
+    for (unsigned polls = 1; ; ++polls) {
+        cpuRelax();
+        if (mFifo.mWriterRear.loadAcquire() != rear) {
+            return true;
+        }
+        if ((polls & (kPollsPerClock - 1)) == 0) {
+            (void) clock_gettime(CLOCK_MONOTONIC, &now);
+            elapsedNs = audio_utils_ns_from_timespec(&now) - startNs;
+            if (elapsedNs >= limitNs) {
+                break;
+            }
+        }
+    }
+    if (infinite) {
+        *remaining = *timeout;
+    } else {
+        const int64_t remainingNs = std::max(audio_utils_ns_from_timespec(timeout) - elapsedNs,
+                (int64_t) 0);
+        remaining->tv_sec = remainingNs / NANOS_PER_SECOND;
+        remaining->tv_nsec = remainingNs % NANOS_PER_SECOND;
+    }
+    return false;
+}
+
+void audio_utils_fifo_reader::publish()
+{
+    if (mSlot != NULL) {
+        mSlot->mFront.storeRelease(mLocalFront);
+        mSlot->mLost.store(mTotalLost, std::memory_order_relaxed);
+    }
+}
+
 ssize_t audio_utils_fifo_reader::available()
 {
     return available(NULL /*lost*/);
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_broadcast"
+
+#include <errno.h>
+
+#include <audio_utils/fifo_broadcast.h>
+#include <log/log.h>
+
+// Values of audio_utils_fifo_reader_slot::mState.
+// A reader claims a free slot, initializes it, and only then marks it registered, so that
+// observers never see the front index left by a previous reader in the same slot.
+static const uint32_t kSlotFree = 0;
+static const uint32_t kSlotRegistering = 1;
+static const uint32_t kSlotRegistered = 2;
+
+audio_utils_fifo_broadcast::audio_utils_fifo_broadcast(uint32_t frameCount, uint32_t frameSize,
+        void *buffer, audio_utils_fifo_index& writerRear, audio_utils_fifo_reader_slot *slots,
+        uint32_t slotCount) :
+    audio_utils_fifo(frameCount, frameSize, buffer, writerRear, NULL /*throttleFront*/),
+    mSlots(slots), mSlotCount(slotCount)
+{
+    LOG_ALWAYS_FATAL_IF(slots == NULL || slotCount == 0 || slotCount > (uint32_t) INT32_MAX);
+}
+
+audio_utils_fifo_broadcast::audio_utils_fifo_broadcast(uint32_t frameCount, uint32_t frameSize,
+        void *buffer, uint32_t slotCount) :
+    audio_utils_fifo(frameCount, frameSize, buffer, false /*throttlesWriter*/),
+    mSingleProcessSlots(new audio_utils_fifo_reader_slot[slotCount]),
+    mSlots(mSingleProcessSlots.get()), mSlotCount(slotCount)
+{
+    LOG_ALWAYS_FATAL_IF(slotCount == 0 || slotCount > (uint32_t) INT32_MAX);
+}
+
+audio_utils_fifo_broadcast::~audio_utils_fifo_broadcast()
+{
+}
+
+int64_t audio_utils_fifo_broadcast::lag(const audio_utils_fifo_reader_slot& slot,
+        uint64_t *lost) const
+{
+    if (slot.mState.load(std::memory_order_acquire) != kSlotRegistered) {
+        return -ENOENT;
+    }
+    // Load the front index before the rear index, so that the lag is not understated.
+    const uint32_t front = const_cast<audio_utils_fifo_index&>(slot.mFront).loadAcquire();
+    const uint64_t readerLost = slot.mLost.load(std::memory_order_relaxed);
+    const uint32_t rear = mWriterRear.loadAcquire();
+    size_t overrun;
+    const int32_t filled = diff(rear, front, &overrun);
+    if (lost != NULL) {
+        *lost = readerLost;
+    }
+    if (filled >= 0) {
+        return filled;
+    }
+    if (filled == -EOVERFLOW) {
+        // The reader has been overrun and has not caught up yet.
+        return (int64_t) mFrameCount + overrun;
+    }
+    return filled;
+}
+
+int64_t audio_utils_fifo_broadcast::readerLag(uint32_t slot, uint64_t *lost) const
+{
+    if (slot >= mSlotCount) {
+        return -EINVAL;
+    }
+    return lag(mSlots[slot], lost);
+}
+
+audio_utils_fifo_lag audio_utils_fifo_broadcast::lag() const
+{
+    audio_utils_fifo_lag summary = {0 /*mReaders*/, 0 /*mMinLag*/, 0 /*mMaxLag*/,
+            -1 /*mSlowest*/, 0 /*mTotalLost*/};
+    for (uint32_t i = 0; i < mSlotCount; ++i) {
+        uint64_t lost;
+        const int64_t readerLag = lag(mSlots[i], &lost);
+        if (readerLag < 0) {
+            continue;
+        }
+        const uint32_t frames = readerLag > UINT32_MAX ? UINT32_MAX : (uint32_t) readerLag;
+        if (summary.mReaders == 0 || frames < summary.mMinLag) {
+            summary.mMinLag = frames;
+        }
+        if (summary.mReaders == 0 || frames > summary.mMaxLag) {
+            summary.mMaxLag = frames;
+            summary.mSlowest = (int32_t) i;
+        }
+        summary.mReaders++;
+        summary.mTotalLost += lost;
+    }
+    return summary;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+audio_utils_fifo_broadcast_reader::audio_utils_fifo_broadcast_reader(
+        audio_utils_fifo_broadcast& fifo, bool flush) :
+    audio_utils_fifo_reader(fifo, false /*throttlesWriter*/, flush),
+    mSlotIndex(-1)
+{
+    for (uint32_t i = 0; i < fifo.mSlotCount; ++i) {
+        audio_utils_fifo_reader_slot& slot = fifo.mSlots[i];
+        uint32_t state = kSlotFree;
+        if (slot.mState.compare_exchange_strong(state, kSlotRegistering,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+            mSlot = &slot;
+            mSlotIndex = (int32_t) i;
+            publish();
+            slot.mState.store(kSlotRegistered, std::memory_order_release);
+            return;
+        }
+    }
+    ALOGW("%s: all %u slots are in use, so the reader is not registered",
+            __func__, fifo.mSlotCount);
+}
+
+audio_utils_fifo_broadcast_reader::~audio_utils_fifo_broadcast_reader()
+{
+    if (mSlot != NULL) {
+        mSlot->mState.store(kSlotFree, std::memory_order_release);
+        mSlot = NULL;
+    }
+}
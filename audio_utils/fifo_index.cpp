@@ -48,11 +48,17 @@ uint32_t audio_utils_fifo_index::loadConsume()
     return atomic_load_explicit(&mIndex, std::memory_order_consume);
 }
 
+bool audio_utils_fifo_index::compareExchange(uint32_t &expected, uint32_t desired)
+{
+    return atomic_compare_exchange_strong_explicit(&mIndex, &expected, desired,
+            std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
 ////
 
 RefIndexDeferredStoreReleaseDeferredWake::RefIndexDeferredStoreReleaseDeferredWake(
         audio_utils_fifo_index& index)
-    : mIndex(index), mValue(0), mWriteback(false), mWaiters(0), mWakeOp(FUTEX_WAIT_PRIVATE)
+    : mIndex(index), mValue(0), mWriteback(false), mWaiters(0), mWakeOp(FUTEX_WAKE_PRIVATE)
 {
 }
 
@@ -97,13 +103,15 @@ void RefIndexDeferredStoreReleaseDeferredWake::wakeDeferred(int op, int waiters)
     }
 }
 
-void RefIndexDeferredStoreReleaseDeferredWake::wakeNowIfNeeded()
+int RefIndexDeferredStoreReleaseDeferredWake::wakeNowIfNeeded()
 {
+    int woken = 0;
     if (mWaiters > 0) {
-        mIndex.wake(mWakeOp, mWaiters);
+        woken = mIndex.wake(mWakeOp, mWaiters);
         mWaiters = 0;
         mWakeOp = FUTEX_WAKE_PRIVATE;
     }
+    return woken;
 }
 
 void RefIndexDeferredStoreReleaseDeferredWake::wakeNow(int op, int waiters)
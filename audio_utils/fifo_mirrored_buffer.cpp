@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_mirrored_buffer"
+
+#include <errno.h>
+#include <numeric>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <audio_utils/fifo_mirrored_buffer.h>
+#include <cutils/ashmem.h>
+#include <log/log.h>
+
+audio_utils_fifo_mirrored_buffer::audio_utils_fifo_mirrored_buffer(uint32_t frameCount,
+        uint32_t frameSize) :
+    mFrameCount(frameCount), mFrameSize(frameSize), mFd(-1), mBuffer(NULL), mStatus(0)
+{
+    map();
+}
+
+audio_utils_fifo_mirrored_buffer::audio_utils_fifo_mirrored_buffer(int fd, uint32_t frameCount,
+        uint32_t frameSize) :
+    mFrameCount(frameCount), mFrameSize(frameSize), mFd(fd), mBuffer(NULL), mStatus(0)
+{
+    map();
+}
+
+audio_utils_fifo_mirrored_buffer::~audio_utils_fifo_mirrored_buffer()
+{
+    if (mBuffer != NULL) {
+        (void) munmap(mBuffer, 2 * (size_t) mFrameCount * mFrameSize);
+    }
+    if (mFd >= 0) {
+        (void) close(mFd);
+    }
+}
+
+void audio_utils_fifo_mirrored_buffer::map()
+{
+    const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t size = (size_t) mFrameCount * mFrameSize;
+    // The FIFO requires frameCount * frameSize <= INT32_MAX, and both mappings must fit.
+    if (size == 0 || size > INT32_MAX || size % pageSize != 0) {
+        ALOGE("%s: invalid frameCount=%u frameSize=%u", __func__, mFrameCount, mFrameSize);
+        mStatus = -EINVAL;
+        return;
+    }
+    if (mFd < 0) {
+        mFd = ashmem_create_region("audio_utils_fifo_mirrored_buffer", size);
+        if (mFd < 0) {
+            mStatus = -errno;
+            ALOGE("%s: ashmem_create_region failed errno=%d", __func__, errno);
+            return;
+        }
+    }
+
+    // Reserve enough address space for both mappings, then replace each half of the reservation
+    // by a mapping of the same region, so no other mapping can take the second half meanwhile.
+    void *reservation = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        mStatus = -ENOMEM;
+        ALOGE("%s: unable to reserve %zu bytes errno=%d", __func__, 2 * size, errno);
+        return;
+    }
+    for (size_t offset = 0; offset < 2 * size; offset += size) {
+        void *mapping = mmap((char *) reservation + offset, size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_FIXED, mFd, 0);
+        if (mapping == MAP_FAILED) {
+            mStatus = -errno;
+            ALOGE("%s: mmap failed errno=%d", __func__, errno);
+            (void) munmap(reservation, 2 * size);
+            return;
+        }
+    }
+    mBuffer = reservation;
+}
+
+uint32_t audio_utils_fifo_mirrored_buffer::alignFrameCount(uint32_t frameCount,
+        uint32_t frameSize)
+{
+    if (frameSize == 0) {
+        return 0;
+    }
+    const uint64_t pageSize = (uint64_t) sysconf(_SC_PAGESIZE);
+    const uint64_t granularity = pageSize / std::gcd(pageSize, (uint64_t) frameSize);
+    const uint64_t aligned = (frameCount + granularity - 1) / granularity * granularity;
+    return aligned > 0 && aligned <= UINT32_MAX ? (uint32_t) aligned : 0;
+}
@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_mpmc"
+
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+#include <audio_utils/clock_nanosleep.h>
+#include <audio_utils/fifo_mpmc.h>
+#include <audio_utils/futex.h>
+#include <log/log.h>
+#include <system/audio.h> // FALLTHROUGH_INTENDED
+
+// Number of times to poll a committed index before blocking on it, when waiting for a
+// predecessor to commit.  The predecessor is usually copying frames, so is close to done.
+static const int kCommitSpins = 100;
+
+// Maximum time to block on a committed index per poll, when waiting for a predecessor to commit.
+// The predecessor wakes us, so this only bounds the wait should the wake be missed.
+static const struct timespec kCommitTimeout = {0 /*tv_sec*/, 1000000 /*tv_nsec*/};
+
+audio_utils_fifo_mpmc::audio_utils_fifo_mpmc(uint32_t frameCount, uint32_t frameSize,
+        void *buffer, audio_utils_fifo_index& writerRear, audio_utils_fifo_index& throttleFront,
+        audio_utils_fifo_index& writerReserve, audio_utils_fifo_index& readerReserve) :
+    audio_utils_fifo(frameCount, frameSize, buffer, writerRear, &throttleFront),
+    mWriterReserve(writerReserve), mReaderReserve(readerReserve)
+{
+}
+
+audio_utils_fifo_mpmc::audio_utils_fifo_mpmc(uint32_t frameCount, uint32_t frameSize,
+        void *buffer) :
+    audio_utils_fifo_mpmc(frameCount, frameSize, buffer,
+            mSingleProcessIndices.mControl.mRear, mSingleProcessIndices.mControl.mFront,
+            mSingleProcessIndices.mWriterReserve, mSingleProcessIndices.mReaderReserve)
+{
+}
+
+audio_utils_fifo_mpmc::~audio_utils_fifo_mpmc()
+{
+}
+
+int audio_utils_fifo_mpmc::wait(audio_utils_fifo_index& index, audio_utils_fifo_sync sync,
+        uint32_t expected, const struct timespec *timeout) const
+{
+    int err = 0;
+    int op = FUTEX_WAIT;
+    switch (sync) {
+    case AUDIO_UTILS_FIFO_SYNC_SLEEP:
+        err = audio_utils_clock_nanosleep(CLOCK_MONOTONIC, 0 /*flags*/, timeout,
+                NULL /*remain*/);
+        if (err < 0) {
+            LOG_ALWAYS_FATAL_IF(errno != EINTR, "unexpected err=%d errno=%d", err, errno);
+            err = -errno;
+        } else {
+            err = -ETIMEDOUT;
+        }
+        break;
+    case AUDIO_UTILS_FIFO_SYNC_PRIVATE:
+        op = FUTEX_WAIT_PRIVATE;
+        FALLTHROUGH_INTENDED;
+    case AUDIO_UTILS_FIFO_SYNC_SHARED:
+        if (timeout != NULL && timeout->tv_sec == LONG_MAX) {
+            timeout = NULL;
+        }
+        err = index.wait(op, expected, timeout);
+        if (err < 0) {
+            switch (errno) {
+            case EWOULDBLOCK:
+            case EINTR:
+            case ETIMEDOUT:
+                err = -errno;
+                break;
+            default:
+                LOG_ALWAYS_FATAL("unexpected err=%d errno=%d", err, errno);
+                break;
+            }
+        }
+        break;
+    default:
+        LOG_ALWAYS_FATAL("sync=%d", sync);
+        break;
+    }
+    return err;
+}
+
+void audio_utils_fifo_mpmc::wake(audio_utils_fifo_index& index, audio_utils_fifo_sync sync) const
+{
+    int op = FUTEX_WAKE;
+    switch (sync) {
+    case AUDIO_UTILS_FIFO_SYNC_SLEEP:
+        break;
+    case AUDIO_UTILS_FIFO_SYNC_PRIVATE:
+        op = FUTEX_WAKE_PRIVATE;
+        FALLTHROUGH_INTENDED;
+    case AUDIO_UTILS_FIFO_SYNC_SHARED: {
+        // Wake every waiter: several writers or readers may be waiting for a predecessor,
+        // as well as the other side waiting for frames or space.
+        int err = index.wake(op, INT32_MAX /*waiters*/);
+        // err is number of processes woken up
+        if (err < 0) {
+            LOG_ALWAYS_FATAL("%s: unexpected err=%d errno=%d", __func__, err, errno);
+        }
+        } break;
+    default:
+        LOG_ALWAYS_FATAL("sync=%d", sync);
+        break;
+    }
+}
+
+void audio_utils_fifo_mpmc::commit(audio_utils_fifo_index& index, audio_utils_fifo_sync sync,
+        uint32_t start, uint32_t end) const
+{
+    int spins = kCommitSpins;
+    for (;;) {
+        uint32_t committed = index.loadAcquire();
+        if (committed == start) {
+            break;
+        }
+        if (mIsShutdown) {
+            return;
+        }
+        if (spins > 0) {
+            --spins;
+            continue;
+        }
+        // Errors are benign here: we poll again regardless.
+        (void) wait(index, sync, committed, &kCommitTimeout);
+    }
+    index.storeRelease(end);
+    wake(index, sync);
+}
+
+void audio_utils_fifo_mpmc::slice(uint32_t index, size_t count, audio_utils_iovec iovec[2]) const
+{
+    uint32_t offset = index & (mFrameCountP2 - 1);
+    size_t part1 = mFrameCount - offset;
+    if (part1 > count) {
+        part1 = count;
+    }
+    iovec[0].mOffset = offset;
+    iovec[0].mLength = part1;
+    iovec[1].mOffset = 0;
+    iovec[1].mLength = part1 > 0 ? count - part1 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+audio_utils_fifo_multi_writer::audio_utils_fifo_multi_writer(audio_utils_fifo_mpmc& fifo) :
+    audio_utils_fifo_provider(fifo), mMpmc(fifo), mReserved(0)
+{
+}
+
+audio_utils_fifo_multi_writer::~audio_utils_fifo_multi_writer()
+{
+    // Other writers would otherwise wait for our reservation forever.
+    if (mObtained > 0) {
+        release(0);
+    }
+}
+
+ssize_t audio_utils_fifo_multi_writer::write(const void *buffer, size_t count,
+        const struct timespec *timeout)
+{
+    audio_utils_iovec iovec[2];
+    ssize_t availToWrite = obtain(iovec, count, timeout);
+    if (availToWrite > 0) {
+        const uint32_t frameSize = mMpmc.frameSize();
+        memcpy((char *) mMpmc.buffer() + iovec[0].mOffset * frameSize, buffer,
+                iovec[0].mLength * frameSize);
+        if (iovec[1].mLength > 0) {
+            memcpy((char *) mMpmc.buffer() + iovec[1].mOffset * frameSize,
+                    (char *) buffer + (iovec[0].mLength * frameSize),
+                    iovec[1].mLength * frameSize);
+        }
+        release(availToWrite);
+    }
+    return availToWrite;
+}
+
+// iovec == NULL is not part of the public API, but internally it means don't reserve
+ssize_t audio_utils_fifo_multi_writer::obtain(audio_utils_iovec iovec[2], size_t count,
+        const struct timespec *timeout)
+        __attribute__((no_sanitize("integer")))
+{
+    if (iovec != NULL && mObtained > 0) {
+        release(0);
+    }
+    int err = 0;
+    int retries = kRetries;
+    uint32_t reserved;
+    size_t availToWrite;
+    for (;;) {
+        // The reserve index is loaded before the front, so the front is only ahead of it if
+        // other writers reserved since, which is detected and retried below.
+        reserved = mMpmc.mWriterReserve.loadAcquire();
+        const uint32_t front = mMpmc.mThrottleFront->loadAcquire();
+        // returns -EIO if mIsShutdown
+        int32_t filled = mMpmc.diff(reserved, front);
+        if (filled < 0) {
+            if (filled == -EOVERFLOW && mMpmc.mWriterReserve.loadAcquire() != reserved) {
+                // Other writers reserved and readers released between the loads.
+                continue;
+            }
+            err = filled;
+            availToWrite = 0;
+            break;
+        }
+        availToWrite = mMpmc.mFrameCount - (uint32_t) filled;
+        if (availToWrite > count) {
+            availToWrite = count;
+        }
+        if (availToWrite > 0) {
+            if (iovec == NULL || mMpmc.mWriterReserve.compareExchange(reserved,
+                    mMpmc.sum(reserved, availToWrite))) {
+                break;
+            }
+            // Another writer reserved first.
+            continue;
+        }
+        if (count == 0 || timeout == NULL ||
+                (timeout->tv_sec == 0 && timeout->tv_nsec == 0)) {
+            break;
+        }
+        err = mMpmc.wait(*mMpmc.mThrottleFront, mMpmc.mThrottleFrontSync, front, timeout);
+        if (err == -EWOULDBLOCK && retries-- > 0) {
+            // Benign race condition with a reader, try to load the index again.
+            continue;
+        }
+        if (err == 0 && timeout->tv_sec == LONG_MAX) {
+            // Another writer may have reserved the space first, so keep waiting.
+            continue;
+        }
+        timeout = NULL;
+    }
+    if (iovec != NULL) {
+        mMpmc.slice(reserved, availToWrite, iovec);
+        mReserved = reserved;
+        mObtained = availToWrite;
+    }
+    return availToWrite > 0 ? availToWrite : err;
+}
+
+void audio_utils_fifo_multi_writer::release(size_t count)
+        __attribute__((no_sanitize("integer")))
+{
+    if (count > mObtained) {
+        ALOGE("%s(count=%zu) > mObtained=%u", __func__, count, mObtained);
+        mMpmc.shutdown();
+        return;
+    }
+    if (mObtained == 0) {
+        return;
+    }
+    if (count < mObtained) {
+        audio_utils_iovec iovec[2];
+        const uint32_t frameSize = mMpmc.frameSize();
+        mMpmc.slice(mMpmc.sum(mReserved, count), mObtained - count, iovec);
+        for (const audio_utils_iovec &fragment : iovec) {
+            memset((char *) mMpmc.buffer() + fragment.mOffset * frameSize, 0,
+                    fragment.mLength * frameSize);
+        }
+    }
+    mMpmc.commit(mMpmc.mWriterRear, mMpmc.mWriterRearSync,
+            mReserved, mMpmc.sum(mReserved, mObtained));
+    mObtained = 0;
+    mTotalReleased += count;
+}
+
+ssize_t audio_utils_fifo_multi_writer::available()
+{
+    // iovec == NULL is not part of the public API, but internally it means don't reserve
+    return obtain(NULL /*iovec*/, SIZE_MAX /*count*/, NULL /*timeout*/);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+audio_utils_fifo_multi_reader::audio_utils_fifo_multi_reader(audio_utils_fifo_mpmc& fifo) :
+    audio_utils_fifo_provider(fifo), mMpmc(fifo), mReserved(0)
+{
+}
+
+audio_utils_fifo_multi_reader::~audio_utils_fifo_multi_reader()
+{
+    // Other readers would otherwise wait for our reservation forever.
+    if (mObtained > 0) {
+        release(0);
+    }
+}
+
+ssize_t audio_utils_fifo_multi_reader::read(void *buffer, size_t count,
+        const struct timespec *timeout)
+{
+    audio_utils_iovec iovec[2];
+    ssize_t availToRead = obtain(iovec, count, timeout);
+    if (availToRead > 0) {
+        const uint32_t frameSize = mMpmc.frameSize();
+        memcpy(buffer, (char *) mMpmc.buffer() + iovec[0].mOffset * frameSize,
+                iovec[0].mLength * frameSize);
+        if (iovec[1].mLength > 0) {
+            memcpy((char *) buffer + (iovec[0].mLength * frameSize),
+                    (char *) mMpmc.buffer() + iovec[1].mOffset * frameSize,
+                    iovec[1].mLength * frameSize);
+        }
+        release(availToRead);
+    }
+    return availToRead;
+}
+
+// iovec == NULL is not part of the public API, but internally it means don't reserve
+ssize_t audio_utils_fifo_multi_reader::obtain(audio_utils_iovec iovec[2], size_t count,
+        const struct timespec *timeout)
+        __attribute__((no_sanitize("integer")))
+{
+    if (iovec != NULL && mObtained > 0) {
+        release(0);
+    }
+    int err = 0;
+    int retries = kRetries;
+    uint32_t reserved;
+    size_t availToRead;
+    for (;;) {
+        reserved = mMpmc.mReaderReserve.loadAcquire();
+        const uint32_t rear = mMpmc.mWriterRear.loadAcquire();
+        // returns -EIO if mIsShutdown
+        int32_t filled = mMpmc.diff(rear, reserved);
+        if (filled < 0) {
+            if (filled == -EOVERFLOW && mMpmc.mReaderReserve.loadAcquire() != reserved) {
+                // Other readers reserved and writers committed between the loads.
+                continue;
+            }
+            err = filled;
+            availToRead = 0;
+            break;
+        }
+        availToRead = (size_t) filled;
+        if (availToRead > count) {
+            availToRead = count;
+        }
+        if (availToRead > 0) {
+            if (iovec == NULL || mMpmc.mReaderReserve.compareExchange(reserved,
+                    mMpmc.sum(reserved, availToRead))) {
+                break;
+            }
+            // Another reader reserved first.
+            continue;
+        }
+        if (count == 0 || timeout == NULL ||
+                (timeout->tv_sec == 0 && timeout->tv_nsec == 0)) {
+            break;
+        }
+        err = mMpmc.wait(mMpmc.mWriterRear, mMpmc.mWriterRearSync, rear, timeout);
+        if (err == -EWOULDBLOCK && retries-- > 0) {
+            // Benign race condition with a writer, try to load the index again.
+            continue;
+        }
+        if (err == 0 && timeout->tv_sec == LONG_MAX) {
+            // Another reader may have reserved the frames first, so keep waiting.
+            continue;
+        }
+        timeout = NULL;
+    }
+    if (iovec != NULL) {
+        mMpmc.slice(reserved, availToRead, iovec);
+        mReserved = reserved;
+        mObtained = availToRead;
+    }
+    return availToRead > 0 ? availToRead : err;
+}
+
+void audio_utils_fifo_multi_reader::release(size_t count)
+        __attribute__((no_sanitize("integer")))
+{
+    if (count > mObtained) {
+        ALOGE("%s(count=%zu) > mObtained=%u", __func__, count, mObtained);
+        mMpmc.shutdown();
+        return;
+    }
+    if (mObtained == 0) {
+        return;
+    }
+    mMpmc.commit(*mMpmc.mThrottleFront, mMpmc.mThrottleFrontSync,
+            mReserved, mMpmc.sum(mReserved, mObtained));
+    // Discarded frames are included, as for the lost and flushed frames of an ordinary reader.
+    mTotalReleased += mObtained;
+    mObtained = 0;
+}
+
+ssize_t audio_utils_fifo_multi_reader::available()
+{
+    // iovec == NULL is not part of the public API, but internally it means don't reserve
+    return obtain(NULL /*iovec*/, SIZE_MAX /*count*/, NULL /*timeout*/);
+}
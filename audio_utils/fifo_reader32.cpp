@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include <audio_utils/fifo_reader32.h>
+#include "private/fifo_words.h"
+
+audio_utils_fifo_reader32::audio_utils_fifo_reader32(audio_utils_fifo& fifo,
+        bool throttlesWriter) :
+    // As for the ordinary reader, a non-throttling reader starts at the writer's current rear.
+    mLocalFront(throttlesWriter ? 0 : fifo.mWriterRear.loadConsume()), mAvailable(0),
+    mFrameCountP2(fifo.mFrameCountP2), mBuffer((const int32_t *) fifo.mBuffer),
+    mWriterRear(fifo.mWriterRear), mThrottleFront(throttlesWriter ? fifo.mThrottleFront : NULL),
+    mNonTemporalFrames(0), mTotalLost(0)
+{
+    if (fifo.mFrameSize != sizeof(int32_t) || fifo.mFudgeFactor != 0 ||
+            ((size_t) mBuffer & ((sizeof(int32_t) - 1))) != 0) {
+        abort();
+    }
+}
+
+audio_utils_fifo_reader32::~audio_utils_fifo_reader32()
+{
+}
+
+uint32_t audio_utils_fifo_reader32::loadAcquire()
+        __attribute__((no_sanitize("integer")))     // rear - mLocalFront can wrap
+{
+    const uint32_t rear = mWriterRear.loadAcquire();
+    uint32_t filled = rear - mLocalFront;
+    if (filled > mFrameCountP2) {
+        // Catch up with the writer, but preserve the still valid frames in buffer.
+        mTotalLost += filled - mFrameCountP2;
+        mLocalFront = rear - mFrameCountP2;
+        filled = mFrameCountP2;
+    }
+    mAvailable = filled;
+    return filled;
+}
+
+uint32_t audio_utils_fifo_reader32::read(int32_t *buffer, uint32_t count)
+        __attribute__((no_sanitize("integer")))     // mLocalFront += can wrap
+{
+    uint32_t availToRead = mAvailable;
+    if (availToRead > count) {
+        availToRead = count;
+    }
+    uint32_t frontOffset = mLocalFront & (mFrameCountP2 - 1);
+    uint32_t part1 = mFrameCountP2 - frontOffset;
+    if (part1 > availToRead) {
+        part1 = availToRead;
+    }
+    uint32_t part2 = availToRead - part1;
+    if (mNonTemporalFrames > 0 && availToRead >= mNonTemporalFrames) {
+        memcpyWordsNonTemporal(buffer, &mBuffer[frontOffset], part1);
+        memcpyWordsNonTemporal(&buffer[part1], &mBuffer[0], part2);
+    } else {
+        memcpyWords(buffer, &mBuffer[frontOffset], part1);
+        memcpyWords(&buffer[part1], &mBuffer[0], part2);
+    }
+    mLocalFront += availToRead;
+    mAvailable -= availToRead;
+    return availToRead;
+}
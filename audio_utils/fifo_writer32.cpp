@@ -18,32 +18,12 @@
 #include <stdlib.h>
 #include <string.h>
 
-// TODO templatize int32_t
-
 #include <audio_utils/fifo_writer32.h>
-
-static inline void memcpyWords(int32_t *dst, const int32_t *src, uint32_t count)
-{
-    switch (count) {
-    case 0: break;
-// TODO templatize here also, but first confirm no performance regression compared to current
-#define _(n) \
-    case n: { \
-        struct s##n { int32_t a[n]; }; \
-        *(struct s##n *)dst = *(const struct s##n *)src; \
-        break; \
-    }
-    _(1) _(2) _(3) _(4) _(5) _(6) _(7) _(8) _(9) _(10) _(11) _(12) _(13) _(14) _(15) _(16)
-#undef _
-    default:
-        memcpy(dst, src, count * sizeof(int32_t));
-        break;
-    }
-}
+#include "private/fifo_words.h"
 
 audio_utils_fifo_writer32::audio_utils_fifo_writer32(audio_utils_fifo& fifo) :
     mLocalRear(0), mFrameCountP2(fifo.mFrameCountP2), mBuffer((int32_t *) fifo.mBuffer),
-    mWriterRear(fifo.mWriterRear)
+    mWriterRear(fifo.mWriterRear), mNonTemporalFrames(0)
 {
     if (fifo.mFrameSize != sizeof(int32_t) || fifo.mFudgeFactor != 0 ||
             ((size_t) mBuffer & ((sizeof(int32_t) - 1))) != 0) {
@@ -67,9 +47,14 @@ void audio_utils_fifo_writer32::write(const int32_t *buffer, uint32_t count)
     if (part1 >  availToWrite) {
         part1 = availToWrite;
     }
-    memcpyWords(&mBuffer[rearOffset], buffer, part1);
     // TODO apply this simplification to other copies of the code
     uint32_t part2 = availToWrite - part1;
-    memcpyWords(&mBuffer[0], &buffer[part1], part2);
+    if (mNonTemporalFrames > 0 && availToWrite >= mNonTemporalFrames) {
+        memcpyWordsNonTemporal(&mBuffer[rearOffset], buffer, part1);
+        memcpyWordsNonTemporal(&mBuffer[0], &buffer[part1], part2);
+    } else {
+        memcpyWords(&mBuffer[rearOffset], buffer, part1);
+        memcpyWords(&mBuffer[0], &buffer[part1], part2);
+    }
     mLocalRear += availToWrite;
 }
@@ -22,136 +22,121 @@
 #include <audio_utils/format.h>
 #include <audio_utils/primitives.h>
 
+/* Adapts memcpy_to_<dst>_from_<src>() to memcpy_by_audio_format_function_t. */
+#define MEMCPY_BY_FORMAT(dst_name, dst_type, src_name, src_type) \
+static void memcpy_by_format_##dst_name##_from_##src_name( \
+        void *dst, const void *src, size_t count) \
+{ \
+    memcpy_to_##dst_name##_from_##src_name((dst_type *)dst, (const src_type *)src, count); \
+}
+
+MEMCPY_BY_FORMAT(i16, int16_t, float, float)
+MEMCPY_BY_FORMAT(i16, int16_t, u8, uint8_t)
+MEMCPY_BY_FORMAT(i16, int16_t, p24, uint8_t)
+MEMCPY_BY_FORMAT(i16, int16_t, i32, int32_t)
+MEMCPY_BY_FORMAT(i16, int16_t, q8_23, int32_t)
+MEMCPY_BY_FORMAT(float, float, i16, int16_t)
+MEMCPY_BY_FORMAT(float, float, u8, uint8_t)
+MEMCPY_BY_FORMAT(float, float, p24, uint8_t)
+MEMCPY_BY_FORMAT(float, float, i32, int32_t)
+MEMCPY_BY_FORMAT(float, float, q8_23, int32_t)
+MEMCPY_BY_FORMAT(u8, uint8_t, i16, int16_t)
+MEMCPY_BY_FORMAT(u8, uint8_t, float, float)
+MEMCPY_BY_FORMAT(p24, uint8_t, i16, int16_t)
+MEMCPY_BY_FORMAT(p24, uint8_t, float, float)
+MEMCPY_BY_FORMAT(p24, uint8_t, i32, int32_t)
+MEMCPY_BY_FORMAT(p24, uint8_t, q8_23, int32_t)
+MEMCPY_BY_FORMAT(i32, int32_t, i16, int16_t)
+MEMCPY_BY_FORMAT(i32, int32_t, float, float)
+MEMCPY_BY_FORMAT(i32, int32_t, p24, uint8_t)
+MEMCPY_BY_FORMAT(q8_23, int32_t, i16, int16_t)
+MEMCPY_BY_FORMAT(q8_23, int32_t, p24, uint8_t)
+
+static void memcpy_by_format_q8_23_from_float(void *dst, const void *src, size_t count)
+{
+    memcpy_to_q8_23_from_float_with_clamp((int32_t *)dst, (const float *)src, count);
+}
+
+/* A straight copy between identical formats, of samples of the given size. */
+#define MEMCPY_BY_FORMAT_COPY(size) \
+static void memcpy_by_format_copy_##size(void *dst, const void *src, size_t count) \
+{ \
+    if (dst != src) { \
+        /* TODO: should assert if memory regions overlap. */ \
+        memcpy(dst, src, count * size); \
+    } \
+}
+
+MEMCPY_BY_FORMAT_COPY(1)
+MEMCPY_BY_FORMAT_COPY(2)
+MEMCPY_BY_FORMAT_COPY(3)
+MEMCPY_BY_FORMAT_COPY(4)
+
+/* The linear PCM formats are small consecutive values, used as indices into the table. */
+#define MEMCPY_BY_FORMAT_TABLE_SIZE (AUDIO_FORMAT_PCM_24_BIT_PACKED + 1)
+
+static const memcpy_by_audio_format_function_t
+        memcpy_by_format_table[MEMCPY_BY_FORMAT_TABLE_SIZE][MEMCPY_BY_FORMAT_TABLE_SIZE] = {
+    [AUDIO_FORMAT_PCM_16_BIT] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_copy_2,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_i16_from_float,
+        [AUDIO_FORMAT_PCM_8_BIT] = memcpy_by_format_i16_from_u8,
+        [AUDIO_FORMAT_PCM_24_BIT_PACKED] = memcpy_by_format_i16_from_p24,
+        [AUDIO_FORMAT_PCM_32_BIT] = memcpy_by_format_i16_from_i32,
+        [AUDIO_FORMAT_PCM_8_24_BIT] = memcpy_by_format_i16_from_q8_23,
+    },
+    [AUDIO_FORMAT_PCM_FLOAT] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_float_from_i16,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_copy_4,
+        [AUDIO_FORMAT_PCM_8_BIT] = memcpy_by_format_float_from_u8,
+        [AUDIO_FORMAT_PCM_24_BIT_PACKED] = memcpy_by_format_float_from_p24,
+        [AUDIO_FORMAT_PCM_32_BIT] = memcpy_by_format_float_from_i32,
+        [AUDIO_FORMAT_PCM_8_24_BIT] = memcpy_by_format_float_from_q8_23,
+    },
+    [AUDIO_FORMAT_PCM_8_BIT] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_u8_from_i16,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_u8_from_float,
+        [AUDIO_FORMAT_PCM_8_BIT] = memcpy_by_format_copy_1,
+    },
+    [AUDIO_FORMAT_PCM_24_BIT_PACKED] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_p24_from_i16,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_p24_from_float,
+        [AUDIO_FORMAT_PCM_24_BIT_PACKED] = memcpy_by_format_copy_3,
+        [AUDIO_FORMAT_PCM_32_BIT] = memcpy_by_format_p24_from_i32,
+        [AUDIO_FORMAT_PCM_8_24_BIT] = memcpy_by_format_p24_from_q8_23,
+    },
+    [AUDIO_FORMAT_PCM_32_BIT] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_i32_from_i16,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_i32_from_float,
+        [AUDIO_FORMAT_PCM_24_BIT_PACKED] = memcpy_by_format_i32_from_p24,
+        [AUDIO_FORMAT_PCM_32_BIT] = memcpy_by_format_copy_4,
+    },
+    [AUDIO_FORMAT_PCM_8_24_BIT] = {
+        [AUDIO_FORMAT_PCM_16_BIT] = memcpy_by_format_q8_23_from_i16,
+        [AUDIO_FORMAT_PCM_FLOAT] = memcpy_by_format_q8_23_from_float,
+        [AUDIO_FORMAT_PCM_24_BIT_PACKED] = memcpy_by_format_q8_23_from_p24,
+        [AUDIO_FORMAT_PCM_8_24_BIT] = memcpy_by_format_copy_4,
+    },
+};
+
+memcpy_by_audio_format_function_t memcpy_by_audio_format_get_function(
+        audio_format_t dst_format, audio_format_t src_format)
+{
+    if ((uint32_t)dst_format >= MEMCPY_BY_FORMAT_TABLE_SIZE
+            || (uint32_t)src_format >= MEMCPY_BY_FORMAT_TABLE_SIZE) {
+        return NULL;
+    }
+    return memcpy_by_format_table[dst_format][src_format];
+}
+
 void memcpy_by_audio_format(void *dst, audio_format_t dst_format,
         const void *src, audio_format_t src_format, size_t count)
 {
-    /* default cases for error falls through to fatal log below. */
-    if (dst_format == src_format) {
-        switch (dst_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-        case AUDIO_FORMAT_PCM_FLOAT:
-        case AUDIO_FORMAT_PCM_8_BIT:
-        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
-        case AUDIO_FORMAT_PCM_32_BIT:
-        case AUDIO_FORMAT_PCM_8_24_BIT:
-            if (dst != src) {
-                // TODO: should assert if memory regions overlap.
-                memcpy(dst, src, count * audio_bytes_per_sample(dst_format));
-            }
-            return;
-        default:
-            break;
-        }
-    }
-    switch (dst_format) {
-    case AUDIO_FORMAT_PCM_16_BIT:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_FLOAT:
-            memcpy_to_i16_from_float((int16_t*)dst, (float*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_8_BIT:
-            memcpy_to_i16_from_u8((int16_t*)dst, (uint8_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
-            memcpy_to_i16_from_p24((int16_t*)dst, (uint8_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_32_BIT:
-            memcpy_to_i16_from_i32((int16_t*)dst, (int32_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_8_24_BIT:
-            memcpy_to_i16_from_q8_23((int16_t*)dst, (int32_t*)src, count);
-            return;
-        default:
-            break;
-        }
-        break;
-    case AUDIO_FORMAT_PCM_FLOAT:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-            memcpy_to_float_from_i16((float*)dst, (int16_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_8_BIT:
-            memcpy_to_float_from_u8((float*)dst, (uint8_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
-            memcpy_to_float_from_p24((float*)dst, (uint8_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_32_BIT:
-            memcpy_to_float_from_i32((float*)dst, (int32_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_8_24_BIT:
-            memcpy_to_float_from_q8_23((float*)dst, (int32_t*)src, count);
-            return;
-        default:
-            break;
-        }
-        break;
-    case AUDIO_FORMAT_PCM_8_BIT:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-            memcpy_to_u8_from_i16((uint8_t*)dst, (int16_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_FLOAT:
-            memcpy_to_u8_from_float((uint8_t*)dst, (float*)src, count);
-            return;
-        default:
-            break;
-        }
-        break;
-    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-            memcpy_to_p24_from_i16((uint8_t*)dst, (int16_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_FLOAT:
-            memcpy_to_p24_from_float((uint8_t*)dst, (float*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_32_BIT:
-            memcpy_to_p24_from_i32((uint8_t*)dst, (int32_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_8_24_BIT:
-            memcpy_to_p24_from_q8_23((uint8_t*)dst, (int32_t*)src, count);
-            return;
-        default:
-            break;
-        }
-        break;
-    case AUDIO_FORMAT_PCM_32_BIT:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-            memcpy_to_i32_from_i16((int32_t*)dst, (int16_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_FLOAT:
-            memcpy_to_i32_from_float((int32_t*)dst, (float*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_24_BIT_PACKED:
-            memcpy_to_i32_from_p24((int32_t*)dst, (uint8_t *)src, count);
-            return;
-        default:
-            break;
-        }
-        break;
-    case AUDIO_FORMAT_PCM_8_24_BIT:
-        switch (src_format) {
-        case AUDIO_FORMAT_PCM_16_BIT:
-            memcpy_to_q8_23_from_i16((int32_t*)dst, (int16_t*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_FLOAT:
-            memcpy_to_q8_23_from_float_with_clamp((int32_t*)dst, (float*)src, count);
-            return;
-        case AUDIO_FORMAT_PCM_24_BIT_PACKED: {
-            memcpy_to_q8_23_from_p24((int32_t *)dst, (uint8_t *)src, count);
-            return;
-        }
-        default:
-            break;
-        }
-        break;
-    default:
-        break;
-    }
-    LOG_ALWAYS_FATAL("invalid src format %#x for dst format %#x",
+    const memcpy_by_audio_format_function_t function =
+            memcpy_by_audio_format_get_function(dst_format, src_format);
+    LOG_ALWAYS_FATAL_IF(function == NULL, "invalid src format %#x for dst format %#x",
             src_format, dst_format);
+    function(dst, src, count);
 }
 
 size_t memcpy_by_index_array_initialization_from_channel_mask(int8_t *idxary, size_t arysize,
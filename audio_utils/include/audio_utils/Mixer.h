@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_UTILS_MIXER_H
+#define ANDROID_AUDIO_UTILS_MIXER_H
+
+#include <string>
+#include <system/audio.h>
+#include <vector>
+
+#include <audio_utils/primitives.h>
+
+namespace android::audio_utils {
+
+/**
+ * \brief Mixes tracks of linear PCM audio into a single output buffer.
+ *
+ * Each track has its own format and channel mask, and a volume which may be ramped.
+ * Tracks are mixed into a float accumulator one tile of frames at a time, the tile
+ * being small enough to stay in the data cache while every track is added to it,
+ * and the result is converted to the output format. Integer output formats are clamped;
+ * a float output is not, and may exceed the range [-1.0, 1.0].
+ *
+ * Memory is allocated only by the constructor and addTrack(): setBuffer(), setVolume()
+ * and process() do not allocate and do not block, so they may be called from a
+ * real-time thread. The class is not thread-safe; use by multiple threads
+ * will require caller locking.
+ */
+class Mixer {
+public:
+    /**
+     * \brief Creates a mixer.
+     *
+     * \param format      the output format, any linear PCM format supported by
+     *                    memcpy_by_audio_format() for conversion from AUDIO_FORMAT_PCM_FLOAT.
+     * \param channelMask the output channel mask, either a position or an index mask.
+     * \param maxTracks   the maximum number of tracks which may be added.
+     */
+    Mixer(audio_format_t format, audio_channel_mask_t channelMask, size_t maxTracks);
+
+    /**
+     * \brief Adds a track, initially without a buffer and with a volume of 1.f.
+     *
+     * Channels are matched with the output by position, or by index for index masks,
+     * as for memcpy_by_index_array_initialization_from_channel_mask(), except that a mono
+     * track plays on both front left and front right if the output has them.
+     *
+     * \param format      the track format, any linear PCM format supported by
+     *                    memcpy_by_audio_format() for conversion to AUDIO_FORMAT_PCM_FLOAT.
+     * \param channelMask the track channel mask, either a position or an index mask.
+     *
+     * \return
+     *   the track handle, a nonnegative integer, on success,
+     *   -EINVAL if the format or channel mask is not supported,
+     *   -ENOSPC if maxTracks tracks have already been added.
+     */
+    int addTrack(audio_format_t format, audio_channel_mask_t channelMask);
+
+    /**
+     * \brief Removes a track, whose handle may then be reused by addTrack().
+     *
+     * \param track the handle returned by addTrack().
+     * \return 0 on success, or -EINVAL if the track handle is not valid.
+     */
+    int removeTrack(int track);
+
+    /**
+     * \brief Sets the buffer of track data read by the following process().
+     *
+     * \param track  the handle returned by addTrack().
+     * \param buffer the track data, which must hold at least as many frames as
+     *               are processed, or nullptr to skip the track.
+     * \return 0 on success, or -EINVAL if the track handle is not valid.
+     */
+    int setBuffer(int track, const void *buffer);
+
+    /**
+     * \brief Sets the volume of a track.
+     *
+     * \param track      the handle returned by addTrack().
+     * \param volume     the linear gain applied to the track.
+     * \param rampFrames the number of frames over which the volume changes linearly from
+     *                   the current volume, which may be the middle of a previous ramp.
+     *                   0 changes the volume immediately.
+     * \return 0 on success, or -EINVAL if the track handle is not valid.
+     */
+    int setVolume(int track, float volume, size_t rampFrames = 0);
+
+    /**
+     * \brief Mixes frames of the tracks into the output buffer.
+     *
+     * The output buffer is overwritten, rather than added to.
+     *
+     * \param buffer the output buffer, in the output format and channel mask.
+     * \param frames the number of frames to mix.
+     */
+    void process(void *buffer, size_t frames);
+
+    /**
+     * \return the number of frames mixed at a time, which is also the granularity
+     *         at which tracks are read.
+     */
+    size_t getTileFrames() const { return mTileFrames; }
+
+    /**
+     * \brief Creates a std::string representation of Mixer object for logging.
+     *
+     * \return string representation of Mixer object
+     */
+    std::string toString() const;
+
+private:
+    struct Track {
+        bool active = false;
+        audio_format_t format = AUDIO_FORMAT_INVALID;
+        audio_channel_mask_t channelMask = AUDIO_CHANNEL_NONE;
+        uint32_t channelCount = 0;
+        size_t frameSize = 0;
+        bool remap = false;                     // channels differ from the output.
+        int8_t idxary[AUDIO_CHANNEL_COUNT_MAX]; // per output channel, the track channel or -1.
+        memcpy_by_index_array_plan_t remapPlan; // idxary for float samples, if remap.
+        const void *buffer = nullptr;
+
+        float volume = 1.f;                     // volume when not ramping, and ramp target.
+        float rampIncrement = 0.f;              // volume change per frame while ramping.
+        size_t rampFrames = 0;                  // remaining frames of the ramp.
+    };
+
+    bool isValidTrack(int track) const {
+        return track >= 0 && (size_t)track < mTracks.size() && mTracks[track].active;
+    }
+
+    // Adds frames of the track from src to mAccumulator.
+    void mixTrack(Track &track, const uint8_t *src, size_t frames);
+
+    const audio_format_t mFormat;
+    const audio_channel_mask_t mChannelMask;
+    const uint32_t mChannelCount;
+    const size_t mFrameSize;
+    const size_t mTileFrames;
+
+    std::vector<Track> mTracks;      // preallocated to maxTracks, so handles are stable.
+    std::vector<float> mAccumulator; // mTileFrames of output channels.
+    std::vector<float> mConverted;   // mTileFrames of output channels, in float.
+    std::vector<float> mScratch;     // mTileFrames of the largest track channel count.
+};
+
+} // namespace android::audio_utils
+
+#endif // !ANDROID_AUDIO_UTILS_MIXER_H
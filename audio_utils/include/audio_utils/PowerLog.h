@@ -19,8 +19,10 @@
 
 #ifdef __cplusplus
 
+#include <memory>
 #include <mutex>
 #include <vector>
+#include <audio_utils/fifo.h>
 #include <system/audio.h>
 #include <utils/Errors.h>
 
@@ -33,13 +35,24 @@ namespace android {
  * and grouped by signals consisting of consecutive non-zero energy bins.
  * The sum energy in dB of each signal is computed for comparison purposes.
  *
- * No distinction is made between channels in an audio frame; they are all
- * summed together for energy purposes.
+ * By default no distinction is made between channels in an audio frame; they are all
+ * summed together for energy purposes.  Optionally each bin also stores the energy of
+ * each channel, and the energy in a few frequency bands, which are only exported by the
+ * binary dump.
  *
  * The public methods are internally protected by a mutex to be thread-safe.
+ *
+ * In lock-free mode, log() instead never takes the mutex, blocks or allocates, and so is
+ * suitable for a real-time thread, but it must then only be called by a single thread.
+ * It writes each completed bin into a single-producer ring, which the dump methods drain
+ * into the history under the mutex.  If the dump methods are not called often enough for
+ * the ring, the oldest bins are lost, as they would have been from the history.
  */
 class PowerLog {
 public:
+    /** Maximum number of frequency bands. */
+    static constexpr uint32_t kMaxBands = 8;
+
     /**
      * \brief Creates a PowerLog object.
      *
@@ -50,12 +63,23 @@ public:
      *                          else the constructor will abort.
      * \param entries           total number of energy entries "bins" to use.
      * \param framesPerEntry    total number of audio frames used in each entry.
+     * \param lockFree          whether log() is lock-free, see above.
+     * \param perChannel        whether each bin also stores the energy of each channel.
+     * \param bands             number of frequency bands whose energy each bin also stores,
+     *                          from 0 to kMaxBands.  The bands are logarithmically spaced
+     *                          up to half the sample rate, and their energies are estimated
+     *                          from the spectrum of the channels mixed to mono, computed by
+     *                          fixed_fft_real() on successive windows of kFftFrames frames.
+     *                          The energies of the bands of a bin sum to its energy.
      */
     PowerLog(uint32_t sampleRate,
             uint32_t channelCount,
             audio_format_t format,
             size_t entries,
-            size_t framesPerEntry);
+            size_t framesPerEntry,
+            bool lockFree = false,
+            bool perChannel = false,
+            uint32_t bands = 0);
 
     /**
      * \brief Adds new audio data to the power log.
@@ -87,18 +111,117 @@ public:
      */
     status_t dump(int fd, const char *prefix = "", size_t lines = 0, int64_t limitNs = 0) const;
 
+    /**
+     * \brief Dumps the log in a compact binary format, typically an order of magnitude
+     * smaller than dumpToString(), including the energy of each channel and band if enabled.
+     *
+     * All integers are LEB128 varints, unsigned unless stated, and signed integers are
+     * zigzag encoded.  Powers are in units of 0.1 dB, like the text dump, and are limited
+     * to kBinaryMinPower, which also stands for no energy.  The format is:
+     *
+     *   the 4 bytes 'P', 'W', 'R', kBinaryVersion;
+     *   sampleRate, channelCount, framesPerEntry, perChannel (0 or 1), bands;
+     *   the count of bins that follow, oldest first, each one:
+     *     0 for a bin of zero energy, which terminates a signal, and nothing else; or
+     *     1 + (zigzag(power - previous power) << 1 | has time), where the previous power
+     *       is that of the previous non-zero bin, or 0, and then:
+     *     if has time, signed (time - predicted time) in ms, else the time is the predicted
+     *       time, which is the time of the previous non-zero bin, or 0, plus the duration of
+     *       framesPerEntry frames in integer ns;
+     *     if perChannel, for each channel, signed (power - previous power of the channel),
+     *       where the power of a channel is normalized by framesPerEntry;
+     *     for each band, signed (power - previous power of the band), where the power of a
+     *       band is normalized like the power of the bin.
+     *
+     * \param limitNs           limit dump to data more recent than limitNs (0 disables).
+     * \return the binary dump.
+     */
+    std::vector<uint8_t> dumpToBinary(int64_t limitNs = 0) const;
+
+    /**
+     * \brief Dumps the log in the binary format of dumpToBinary() to a raw file descriptor.
+     *
+     * \param fd                file descriptor to use.
+     * \param limitNs           limit dump to data more recent than limitNs (0 disables).
+     * \return
+     *   NO_ERROR on success or a negative number (-errno) on failure of write().
+     */
+    status_t dumpBinary(int fd, int64_t limitNs = 0) const;
+
+    /** Version of the format of dumpToBinary(). */
+    static constexpr uint8_t kBinaryVersion = 1;
+
+    /** Lowest power in the binary dump, in units of 0.1 dB. */
+    static constexpr int32_t kBinaryMinPower = -2000;
+
+    /** Frames per window of the spectrum used to estimate the energy of the bands. */
+    static constexpr size_t kFftFrames = 256;
+
 private:
+    // The header of an energy bin as written into the ring in lock-free mode,
+    // followed by its mDetailCount details.
+    struct Entry {
+        int64_t mTime;  // real time ns
+        float mEnergy;
+    };
+
+    // Number of frames of the ring read at a time by drain().
+    static constexpr size_t kDrainFrames = 32;
+
+    // Stores a completed bin, in the history or else in the ring.
+    // details is mDetailCount energies: for each channel if mPerChannel, then for each band.
+    void append(int64_t time, float energy, const float *details);
+
+    // Stores a bin in the history.
+    void appendHistory(int64_t time, float energy, const float *details) const;
+
+    // Moves the bins from the ring into the history, in lock-free mode.  Called with mLock held.
+    void drain() const;
+
+    // Adds the spectrum of frames to the band sums of the current bin.
+    void analyzeBands(const void *buffer, size_t frames);
+
+    // Adds the spectrum of the window in mFftSamples to the band sums of the current bin.
+    void analyzeWindow();
+
     mutable std::mutex mLock;     // monitor mutex
     int64_t mCurrentTime;         // time of first frame in buffer
     float mCurrentEnergy;         // local energy accumulation
     size_t mCurrentFrames;        // number of frames in the energy
-    size_t mIdx;                  // next usable index in mEntries
+    mutable size_t mIdx;          // next usable index in mEntries
     size_t mConsecutiveZeroes;    // current run of consecutive zero entries
     const uint32_t mSampleRate;   // audio data sample rate
     const uint32_t mChannelCount; // audio data channel count
     const audio_format_t mFormat; // audio data format
     const size_t mFramesPerEntry; // number of audio frames per entry
-    std::vector<std::pair<int64_t /* real time ns */, float /* energy */>> mEntries;
+    // The history, mutable as the const dump methods drain the ring into it in lock-free mode.
+    mutable std::vector<std::pair<int64_t /* real time ns */, float /* energy */>> mEntries;
+    mutable size_t mEntryCount;   // number of entries of mEntries in use
+
+    // Only used in lock-free mode: the ring of bins written by log() and read by drain().
+    const bool mLockFree;
+    std::unique_ptr<uint64_t[]> mRingBuffer;
+    std::unique_ptr<audio_utils_fifo> mRing;
+    std::unique_ptr<audio_utils_fifo_writer> mRingWriter;
+    std::unique_ptr<audio_utils_fifo_reader> mRingReader;
+    std::vector<uint64_t> mRingFrame;           // a frame written by log()
+    mutable std::vector<uint64_t> mDrainFrames; // frames read by drain()
+
+    // Only used for the energy of each channel or band.
+    const bool mPerChannel;
+    const uint32_t mBands;
+    const size_t mDetailCount;      // channels if mPerChannel, plus bands
+    std::vector<float> mCurrentDetails; // local energy accumulation for each channel
+                                    // then sum of the spectrum over each band
+    std::vector<float> mLastBandShares; // shares of the bands in the most recent spectrum
+    mutable std::vector<float> mDetails; // mDetailCount energies per entry of mEntries
+    std::vector<float> mChannelEnergies; // energy of each channel of a buffer
+    std::vector<float> mScratch;    // for a window of samples converted to float
+    std::vector<float> mWindow;     // Hann window
+    std::vector<float> mFftSamples; // current window mixed to mono
+    size_t mFftFrames;              // number of frames in mFftSamples
+    std::vector<int32_t> mFft;      // input and output of fixed_fft_real()
+    uint32_t mBandEdges[kMaxBands + 1]; // first FFT bin of each band, and one past the last
 };
 
 } // namespace android
@@ -17,15 +17,22 @@
 #ifndef ANDROID_AUDIO_SIMPLE_LOG_H
 #define ANDROID_AUDIO_SIMPLE_LOG_H
 
+#include <algorithm>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <sstream>
+#include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <string>
 #include <unistd.h>
 #include <utils/Errors.h>
 
 #include <audio_utils/clock.h>
+#include <audio_utils/fifo.h>
+#include <audio_utils/roundup.h>
 
 namespace android {
 
@@ -39,6 +46,20 @@ namespace android {
  *
  * Formatted logs by log() and logv() will be truncated at kMaxStringLength - 1
  * due to null termination. logs() does not have a string length limitation.
+ *
+ * In real-time mode, log(), logv() and logs() neither lock nor allocate, and may be called
+ * from a sched_fifo thread, though only by one thread at a time.  They write the time,
+ * the format string pointer and the raw arguments into a preallocated ring, and the
+ * formatting is deferred to the dump methods, which move the ring into the history.
+ * Hence in this mode:
+ * - The format string must outlive the log, as for a string literal.
+ * - Strings of %s arguments are copied, but the strings of a line are together
+ *   truncated at kRtStringBytes - 1, and logs() is truncated likewise.
+ * - At most kRtMaxArgs arguments are kept, counting those for '*' widths and precisions.
+ *   A line is cut at the first conversion without its argument, or at the first conversion
+ *   not supported, such as %ls.  A long double is logged as a double.
+ * - If the log is not dumped often enough, the oldest lines of the ring are overwritten,
+ *   but as the ring is longer than the history, they would have been dropped from it anyway.
  */
 
 class SimpleLog {
@@ -47,10 +68,23 @@ public:
      * \brief Creates a SimpleLog object.
      *
      * \param maxLogLines the maximum number of log lines.
+     * \param realTime    whether logging neither locks nor allocates, see above.
      */
-    explicit SimpleLog(size_t maxLogLines = kDefaultMaxLogLines)
+    explicit SimpleLog(size_t maxLogLines = kDefaultMaxLogLines, bool realTime = false)
         : mMaxLogLines(maxLogLines)
+        , mRealTime(realTime)
     {
+        if (mRealTime) {
+            // More than the history, as drainLocked() discards the oldest line of a full
+            // ring, which the log methods may be overwriting.
+            const uint32_t frameCount = roundup((unsigned) maxLogLines + 1);
+            mRingBuffer.reset(new RtEntry[frameCount]);
+            mRing.reset(new audio_utils_fifo(frameCount, sizeof(RtEntry), mRingBuffer.get(),
+                    false /*throttlesWriter*/));
+            mRingWriter.reset(new audio_utils_fifo_writer(*mRing));
+            mRingReader.reset(new audio_utils_fifo_reader(*mRing, false /*throttlesWriter*/));
+            mDrainEntries.reset(new RtEntry[kDrainEntries]);
+        }
     }
 
     /**
@@ -104,6 +138,11 @@ public:
      */
     void logv(int64_t nowNs, const char *format, va_list args)
     {
+        if (mRealTime) {
+            logRt(nowNs, format, args);
+            return;
+        }
+
         // format to buffer
         char buffer[kMaxStringLength];
         int length = vsnprintf(buffer, sizeof(buffer), format, args);
@@ -134,15 +173,17 @@ public:
     template <typename U>
     void logs(int64_t nowNs, U&& buffer)
     {
+        if (mRealTime) {
+            logRtString(nowNs, cString(buffer));
+            return;
+        }
+
         // store in circular array
         std::lock_guard<std::mutex> guard(mLock);
         if (nowNs == -1) {
             nowNs = audio_utils_get_real_time_ns();
         }
-        mLog.emplace_back(nowNs, std::forward<U>(buffer));
-        if (mLog.size() > mMaxLogLines) {
-            mLog.pop_front();
-        }
+        appendLocked(nowNs, std::forward<U>(buffer));
     }
 
     /**
@@ -156,12 +197,12 @@ public:
      */
     std::string dumpToString(const char *prefix = "", size_t lines = 0, int64_t limitNs = 0) const
     {
+        std::stringstream ss;
+        std::lock_guard<std::mutex> guard(mLock);
+        drainLocked();
         if (lines == 0) {
             lines = mLog.size();
         }
-
-        std::stringstream ss;
-        std::lock_guard<std::mutex> guard(mLock);
         auto it = mLog.begin();
 
         // Note: this restricts the lines before checking the time constraint.
@@ -199,13 +240,106 @@ public:
         return NO_ERROR;
     }
 
+    static const size_t kRtMaxArgs = 8;           // maximum arguments of a real-time line
+    static const size_t kRtStringBytes = 64;      // maximum string bytes of a real-time line
+
 private:
+    // A line logged in real-time mode.
+    struct RtEntry {
+        int64_t mTime;
+        const char *mFormat;
+        uint32_t mArgCount;
+        uint32_t mStringBytes;                    // bytes of mStrings in use
+        union {
+            int64_t mSigned;                      // also for '*' widths and precisions
+            uint64_t mUnsigned;
+            double mDouble;
+            const void *mPointer;
+            uint32_t mStringOffset;               // of the null terminated string in mStrings
+        } mArgs[kRtMaxArgs];
+        char mStrings[kRtStringBytes];
+    };
+
+    // The kinds of argument of the conversions supported in real-time mode.
+    enum RtKind {
+        RT_KIND_NONE,                             // "%%"
+        RT_KIND_SIGNED,
+        RT_KIND_UNSIGNED,
+        RT_KIND_DOUBLE,
+        RT_KIND_STRING,
+        RT_KIND_POINTER,
+        RT_KIND_COUNT,                            // "%n", whose argument is ignored
+        RT_KIND_UNSUPPORTED,
+    };
+
+    // A conversion specification of a format string.
+    struct RtSpec {
+        const char *mStart;                       // the '%'
+        const char *mLength;                      // the length modifier, if any
+        const char *mEnd;                         // one past the conversion specifier
+        char mLengthModifier;                     // 0, 'H' for hh, 'h', 'l', 'q' for ll, 'j',
+                                                  // 'z', 't' or 'L'
+        char mConversion;
+        uint32_t mStars;                          // number of '*' widths and precisions
+        int mPrecision;                           // -1 if none, or given by '*'
+        RtKind mKind;
+    };
+
+    static const size_t kDrainEntries = 16;       // entries moved at a time by drainLocked()
+    static const size_t kMaxSpecLength = 32;      // maximum conversion specification length
+
+    static const char *cString(const char *s) { return s; }
+    static const char *cString(const std::string &s) { return s.c_str(); }
+
+    template <typename U>
+    void appendLocked(int64_t nowNs, U&& buffer) const
+    {
+        mLog.emplace_back(nowNs, std::forward<U>(buffer));
+        if (mLog.size() > mMaxLogLines) {
+            mLog.pop_front();
+        }
+    }
+
+    // Parses the conversion specification at format, which points to a '%'.
+    static void parseSpec(const char *format, RtSpec *spec);
+
+    // Reads an integer argument of the given length modifier, converted as by vsnprintf().
+    static int64_t readSigned(char lengthModifier, va_list *args);
+    static uint64_t readUnsigned(char lengthModifier, va_list *args);
+
+    // Copies s into the strings of entry, up to maxLength characters, returning its offset.
+    static uint32_t copyString(RtEntry *entry, const char *s, size_t maxLength);
+
+    // Writes a line to the ring, without formatting it.
+    void logRt(int64_t nowNs, const char *format, va_list args);
+    void logRtString(int64_t nowNs, const char *s);
+
+    // Formats a single conversion by snprintf(), with its '*' arguments.
+    template <typename T>
+    static void formatArg(std::string *out, const char *spec, uint32_t stars,
+            const int *starArgs, T value);
+
+    // Formats a line of the ring as logv() would have.
+    static std::string formatRt(const RtEntry &entry);
+
+    // Moves the lines of the ring to the history, formatting them.  Called with mLock held.
+    void drainLocked() const;
+
     mutable std::mutex mLock;
     static const size_t kMaxStringLength = 1024;  // maximum formatted string length
     static const size_t kDefaultMaxLogLines = 80; // default maximum log history
 
     const size_t mMaxLogLines;                    // maximum log history
-    std::deque<std::pair<int64_t, std::string>> mLog; // circular buffer is backed by deque.
+    // circular buffer is backed by deque, mutable as the dump methods drain the ring into it.
+    mutable std::deque<std::pair<int64_t, std::string>> mLog;
+
+    // Only used in real-time mode: the ring of lines written by the log methods.
+    const bool mRealTime;
+    std::unique_ptr<RtEntry[]> mRingBuffer;
+    std::unique_ptr<audio_utils_fifo> mRing;
+    std::unique_ptr<audio_utils_fifo_writer> mRingWriter;
+    std::unique_ptr<audio_utils_fifo_reader> mRingReader;
+    mutable std::unique_ptr<RtEntry[]> mDrainEntries; // lines read by drainLocked()
 };
 
 } // namespace android
@@ -24,6 +24,8 @@
 // variadic_utils already contains stl headers; in addition:
 #include <deque> // for ReferenceStatistics implementation
 #include <sstream>
+#include <thread> // for addParallel
+#include <vector>
 
 namespace android {
 namespace audio_utils {
@@ -304,6 +306,58 @@ public:
         */
     }
 
+    /**
+     * Adds n values, with the same result as add() of each value in turn,
+     * up to rounding.
+     *
+     * For scalar data the values are interleaved over kAddLanes independent
+     * running statistics, each with its own compensated mean, and so without the
+     * serial dependency of add() from one value to the next.  Each lane sees one
+     * value in kAddLanes, so its weight decays by alpha^kAddLanes per value.
+     * The lanes are then merged as by merge(), weighting each lane by the decay
+     * from its last value to the last value added, and the result merged into
+     * the current statistics.
+     *
+     * The lanes are plain arrays, so the compiler can keep them in vector registers.
+     * Not constexpr, as the decay over n values uses std::pow().
+     */
+    void add(const T *values, size_t n) {
+        const size_t added = addLanes(values, n, std::integral_constant<bool,
+                std::is_arithmetic<T>::value
+                        && std::is_same<PRODUCT, std::multiplies<D>>::value>());
+        for (size_t i = added; i < n; ++i) {
+            add(values[i]);
+        }
+    }
+
+    /**
+     * Merges in the statistics of other values, as if they had been added after the
+     * values of this object, for example to combine statistics collected in parallel
+     * over parts of a stream, or over several streams.
+     *
+     * The means and variances are combined with the pairwise update of Chan et al.,
+     * which is numerically stable, and the mean keeps its compensated sum.
+     *
+     * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+     *
+     * With alpha == 1 (rectangular weighting) the order of the values does not matter,
+     * so merging is commutative up to rounding.  Otherwise, other must have used the
+     * same alpha, and the values of this object decay by alpha^other.getN().
+     * Not constexpr if alpha != 1, as the decay uses std::pow().
+     */
+    constexpr void merge(const Statistics &other) {
+        mMax = audio_utils::max(mMax, other.mMax); // order important: reject NaN
+        mMin = audio_utils::min(mMin, other.mMin); // order important: reject NaN
+        mN += other.mN;
+        if (mAlpha != A(1.)) {
+            const A decay = std::pow(mAlpha, A(other.mN));
+            mWeight *= decay;
+            mWeight2 *= decay * decay;
+            mM2 *= decay;
+        }
+        mergeMoments(other.mWeight, other.mWeight2, D(other.mMean), other.mM2);
+    }
+
     constexpr int64_t getN() const {
         return mN;
     }
@@ -376,7 +430,81 @@ public:
         return ss.str();
     }
 
+    /** Number of independent running statistics used by add() of n values. */
+    static constexpr size_t kAddLanes = 8;
+
 private:
+    // Vector data, or a custom PRODUCT: add() each value.
+    size_t addLanes(const T * /* values */, size_t /* n */, std::false_type) {
+        return 0;
+    }
+
+    // Adds the first values in lanes, see add(), and returns how many were added.
+    size_t addLanes(const T *values, size_t n, std::true_type) {
+        if (n < 2 * kAddLanes) {
+            return 0;
+        }
+        T laneMin[kAddLanes];
+        T laneMax[kAddLanes];
+        S laneMean[kAddLanes];
+        D2 laneM2[kAddLanes];
+        for (size_t l = 0; l < kAddLanes; ++l) {
+            laneMin[l] = StatisticsConstants<T>::positiveInfinity();
+            laneMax[l] = StatisticsConstants<T>::negativeInfinity();
+            laneMean[l] = {};
+            laneM2[l] = {};
+        }
+        // Every lane sees the same number of values, so shares its weights.
+        const A laneAlpha = std::pow(mAlpha, A(kAddLanes));
+        A laneWeight{};
+        A laneWeight2{};
+        const size_t steps = n / kAddLanes;
+        for (size_t i = 0; i < steps; ++i, values += kAddLanes) {
+            laneWeight = A(1.) + laneAlpha * laneWeight;
+            laneWeight2 = A(1.) + laneAlpha * laneAlpha * laneWeight2;
+            for (size_t l = 0; l < kAddLanes; ++l) {
+                const T &value = values[l];
+                laneMax[l] = audio_utils::max(laneMax[l], value); // order important: reject NaN
+                laneMin[l] = audio_utils::min(laneMin[l], value); // order important: reject NaN
+                const D delta = value - laneMean[l];
+                laneMean[l] += delta / laneWeight;
+                laneM2[l] = laneAlpha * laneM2[l] + delta * (value - laneMean[l]);
+            }
+        }
+
+        // Merge the lanes, the last value of lane l being kAddLanes - 1 - l values
+        // before the last value added.
+        Statistics block(mAlpha);
+        A decay(1.);
+        for (size_t l = kAddLanes; l-- > 0; ) {
+            block.mMax = audio_utils::max(block.mMax, laneMax[l]);
+            block.mMin = audio_utils::min(block.mMin, laneMin[l]);
+            block.mergeMoments(decay * laneWeight, decay * decay * laneWeight2,
+                    D(laneMean[l]), decay * laneM2[l]);
+            decay *= mAlpha;
+        }
+
+        block.mN = steps * kAddLanes;
+        merge(block);
+        return steps * kAddLanes;
+    }
+
+    // Merges in the weights, mean and unnormalized variance of other values, which
+    // follow the current values, without decaying the current values.
+    // Min, max and the count are not changed.
+    constexpr void mergeMoments(A weight, A weight2, D mean, D2 m2) {
+        const A total = mWeight + weight;
+        if (total == A{}) {
+            return;
+        }
+        const D delta = mean - D(mMean);
+        const D meanDelta = delta * (weight / total);
+        mM2 = mM2 + m2 + PRODUCT()(delta, delta * (mWeight * weight / total));
+        mMean += meanDelta;
+        mWeight = total;
+        mWeight2 += weight2;
+    }
+
     A mAlpha;
     T mMin{StatisticsConstants<T>::positiveInfinity()};
     T mMax{StatisticsConstants<T>::negativeInfinity()};
@@ -686,6 +814,193 @@ public:
     }
 };
 
+/**
+ * QuantileHistogram estimates quantiles of a sample stream, such as the median
+ * or the 99th percentile, in fixed memory and with O(1) add().
+ *
+ * The values are counted in a log-linear histogram: each power of 2 of magnitude
+ * from 2^MIN_EXPONENT to 2^MAX_EXPONENT is split into 2^SUB_BUCKETS_LOG2 equal buckets,
+ * for positive and negative values alike, so a quantile is within a relative error of
+ * 2^-(SUB_BUCKETS_LOG2 + 1) of a value of the stream.  Magnitudes below 2^MIN_EXPONENT
+ * count as zero, and above 2^MAX_EXPONENT as the largest bucket; the exact min and max
+ * bound the quantiles.  NaN values are ignored.
+ *
+ * Unlike Statistics, every value since reset() weighs the same.
+ * Instances with the same parameters may be merged, for example to combine the
+ * histograms of several streams.
+ *
+ * All methods except toString() are safe to call from a SCHED_FIFO thread.
+ */
+template <
+    typename T = double,      // input data type
+    int MIN_EXPONENT = -10,   // magnitude of the smallest non-zero bucket, as a power of 2
+    int MAX_EXPONENT = 10,    // magnitude of the end of the largest bucket, as a power of 2
+    int SUB_BUCKETS_LOG2 = 4  // buckets per power of 2, as a power of 2
+    >
+class QuantileHistogram {
+public:
+    static_assert(std::is_floating_point<T>::value, "QuantileHistogram requires floating point");
+    static_assert(MIN_EXPONENT < MAX_EXPONENT, "MIN_EXPONENT must be less than MAX_EXPONENT");
+
+    static constexpr size_t kSubBuckets = size_t(1) << SUB_BUCKETS_LOG2;
+    // buckets for each sign, excluding zero.
+    static constexpr size_t kMagnitudeBuckets = (MAX_EXPONENT - MIN_EXPONENT) * kSubBuckets;
+    // negative buckets from the largest magnitude, zero, then positive buckets.
+    static constexpr size_t kBuckets = 2 * kMagnitudeBuckets + 1;
+
+    void add(const T &value) {
+        if (std::isnan(value)) {
+            return;
+        }
+        ++mCounts[index(value)];
+        ++mN;
+        mMin = std::min(mMin, value);
+        mMax = std::max(mMax, value);
+    }
+
+    void merge(const QuantileHistogram &other) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            mCounts[i] += other.mCounts[i];
+        }
+        mN += other.mN;
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+    }
+
+    void reset() {
+        mCounts = {};
+        mN = 0;
+        mMin = StatisticsConstants<T>::positiveInfinity();
+        mMax = StatisticsConstants<T>::negativeInfinity();
+    }
+
+    constexpr int64_t getN() const {
+        return mN;
+    }
+
+    constexpr T getMin() const {
+        return mMin;
+    }
+
+    constexpr T getMax() const {
+        return mMax;
+    }
+
+    /**
+     * Returns the estimate of the q quantile, for q from 0 to 1, by the nearest rank
+     * method, or NaN if no values were added.  The cost is linear in kBuckets.
+     */
+    T getQuantile(double q) const {
+        if (mN == 0) {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+        const int64_t rank = std::min(std::max(int64_t(std::ceil(q * mN)), int64_t(1)), mN);
+        if (rank == 1) {
+            return mMin;
+        }
+        if (rank == mN) {
+            return mMax; // also for the largest buckets, which hold the clamped magnitudes
+        }
+        int64_t count = 0;
+        size_t i = 0;
+        for (; i < kBuckets - 1; ++i) {
+            count += mCounts[i];
+            if (count >= rank) {
+                break;
+            }
+        }
+        return std::min(std::max(value(i), mMin), mMax);
+    }
+
+    std::string toString() const {
+        if (mN == 0) return "unavail";
+
+        std::stringstream ss;
+        ss << "p50=" << getQuantile(0.5);
+        ss << " p90=" << getQuantile(0.9);
+        ss << " p99=" << getQuantile(0.99);
+        ss << " p99.9=" << getQuantile(0.999);
+        ss << " max=" << getMax();
+        return ss.str();
+    }
+
+private:
+    static size_t index(T value) {
+        const T magnitude = value < 0 ? -value : value;
+        size_t offset = 0; // from the zero bucket
+        if (magnitude >= std::ldexp(T(1.), MIN_EXPONENT)) {
+            int exponent;
+            const T mantissa = std::frexp(magnitude, &exponent); // in [0.5, 1)
+            --exponent;
+            if (exponent >= MAX_EXPONENT) {
+                offset = kMagnitudeBuckets;
+            } else {
+                offset = 1 + (exponent - MIN_EXPONENT) * kSubBuckets
+                        + size_t((mantissa * 2 - 1) * kSubBuckets);
+            }
+        }
+        return value < 0 ? kMagnitudeBuckets - offset : kMagnitudeBuckets + offset;
+    }
+
+    // The middle of a bucket.
+    static T value(size_t index) {
+        const bool negative = index < kMagnitudeBuckets;
+        const size_t offset = negative ? kMagnitudeBuckets - index : index - kMagnitudeBuckets;
+        if (offset == 0) {
+            return {};
+        }
+        const int exponent = int((offset - 1) / kSubBuckets) + MIN_EXPONENT;
+        const T magnitude = std::ldexp(
+                1 + (T((offset - 1) % kSubBuckets) + T(0.5)) / kSubBuckets, exponent);
+        return negative ? -magnitude : magnitude;
+    }
+
+    std::array<uint32_t, kBuckets> mCounts{}; // each bucket counts up to UINT32_MAX values.
+    int64_t mN = 0;
+    T mMin{StatisticsConstants<T>::positiveInfinity()};
+    T mMax{StatisticsConstants<T>::negativeInfinity()};
+};
+
+/**
+ * Adds n values to stats, as stats.add(values, n), splitting the values into
+ * threadCount contiguous shards which are added in parallel to copies of stats
+ * after reset(), then merged into stats in order with merge().
+ *
+ * Stats is Statistics or LinearLeastSquaresFit.  The result is the same as
+ * stats.add(values, n) up to rounding, for any alpha.  The shards are added by
+ * threadCount - 1 new threads and the calling thread, so this is not for a
+ * SCHED_FIFO thread.  Worthwhile for long arrays only, of a million values or so.
+ */
+template <typename Stats, typename T>
+void addParallel(Stats &stats, const T *values, size_t n, size_t threadCount) {
+    threadCount = std::max(std::min(threadCount, n), size_t(1));
+    std::vector<Stats> shards(threadCount, stats);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    size_t begin = 0;
+    for (size_t i = 0; i < threadCount; ++i) {
+        const size_t end = n * (i + 1) / threadCount;
+        Stats &shard = shards[i];
+        shard.reset();
+        const T *shardValues = values + begin;
+        const size_t shardCount = end - begin;
+        if (i + 1 < threadCount) {
+            threads.emplace_back([&shard, shardValues, shardCount] {
+                shard.add(shardValues, shardCount);
+            });
+        } else {
+            shard.add(shardValues, shardCount);
+        }
+        begin = end;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto &shard : shards) {
+        stats.merge(shard);
+    }
+}
+
 /**
  * constexpr statistics functions of form:
  * algorithm(forward_iterator begin, forward_iterator end)
@@ -33,6 +33,10 @@ namespace android {
 template <typename F /* frame count */, typename T /* time units */>
 class TimestampVerifier {
 public:
+    // Jitter quantiles from about 1 us to 1 s, within 3%.
+    using JitterQuantiles = audio_utils::QuantileHistogram<double,
+            -10 /* MIN_EXPONENT */, 10 /* MAX_EXPONENT */, 4 /* SUB_BUCKETS_LOG2 */>;
+
     explicit constexpr TimestampVerifier(
             double alphaJitter = kDefaultAlphaJitter,
             double alphaEstimator = kDefaultAlphaEstimator)
@@ -100,6 +104,9 @@ public:
             } else {
                 const double jitterMs = computeJitterMs(timestamp, mLastTimestamp, sampleRate);
                 mJitterMs.add(jitterMs);
+                if (mJitterMsQuantiles != nullptr) {
+                    mJitterMsQuantiles->add(jitterMs);
+                }
                 // ALOGD("frames:%lld  timeNs:%lld jitterMs:%lf",
                 //         (long long)frames, (long long)timeNs, jitterMs);
 
@@ -191,6 +198,21 @@ public:
         return mDiscontinuityMode;
     }
 
+    /** tracks the quantiles of the jitter in quantiles, or stops tracking if nullptr.
+     *
+     * Disabled by default.  Unlike getJitterMs(), which weighs recent timestamps more,
+     * the quantiles are over all timestamps added to the histogram, so that the tails of the
+     * distribution, such as the 99.9th percentile, can be checked against a target.
+     * Tracking is cheap but not constexpr, so is not for constant evaluation.
+     *
+     * The histogram is about 2.5 KB, so it is allocated by the caller only when needed,
+     * and must outlive its use by the verifier.  The verifier stays trivially copyable:
+     * a copy tracks into the same histogram.
+     */
+    constexpr void setJitterMsQuantiles(JitterQuantiles *quantiles) {
+        mJitterMsQuantiles = quantiles;
+    }
+
     /** returns a string with relevant statistics.
      *
      * Should not be called from a SCHED_FIFO thread since it uses std::string.
@@ -208,6 +230,9 @@ public:
                     mLastTimestamp, mFirstTimestamp, mSampleRate);
         }
         ss << " jitterMs(" << mJitterMs.toString() << ")";  // timestamp jitter statistics.
+        if (mJitterMsQuantiles != nullptr) {                // and percentiles.
+            ss << " jitterMsQuantiles(" << mJitterMsQuantiles->toString() << ")";
+        }
 
         double a, b, r2; // sample rate is the slope b.
         estimateSampleRate(a, b, r2);
@@ -228,6 +253,10 @@ public:
     constexpr const audio_utils::Statistics<double> & getJitterMs() const {
         return mJitterMs;
     }
+    // the histogram of setJitterMsQuantiles(), or nullptr if none.
+    constexpr const JitterQuantiles * getJitterMsQuantiles() const {
+        return mJitterMsQuantiles;
+    }
     // estimate local sample rate (dframes / dtime) which is the slope b from:
     // y = a + bx
     constexpr void estimateSampleRate(double &a, double &b, double &r2) const {
@@ -265,6 +294,7 @@ private:
     int64_t mColds = 0;
     int64_t mErrors = 0;
     audio_utils::Statistics<double> mJitterMs{kDefaultAlphaJitter};
+    JitterQuantiles *mJitterMsQuantiles = nullptr;  // not owned
 
     // timestamp anchor info
     bool mDiscontinuity = true;
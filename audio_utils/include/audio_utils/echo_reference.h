@@ -62,6 +62,24 @@ int create_echo_reference(audio_format_t rdFormat,
 
 void release_echo_reference(struct echo_reference_itfe *echo_reference);
 
+/**
+ * Enables the compensation of the drift between the playback and capture clocks if enabled is
+ * non-zero, or disables it. The reader then estimates the ratio of the clocks from the time
+ * stamps of the writes and reads, and continuously trims the ratio of its resampler so that the
+ * reference stays aligned with the capture, without dropping or inserting frames.
+ * Must be called before the first read(), or on the thread calling read().
+ * \return 0 on success, or a negative errno if the reference cannot be resampled.
+ */
+int echo_reference_set_drift_compensation(struct echo_reference_itfe *echo_reference,
+                                          int enabled);
+
+/**
+ * \return the drift of the playback clock relative to the capture clock estimated by the reader,
+ * in parts per million, positive if the playback clock is faster; or 0 until estimated,
+ * or if the drift compensation is disabled. May be called from any thread.
+ */
+float echo_reference_get_drift_ppm(struct echo_reference_itfe *echo_reference);
+
 __END_DECLS
 
 #endif // ANDROID_ECHO_REFERENCE_H
@@ -25,6 +25,8 @@
 #error C API is no longer supported
 #endif
 
+class audio_utils_fifo_mirrored_buffer;
+
 /** Indicates whether an index is also used for synchronization. */
 enum audio_utils_fifo_sync {
     /** Index is not also used for synchronization; timeouts are done via clock_nanosleep(). */
@@ -141,6 +143,7 @@ class audio_utils_fifo : public audio_utils_fifo_base {
     friend class audio_utils_fifo_reader;
     friend class audio_utils_fifo_writer;
     friend class audio_utils_fifo_writer32;
+    friend class audio_utils_fifo_reader32;
 
 public:
 
@@ -161,6 +164,23 @@ public:
     audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
             audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront = NULL);
 
+    /**
+     * Construct a FIFO object: multi-process, with the recommended layout of indices.
+     *
+     *  \param frameCount  Maximum usable frames to be stored in the FIFO > 0 && <= INT32_MAX,
+     *                     aka "capacity".
+     *                     If writes and reads always use the same count, and the count is a divisor
+     *                     of \p frameCount, then the writes and reads won't do a partial transfer.
+     *  \param frameSize   Size of each frame in bytes > 0,
+     *                     \p frameSize * \p frameCount <= INT32_MAX.
+     *  \param buffer      Pointer to a non-NULL caller-allocated buffer of \p frameCount frames.
+     *  \param control     Writer's rear index, and the front index of the reader that throttles
+     *                     the writer, each in its own cache line.
+     *  \param throttlesWriter Whether there is one reader that throttles the writer.
+     */
+    audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
+            audio_utils_fifo_control& control, bool throttlesWriter = true);
+
     /**
      * Construct a FIFO object: single-process.
      *  \param frameCount  Maximum usable frames to be stored in the FIFO > 0 && <= INT32_MAX,
@@ -175,6 +195,28 @@ public:
     audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
             bool throttlesWriter = true);
 
+    /**
+     * Construct a FIFO object on a mirrored buffer: multi-process.
+     * Each slice returned by obtain() is a single fragment; see isMirrored().
+     *
+     *  \param buffer      A mirrored buffer for which initCheck() is zero, which must outlive the
+     *                     FIFO, and which determines the capacity and frame size.
+     *  \param control     Writer's rear index, and the front index of the reader that throttles
+     *                     the writer, each in its own cache line.
+     *  \param throttlesWriter Whether there is one reader that throttles the writer.
+     */
+    audio_utils_fifo(const audio_utils_fifo_mirrored_buffer& buffer,
+            audio_utils_fifo_control& control, bool throttlesWriter = true);
+
+    /**
+     * Construct a FIFO object on a mirrored buffer: single-process.
+     *
+     *  \param buffer      See above.
+     *  \param throttlesWriter Whether there is one reader that throttles the writer.
+     */
+    explicit audio_utils_fifo(const audio_utils_fifo_mirrored_buffer& buffer,
+            bool throttlesWriter = true);
+
     /*virtual*/ ~audio_utils_fifo();
 
     /**
@@ -193,17 +235,30 @@ public:
     void *buffer() const
             { return mBuffer; }
 
+    /**
+     * Return whether the buffer is mirrored, that is whether it is followed by a second mapping
+     * of itself.  If so, then every slice returned by obtain() is described by iovec[0] alone,
+     * which may extend beyond the end of the first mapping, and iovec[1] is always empty.
+     *
+     * \return Whether the FIFO was constructed on an audio_utils_fifo_mirrored_buffer.
+     */
+    bool isMirrored() const
+            { return mMirrored; }
+
 private:
+    audio_utils_fifo(uint32_t frameCount, uint32_t frameSize, void *buffer,
+            audio_utils_fifo_index& writerRear, audio_utils_fifo_index *throttleFront,
+            bool mirrored);
+
     // These fields are const after initialization
     const uint32_t mFrameSize;  // size of each frame in bytes
     void * const   mBuffer;     // non-NULL pointer to caller-allocated buffer
                                 // of size mFrameCount frames
+    const bool     mMirrored;   // whether mBuffer is followed by a second mapping of itself
 
-    // only used for single-process constructor
-    audio_utils_fifo_index      mSingleProcessSharedRear;
-
-    // only used for single-process constructor when throttlesWriter == true
-    audio_utils_fifo_index      mSingleProcessSharedFront;
+    // only used for single-process constructor,
+    // and the front index only when throttlesWriter == true
+    audio_utils_fifo_control    mSingleProcessControl;
 };
 
 /**
@@ -437,16 +492,76 @@ public:
      */
     void getHysteresis(uint32_t *armLevel, uint32_t *triggerLevel) const;
 
+    /**
+     * Set the number of frames over which the writer coalesces its wakes of blocked readers.
+     * A wake triggered by write() or release() per the hysteresis is deferred, and any wakes
+     * triggered while it is pending are merged into it, until at least \p batchFrames frames
+     * have been released since the first of them, or until wakeNowIfNeeded() is called,
+     * or until the writer blocks in write() or obtain().
+     * The frames themselves are observable by readers at each write() or release() as usual,
+     * so a reader which polls, or spins per audio_utils_fifo_reader::setSpin(), is not delayed.
+     * The default value is zero, which means every triggered wake is done immediately.
+     * A writer which defers wakes should call wakeNowIfNeeded() when it stops writing,
+     * for example at the end of each period, or a reader could wait indefinitely.
+     *
+     * \param batchFrames Frames to release before doing a deferred wake.
+     */
+    void setWakeBatch(uint32_t batchFrames)
+            { mWakeBatchFrames = batchFrames; }
+
+    /**
+     * Get the number of frames over which the writer coalesces its wakes of blocked readers.
+     *
+     * \return The wake batch in frames.
+     */
+    uint32_t getWakeBatch() const
+            { return mWakeBatchFrames; }
+
+    /** Wake blocked readers now, if a wake was deferred by the wake batch. */
+    void wakeNowIfNeeded();
+
+    /**
+     * Return the total number of futex wakes done by the writer since construction.
+     *
+     * \return Total wakes.
+     */
+    uint64_t totalWakes() const
+            { return mTotalWakes; }
+
+    /**
+     * Return the total number of futex wakes avoided since construction, because they were
+     * merged into a deferred wake by the wake batch.  Does not include wakes avoided by hysteresis.
+     *
+     * \return Total wakes avoided.
+     */
+    uint64_t totalWakesAvoided() const
+            { return mTotalWakesAvoided; }
+
 private:
+    // Whether release() needs a fresh front index to decide to wake readers, as \p filled
+    // computed from a cached front index may be greater than the actual fill level.
+    bool needsFreshFront(uint32_t filled, size_t count) const;
+
     // Accessed by writer only using ordinary operations
     uint32_t    mLocalRear; // frame index of next frame slot available to write, or write index
 
+    // The throttling reader's front index when most recently loaded, which is behind the actual
+    // front index, so obtain() can grant frames without loading the reader's cache line again
+    // while enough of them were already free.
+    uint32_t    mCachedFront;
+
     // TODO make a separate class and associate with the synchronization object
     uint32_t    mArmLevel;          // arm if filled < arm level before release()
     uint32_t    mTriggerLevel;      // trigger if armed and filled > trigger level after release()
     bool        mIsArmed;           // whether currently armed
 
     uint32_t    mEffectiveFrames;   // current effective buffer size, <= mFifo.mFrameCount
+
+    RefIndexDeferredStoreReleaseDeferredWake mWriterRearWake;  // defers wakes of the readers
+    uint32_t    mWakeBatchFrames;   // frames to release before doing a deferred wake
+    uint32_t    mDeferredFrames;    // frames released since the deferred wake was triggered
+    uint64_t    mTotalWakes;        // total futex wakes done
+    uint64_t    mTotalWakesAvoided; // total futex wakes merged into a deferred wake
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -460,6 +575,8 @@ private:
  */
 class audio_utils_fifo_reader : public audio_utils_fifo_provider {
 
+    friend class audio_utils_fifo_broadcast_reader;
+
 public:
     /**
      * Single-process and multi-process use same constructor here,
@@ -592,6 +709,46 @@ public:
      */
     void getHysteresis(int32_t *armLevel, uint32_t *triggerLevel) const;
 
+    /**
+     * Set the maximum time for obtain() or read() to spin before blocking.
+     * When the FIFO is empty and the timeout is neither NULL nor {0, 0}, the reader first polls
+     * the writer's rear index for up to \p spinNs, and blocks on the futex only if no frames
+     * were written meanwhile.  This trades some CPU time for fewer futex waits and wakes,
+     * and so fewer context switches, when the writer is expected to write again very soon,
+     * as for periods of a few milliseconds.  The spin counts towards the timeout.
+     * The default value is zero, which means to block immediately.
+     * Has no effect with AUDIO_UTILS_FIFO_SYNC_SLEEP.
+     *
+     * \param spinNs Maximum time to spin in nanoseconds.
+     */
+    void setSpin(uint32_t spinNs)
+            { mSpinNs = spinNs; }
+
+    /**
+     * Get the maximum time for obtain() or read() to spin before blocking.
+     *
+     * \return The maximum spin time in nanoseconds.
+     */
+    uint32_t getSpin() const
+            { return mSpinNs; }
+
+    /**
+     * Return the total number of futex waits done by the reader since construction.
+     *
+     * \return Total waits.
+     */
+    uint64_t totalWaits() const
+            { return mTotalWaits; }
+
+    /**
+     * Return the total number of futex waits avoided since construction, because frames were
+     * written while spinning.
+     *
+     * \return Total waits avoided.
+     */
+    uint64_t totalWaitsAvoided() const
+            { return mTotalWaitsAvoided; }
+
     /**
      * Return the total number of lost frames since construction, due to reader not keeping up with
      * writer.  Does not include flushed frames.
@@ -614,9 +771,26 @@ public:
             { return mTotalFlushed; }
 
 private:
+    // Whether release() needs a fresh rear index to decide to wake the writer, as \p filled
+    // computed from a cached rear index may be less than the actual fill level.
+    bool needsFreshRear(uint32_t filled, size_t count) const;
+
+    // Poll the writer's rear index while it is equal to \p rear, for up to mSpinNs and at most
+    // \p timeout, which must not be NULL.  Returns true if it changed.  Otherwise returns false,
+    // and sets \p remaining to what is left of the timeout, or to {0, 0} if none is left.
+    bool spin(uint32_t rear, const struct timespec *timeout, struct timespec *remaining);
+
+    // Publish the front index and lost frames to mSlot, if registered in a broadcast FIFO.
+    void publish();
+
     // Accessed by reader only using ordinary operations
     uint32_t     mLocalFront;   // frame index of first frame slot available to read, or read index
 
+    // If this reader throttles the writer, the writer's rear index when most recently loaded,
+    // which is behind the actual rear index, so obtain() can return frames without loading the
+    // writer's cache line again while enough of them were already filled.
+    uint32_t     mCachedRear;
+
     // Points to shared front index if this reader throttles writer, or NULL if we don't throttle
     // FIXME consider making it a boolean
     audio_utils_fifo_index*     mThrottleFront;
@@ -629,6 +803,13 @@ private:
 
     uint64_t    mTotalLost;         // total lost frames, does not include flushed frames
     uint64_t    mTotalFlushed;      // total flushed frames, does not include lost frames
+
+    uint32_t    mSpinNs;            // maximum time to spin before blocking
+    uint64_t    mTotalWaits;        // total futex waits done
+    uint64_t    mTotalWaitsAvoided; // total futex waits avoided by spinning
+
+    // Entry in the table of readers of a broadcast FIFO, or NULL
+    audio_utils_fifo_reader_slot*   mSlot;
 };
 
 #endif  // !ANDROID_AUDIO_FIFO_H
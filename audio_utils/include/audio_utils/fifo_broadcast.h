@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_BROADCAST_H
+#define ANDROID_AUDIO_FIFO_BROADCAST_H
+
+#include <memory>
+
+#include <audio_utils/fifo.h>
+
+/** Summary of the progress of the readers of a broadcast FIFO. */
+struct audio_utils_fifo_lag {
+    /** Number of registered readers. */
+    uint32_t    mReaders;
+    /** Lag in frames of the reader which is furthest ahead, or zero if there are no readers. */
+    uint32_t    mMinLag;
+    /** Lag in frames of the reader which is furthest behind, or zero if there are no readers. */
+    uint32_t    mMaxLag;
+    /** Slot of the reader which is furthest behind, or -1 if there are no readers. */
+    int32_t     mSlowest;
+    /** Total lost frames of the registered readers. */
+    uint64_t    mTotalLost;
+};
+
+/**
+ * A FIFO with one writer and any number of non-throttling readers, which register in a table
+ * of audio_utils_fifo_reader_slot so that their progress can be observed.
+ *
+ * Each reader publishes its front index at each obtain() that loses frames and each release(),
+ * so the writer or any other observer, possibly in another process, can find out the lag of
+ * each reader, that is the number of frames written but not yet read by it, without locks and
+ * without the cooperation of the readers.  The lag may exceed the capacity for a reader which
+ * has been overrun and has not yet caught up.
+ *
+ * The writer is an ordinary audio_utils_fifo_writer, and is never throttled.
+ * The readers must be audio_utils_fifo_broadcast_reader.
+ * A reader in a process which dies without destroying its reader keeps its slot, and appears
+ * to lag further and further behind.
+ */
+class audio_utils_fifo_broadcast : public audio_utils_fifo {
+
+    friend class audio_utils_fifo_broadcast_reader;
+
+public:
+
+    /**
+     * Construct a FIFO object: multi-process.
+     *
+     *  \param frameCount  See audio_utils_fifo.
+     *  \param frameSize   See audio_utils_fifo.
+     *  \param buffer      See audio_utils_fifo.
+     *  \param writerRear  See audio_utils_fifo.
+     *  \param slots       Table of readers, shared by every process using the FIFO,
+     *                     each entry initially constructed and not since used by other FIFOs.
+     *  \param slotCount   Number of entries in \p slots > 0, the maximum number of readers.
+     */
+    audio_utils_fifo_broadcast(uint32_t frameCount, uint32_t frameSize, void *buffer,
+            audio_utils_fifo_index& writerRear, audio_utils_fifo_reader_slot *slots,
+            uint32_t slotCount);
+
+    /**
+     * Construct a FIFO object: single-process.
+     *
+     *  \param frameCount  See audio_utils_fifo.
+     *  \param frameSize   See audio_utils_fifo.
+     *  \param buffer      See audio_utils_fifo.
+     *  \param slotCount   Maximum number of readers > 0.
+     */
+    audio_utils_fifo_broadcast(uint32_t frameCount, uint32_t frameSize, void *buffer,
+            uint32_t slotCount);
+
+    /*virtual*/ ~audio_utils_fifo_broadcast();
+
+    /**
+     * Summarize the lag of the registered readers.
+     * There's an inherent race condition: the writer and readers continue meanwhile, so the
+     * summary is approximate, but it never understates the lag of a reader as of the time that
+     * its front index was observed.
+     *
+     * \return Summary of the readers.
+     */
+    audio_utils_fifo_lag lag() const;
+
+    /**
+     * Return the slot of the reader which is furthest behind.
+     *
+     * \return Slot of the slowest reader, or -1 if there are no readers.
+     */
+    int32_t slowestReader() const
+            { return lag().mSlowest; }
+
+    /**
+     * Return the lag of one reader.
+     *
+     * \param slot Slot of the reader, as returned by audio_utils_fifo_broadcast_reader::slot().
+     * \param lost If non-NULL, set to the total lost frames of the reader.
+     *
+     * \return Lag of the reader in frames, if greater than or equal to zero.
+     *  \retval -EINVAL     \p slot is out of range
+     *  \retval -ENOENT     no reader is registered in \p slot
+     *  \retval -EIO        corrupted indices, no recovery is possible
+     */
+    int64_t readerLag(uint32_t slot, uint64_t *lost = NULL) const;
+
+    /** Return the maximum number of readers. */
+    uint32_t slotCount() const
+            { return mSlotCount; }
+
+private:
+    // Lag of the reader registered in a slot, or a negative error code as for readerLag().
+    int64_t lag(const audio_utils_fifo_reader_slot& slot, uint64_t *lost) const;
+
+    // only used for single-process constructor
+    std::unique_ptr<audio_utils_fifo_reader_slot[]> mSingleProcessSlots;
+
+    audio_utils_fifo_reader_slot * const    mSlots;
+    const uint32_t                          mSlotCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Used to read from an audio_utils_fifo_broadcast.  Same as a non-throttling
+ * audio_utils_fifo_reader, except that it registers in a slot of the table of readers for its
+ * lifetime, and publishes its progress there.
+ */
+class audio_utils_fifo_broadcast_reader : public audio_utils_fifo_reader {
+
+public:
+    /**
+     * \param fifo  Associated FIFO.  Passed by reference because it must be non-NULL.
+     * \param flush See audio_utils_fifo_reader.
+     */
+    explicit audio_utils_fifo_broadcast_reader(audio_utils_fifo_broadcast& fifo,
+            bool flush = false);
+    virtual ~audio_utils_fifo_broadcast_reader();
+
+    /**
+     * Return the slot in which the reader is registered.
+     * If all of the slots were in use at construction, the reader still works,
+     * but is not registered and so can't be observed.
+     *
+     * \return Slot of the reader, or -1 if it is not registered.
+     */
+    int32_t slot() const
+            { return mSlotIndex; }
+
+private:
+    int32_t     mSlotIndex; // index of mSlot in the table, or -1
+};
+
+#endif  // !ANDROID_AUDIO_FIFO_BROADCAST_H
@@ -79,6 +79,17 @@ public:
     // specialized use only, prefer loadAcquire in most cases
     uint32_t loadConsume();
 
+    /**
+     * Replace the value of index by \p desired if it is equal to \p expected,
+     * with memory order 'acquire_release'. Used to reserve frames by multiple writers or readers.
+     *
+     * \param expected Expected value of index, set to the actual value on failure.
+     * \param desired  New value to store into index.
+     *
+     * \return Whether the value was replaced.
+     */
+    bool compareExchange(uint32_t &expected, uint32_t desired);
+
 private:
     // Linux futex is 32 bits regardless of platform.
     // It would make more sense to declare this as atomic_uint32_t, but there is no such type name.
@@ -90,6 +101,52 @@ private:
 static_assert(sizeof(audio_utils_fifo_index) == sizeof(uint32_t),
         "audio_utils_fifo_index must be 32 bits");
 
+/** Size in bytes of a cache line, the unit of coherence traffic between cores. */
+#define AUDIO_UTILS_CACHE_LINE_SIZE 64
+
+/**
+ * The recommended layout of the indices of a FIFO, whether in shared memory or not.
+ *
+ * Each index is alone in its cache line, so that a store by the writer to the rear index
+ * does not invalidate the line of the front index which it reads, nor the reverse, and neither
+ * shares a line with other data such as the buffer or the state of the writer or reader.
+ * Like audio_utils_fifo_index, it is Plain Old Data, and if in shared memory, exactly one process
+ * must explicitly call the constructor via placement new.
+ */
+struct audio_utils_fifo_control {
+    /** Writer's rear index. */
+    alignas(AUDIO_UTILS_CACHE_LINE_SIZE) audio_utils_fifo_index mRear;
+    /** Front index of the reader that throttles the writer, if any. */
+    alignas(AUDIO_UTILS_CACHE_LINE_SIZE) audio_utils_fifo_index mFront;
+};
+
+static_assert(sizeof(audio_utils_fifo_control) == 2 * AUDIO_UTILS_CACHE_LINE_SIZE,
+        "audio_utils_fifo_control must be one cache line per index");
+
+/**
+ * An entry in the table of readers of a broadcast FIFO, in which a reader publishes its progress
+ * so that the writer or another observer can find the lagging readers without locks.
+ *
+ * Each entry is alone in its cache line, so that readers publishing their front index don't
+ * invalidate each other's lines.
+ * Like audio_utils_fifo_index, it is Plain Old Data, and if in shared memory, exactly one process
+ * must explicitly call the constructor via placement new.
+ * \see audio_utils_fifo_broadcast
+ */
+struct audio_utils_fifo_reader_slot {
+    audio_utils_fifo_reader_slot() : mState(0), mLost(0) { }
+
+    /** Whether the entry is free, being registered, or registered; see fifo_broadcast.cpp. */
+    alignas(AUDIO_UTILS_CACHE_LINE_SIZE) std::atomic_uint_least32_t mState;
+    /** The reader's front index, as of its most recent obtain() or release(). */
+    audio_utils_fifo_index      mFront;
+    /** The reader's total lost frames, as of its most recent obtain(). */
+    std::atomic_uint_least64_t  mLost;
+};
+
+static_assert(sizeof(audio_utils_fifo_reader_slot) == AUDIO_UTILS_CACHE_LINE_SIZE,
+        "audio_utils_fifo_reader_slot must be one cache line");
+
 // TODO
 // From a design POV, these next two classes should be related.
 // Extract a base class (that shares their property of being a reference to a fifo index)
@@ -125,7 +182,11 @@ public:
     // TODO op should be set in the constructor, and should be abstracted.
     // waiters is number of waiting threads to wake up
     void wakeDeferred(int op, int waiters = 1);
-    void wakeNowIfNeeded();
+    // If a wake was deferred, wake now.  Returns the number of threads woken up,
+    // or -1 with errno set if the wake failed; zero if there was no deferred wake.
+    int wakeNowIfNeeded();
+    // Whether a wake was deferred and not yet done.
+    bool wakePending() const { return mWaiters > 0; }
     // TODO op should be set in the constructor.
     void wakeNow(int op, int waiters = 1);
 
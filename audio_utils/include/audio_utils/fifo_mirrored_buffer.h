@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_MIRRORED_BUFFER_H
+#define ANDROID_AUDIO_FIFO_MIRRORED_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A FIFO buffer in shared memory which is mapped twice, back to back, so that the byte at
+ * offset i + size() is the same memory as the byte at offset i.
+ *
+ * An audio_utils_fifo constructed from a mirrored buffer returns every slice from obtain() as a
+ * single fragment, even when it wraps around the end of the buffer, so callers which need
+ * contiguous frames don't have to copy them.
+ *
+ * The size in bytes must be a multiple of the page size; see alignFrameCount().
+ * The memory is a shared memory region, so another process may map the same buffer by
+ * constructing a mirrored buffer from a duplicate of fd().
+ */
+class audio_utils_fifo_mirrored_buffer {
+
+public:
+    /**
+     * Allocate a new mirrored buffer, initially filled with zeroes.
+     *
+     * \param frameCount Capacity of the buffer in frames > 0.
+     * \param frameSize  Size of each frame in bytes > 0,
+     *                   \p frameSize * \p frameCount must be a multiple of the page size.
+     */
+    audio_utils_fifo_mirrored_buffer(uint32_t frameCount, uint32_t frameSize);
+
+    /**
+     * Map an existing mirrored buffer, typically allocated by another process.
+     *
+     * \param fd         File descriptor of the shared memory region, as returned by fd() of the
+     *                   buffer which allocated it.  The buffer takes ownership of \p fd.
+     * \param frameCount See above.
+     * \param frameSize  See above.
+     */
+    audio_utils_fifo_mirrored_buffer(int fd, uint32_t frameCount, uint32_t frameSize);
+
+    ~audio_utils_fifo_mirrored_buffer();
+
+    audio_utils_fifo_mirrored_buffer(const audio_utils_fifo_mirrored_buffer&) = delete;
+    audio_utils_fifo_mirrored_buffer& operator=(const audio_utils_fifo_mirrored_buffer&) = delete;
+
+    /**
+     * Return the status of construction.
+     *
+     * \return Zero if the buffer is usable, or a negative error code.
+     * \retval -EINVAL  the size is zero, too large, or not a multiple of the page size
+     * \retval -ENOMEM  the address space for both mappings was not available
+     *
+     * Other negative error codes are as for the failed shared memory or mmap call.
+     */
+    int initCheck() const
+            { return mStatus; }
+
+    /**
+     * Return a pointer to the first mapping, which is immediately followed by the second.
+     *
+     * \return Pointer to the buffer, or NULL if initCheck() is non-zero.
+     */
+    void *buffer() const
+            { return mBuffer; }
+
+    /**
+     * Return the file descriptor of the shared memory region.
+     * Remains owned by the buffer, so it must be duplicated to be passed to another process.
+     *
+     * \return File descriptor, or -1 if there is none.
+     */
+    int fd() const
+            { return mFd; }
+
+    /** Return the capacity in frames. */
+    uint32_t frameCount() const
+            { return mFrameCount; }
+
+    /** Return the frame size in bytes. */
+    uint32_t frameSize() const
+            { return mFrameSize; }
+
+    /**
+     * Round a frame count up to the nearest count which is valid for a mirrored buffer.
+     *
+     * \param frameCount Desired capacity in frames.
+     * \param frameSize  Size of each frame in bytes > 0.
+     *
+     * \return The least multiple of the granularity which is >= \p frameCount,
+     *         where the granularity is the least frame count whose size is a multiple of
+     *         the page size.  Returns zero on overflow.
+     */
+    static uint32_t alignFrameCount(uint32_t frameCount, uint32_t frameSize);
+
+private:
+    // Map the shared memory region twice, and set mBuffer and mStatus.
+    void map();
+
+    const uint32_t  mFrameCount;
+    const uint32_t  mFrameSize;
+    int             mFd;        // shared memory region, or -1
+    void           *mBuffer;    // first of the two mappings, or NULL
+    int             mStatus;    // zero or a negative error code
+};
+
+#endif  // !ANDROID_AUDIO_FIFO_MIRRORED_BUFFER_H
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_MPMC_H
+#define ANDROID_AUDIO_FIFO_MPMC_H
+
+#include <audio_utils/fifo.h>
+
+/**
+ * A FIFO with one or more writers and one or more readers, each frame being read by one reader.
+ *
+ * Writers reserve frames by compare-and-swap on a shared reserve index, fill them, then commit
+ * them in reservation order to the ordinary writer's rear index; readers reserve and commit
+ * frames in the same way with a shared read reserve index and the throttling front index.
+ * A writer or reader whose predecessor has not yet committed waits for it, briefly spinning and
+ * then blocking on the committed index, so the time between obtain() and release() should be
+ * short and bounded.
+ * Readers block on the rear index while the FIFO is empty, and writers block on the front index
+ * while the FIFO is full, as for the ordinary writer and throttling reader.
+ *
+ * The writers always throttle, so frames are never lost, and there is no effective buffer size.
+ * Use only audio_utils_fifo_multi_writer and audio_utils_fifo_multi_reader with this FIFO.
+ */
+class audio_utils_fifo_mpmc : public audio_utils_fifo {
+
+    friend class audio_utils_fifo_multi_writer;
+    friend class audio_utils_fifo_multi_reader;
+
+public:
+
+    /**
+     * Construct a FIFO object: multi-process.
+     *
+     *  \param frameCount    See audio_utils_fifo.
+     *  \param frameSize     See audio_utils_fifo.
+     *  \param buffer        See audio_utils_fifo.
+     *  \param writerRear    Committed rear index, read by the readers.
+     *  \param throttleFront Committed front index, read by the writers.
+     *  \param writerReserve Rear index of frames reserved by writers.
+     *  \param readerReserve Front index of frames reserved by readers.
+     *
+     * All four indices must be initially zero, and shared by every process using the FIFO.
+     * As for audio_utils_fifo_control, each index should be in its own cache line.
+     */
+    audio_utils_fifo_mpmc(uint32_t frameCount, uint32_t frameSize, void *buffer,
+            audio_utils_fifo_index& writerRear, audio_utils_fifo_index& throttleFront,
+            audio_utils_fifo_index& writerReserve, audio_utils_fifo_index& readerReserve);
+
+    /**
+     * Construct a FIFO object: single-process.
+     *
+     *  \param frameCount    See audio_utils_fifo.
+     *  \param frameSize     See audio_utils_fifo.
+     *  \param buffer        See audio_utils_fifo.
+     */
+    audio_utils_fifo_mpmc(uint32_t frameCount, uint32_t frameSize, void *buffer);
+
+    /*virtual*/ ~audio_utils_fifo_mpmc();
+
+private:
+    /**
+     * Wait for the value of a committed index to change from \p expected,
+     * with the synchronization of that index.
+     *
+     * \return Zero, or a negative error code as for audio_utils_fifo_provider::obtain().
+     */
+    int wait(audio_utils_fifo_index& index, audio_utils_fifo_sync sync, uint32_t expected,
+            const struct timespec *timeout) const;
+
+    /** Wake all threads waiting for a committed index to change. */
+    void wake(audio_utils_fifo_index& index, audio_utils_fifo_sync sync) const;
+
+    /**
+     * Store \p end into a committed index once its value is \p start, that is once all
+     * frames reserved before [start, end) have been committed, then wake its waiters.
+     */
+    void commit(audio_utils_fifo_index& index, audio_utils_fifo_sync sync,
+            uint32_t start, uint32_t end) const;
+
+    /** Describe \p count frames from a validated index as two fragments, as for obtain(). */
+    void slice(uint32_t index, size_t count, audio_utils_iovec iovec[2]) const;
+
+    audio_utils_fifo_index&     mWriterReserve;
+    audio_utils_fifo_index&     mReaderReserve;
+
+    // only used for single-process constructor, with each index in its own cache line
+    struct {
+        audio_utils_fifo_control    mControl;
+        alignas(AUDIO_UTILS_CACHE_LINE_SIZE) audio_utils_fifo_index mWriterReserve;
+        alignas(AUDIO_UTILS_CACHE_LINE_SIZE) audio_utils_fifo_index mReaderReserve;
+    } mSingleProcessIndices;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Used to write to an audio_utils_fifo_mpmc.  There can be one or more writers per FIFO, each
+ * used by one thread at a time.
+ *
+ * Differences from audio_utils_fifo_writer:
+ *  - obtain() reserves the frames it returns, so that no other writer may obtain them.
+ *  - The first release() after obtain() commits all of the frames obtained, and frames obtained
+ *    but not released are committed as silence (zero), because a reservation can't be returned
+ *    once later frames may have been reserved by other writers.
+ *  - An obtain() with frames still reserved first commits them, as release(0) does.
+ *  - Every commit wakes the readers; there is no hysteresis or effective buffer size.
+ */
+class audio_utils_fifo_multi_writer : public audio_utils_fifo_provider {
+
+public:
+    /**
+     * \param fifo Associated FIFO.  Passed by reference because it must be non-NULL.
+     */
+    explicit audio_utils_fifo_multi_writer(audio_utils_fifo_mpmc& fifo);
+    virtual ~audio_utils_fifo_multi_writer();
+
+    /**
+     * Write to FIFO.  Same as audio_utils_fifo_writer::write().
+     */
+    ssize_t write(const void *buffer, size_t count, const struct timespec *timeout = NULL);
+
+    // Implement audio_utils_fifo_provider
+    virtual ssize_t obtain(audio_utils_iovec iovec[2], size_t count = SIZE_MAX,
+            const struct timespec *timeout = NULL);
+    virtual void release(size_t count);
+    virtual ssize_t available();
+
+private:
+    audio_utils_fifo_mpmc&  mMpmc;
+
+    // Accessed by writer only using ordinary operations
+    uint32_t    mReserved;  // start of the frames reserved by the most recent obtain()
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Used to read from an audio_utils_fifo_mpmc.  There can be one or more readers per FIFO, each
+ * used by one thread at a time, and each frame is read by only one of the readers.
+ *
+ * Differences from audio_utils_fifo_reader:
+ *  - obtain() reserves the frames it returns, so that no other reader may obtain them.
+ *  - The first release() after obtain() commits all of the frames obtained, and frames obtained
+ *    but not released are discarded, as they may not be returned to the other readers.
+ *  - An obtain() with frames still reserved first commits them, as release(0) does.
+ *  - Every commit wakes the writers; there is no hysteresis, and no frames are lost or flushed.
+ */
+class audio_utils_fifo_multi_reader : public audio_utils_fifo_provider {
+
+public:
+    /**
+     * \param fifo Associated FIFO.  Passed by reference because it must be non-NULL.
+     */
+    explicit audio_utils_fifo_multi_reader(audio_utils_fifo_mpmc& fifo);
+    virtual ~audio_utils_fifo_multi_reader();
+
+    /**
+     * Read from FIFO.  Same as audio_utils_fifo_reader::read(), without \p lost.
+     */
+    ssize_t read(void *buffer, size_t count, const struct timespec *timeout = NULL);
+
+    // Implement audio_utils_fifo_provider
+    virtual ssize_t obtain(audio_utils_iovec iovec[2], size_t count = SIZE_MAX,
+            const struct timespec *timeout = NULL);
+    virtual void release(size_t count);
+    virtual ssize_t available();
+
+private:
+    audio_utils_fifo_mpmc&  mMpmc;
+
+    // Accessed by reader only using ordinary operations
+    uint32_t    mReserved;  // start of the frames reserved by the most recent obtain()
+};
+
+#endif  // !ANDROID_AUDIO_FIFO_MPMC_H
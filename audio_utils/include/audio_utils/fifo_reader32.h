@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_READER32_H
+#define ANDROID_AUDIO_FIFO_READER32_H
+
+#include <audio_utils/fifo.h>
+
+/**
+ * Optimized FIFO reader for 32-bit words, the counterpart of audio_utils_fifo_writer32.
+ *
+ * Has these restrictions compared to the ordinary FIFO reader:
+ *  - buffer must be aligned on a 32-bit boundary
+ *  - frame size must be sizeof(int32_t)
+ *  - capacity must be power-of-2
+ *  - no blocking reads, and does not unblock a writer
+ *  - does not implement the provider interface
+ *  - does not implement the ordinary reader interface
+ *  - no implied load-acquire or store-release; must be done explicitly
+ *  - return value from read methods is the actual transfer count, never an error
+ *
+ * Usage:
+ *  - construct an ordinary FIFO that follows the restrictions above
+ *  - construct a writer32 or an ordinary writer based on that FIFO
+ *  - construct a reader32 using the FIFO
+ *  - use loadAcquire to observe the frames written, then a sequence of read and read1,
+ *    followed by storeRelease to commit if the reader throttles the writer
+ */
+class audio_utils_fifo_reader32 {
+
+public:
+    /**
+     * Construct a reader32 from a FIFO.
+     *
+     * \param fifo            Associated FIFO.  Passed by reference because it must be non-NULL.
+     * \param throttlesWriter Whether this reader throttles the writer.
+     *                        As for the ordinary reader, at most one reader may throttle the writer,
+     *                        and a non-throttling reader does not see any data written prior to its
+     *                        construction.
+     */
+    explicit audio_utils_fifo_reader32(audio_utils_fifo& fifo, bool throttlesWriter = true);
+    /*virtual*/ ~audio_utils_fifo_reader32();
+
+    /**
+     * Load the writer's rear index with memory order 'acquire', and return the number of frames
+     * which may then be read.  If the writer overran a non-throttling reader, the lost frames are
+     * skipped and added to totalLost().
+     *
+     * \return Number of frames available to read, <= capacity.
+     */
+    uint32_t loadAcquire();
+
+    /**
+     * Read an array of int32_t from FIFO.
+     * Reads at most the number of frames available at the most recent loadAcquire(),
+     * less the frames read since then.
+     *
+     * \return Actual number of frames read.
+     */
+    uint32_t read(int32_t *buffer, uint32_t count /* FIXME size_t in reader */);
+
+    /**
+     * Read one int32_t value from FIFO.
+     * Must only be called if at least one frame is available, per read().
+     */
+    int32_t read1()
+            __attribute__((no_sanitize("integer")))     // mLocalFront ++ can wrap
+    {
+        mAvailable--;
+        return mBuffer[mLocalFront++ & (mFrameCountP2 - 1)];
+    }
+
+    /**
+     * Commit all previous read and read1 so that the writer may reuse their frames,
+     * if this reader throttles the writer.  Otherwise does nothing.
+     */
+    void storeRelease() {
+        if (mThrottleFront != NULL) {
+            mThrottleFront->storeRelease(mLocalFront);
+        }
+    }
+
+    /**
+     * Set the minimum count for read() to use non-temporal stores into the caller's buffer,
+     * which bypass the cache of the reading core.  This can help for transfers which are large
+     * compared to the cache, when the caller won't soon read the frames itself.
+     * The default is zero, which means to never use non-temporal stores.
+     *
+     * \param minFrames Minimum transfer count in frames, or zero for never.
+     */
+    void setNonTemporal(uint32_t minFrames) {
+        mNonTemporalFrames = minFrames;
+    }
+
+    /**
+     * Return the total number of lost frames since construction, due to reader not keeping up with
+     * writer.  It is necessary to call loadAcquire() to observe an increase in the total.
+     *
+     * \return Total lost frames.
+     */
+    uint64_t totalLost() const
+            { return mTotalLost; }
+
+private:
+    // Accessed by reader only using ordinary operations
+    uint32_t    mLocalFront;    // frame index of first frame slot available to read, or read index
+    uint32_t    mAvailable;     // frames available at most recent loadAcquire(), less frames read
+
+    // These fields are copied from fifo for better performance (avoids an extra de-reference)
+    const uint32_t                     mFrameCountP2;
+    const int32_t              * const mBuffer;
+    audio_utils_fifo_index&            mWriterRear;
+    audio_utils_fifo_index*     const  mThrottleFront;  // NULL if we don't throttle
+
+    uint32_t    mNonTemporalFrames; // minimum count for read() to use non-temporal stores
+    uint64_t    mTotalLost;         // total lost frames
+};
+
+#endif // ANDROID_AUDIO_FIFO_READER32_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_VIEW_H
+#define ANDROID_AUDIO_FIFO_VIEW_H
+
+#include <audio_utils/fifo.h>
+
+/**
+ * Describes one virtually contiguous fragment of a slice as frames of samples of type T.
+ * Compare to audio_utils_iovec, which describes it by offset and length in frames.
+ */
+template <typename T>
+struct audio_utils_fifo_span {
+    /** Pointer to the first sample of the fragment, undefined if mFrames == 0 */
+    T          *mData;
+    /** Length of fragment in frames, 0 means fragment is empty */
+    uint32_t    mFrames;
+};
+
+/**
+ * A view of a FIFO writer or reader in terms of samples of type T, for example int16_t or float,
+ * so that callers can use pointers to samples instead of computing byte offsets from iovecs.
+ * The frame size of the FIFO must be a multiple of sizeof(T), and a frame is
+ * samplesPerFrame() consecutive samples.
+ *
+ * The view does no copying and has no state of its own; it forwards to the provider.
+ * For a reader T should be const-qualified, to reflect the read-only access to the slice.
+ *
+ * Usage:
+ *  - construct a FIFO, preferably on an audio_utils_fifo_mirrored_buffer
+ *  - construct an ordinary writer or reader on that FIFO
+ *  - construct a view of that writer or reader
+ *  - use a sequence of obtain or obtainContiguous, and release, on the view or the provider
+ */
+template <typename T>
+class audio_utils_fifo_view {
+
+public:
+    /**
+     * \param provider Associated writer or reader.  Passed by reference because it must be
+     *                 non-NULL.
+     */
+    explicit audio_utils_fifo_view(audio_utils_fifo_provider& provider) :
+        mProvider(provider), mBuffer((T *) provider.fifo().buffer()),
+        mSamplesPerFrame(provider.fifo().frameSize() / sizeof(T))
+    {
+        if (provider.fifo().frameSize() % sizeof(T) != 0) {
+            abort();
+        }
+    }
+
+    /**
+     * Obtain a slice as for audio_utils_fifo_provider::obtain(), described as samples.
+     *
+     * \param spans   Non-NULL pointer to a pair of fragment descriptors, set as for the iovec
+     *                parameter of audio_utils_fifo_provider::obtain().
+     * \param count   See audio_utils_fifo_provider::obtain.
+     * \param timeout See audio_utils_fifo_provider::obtain.
+     *
+     * \return See audio_utils_fifo_provider::obtain for 'Returns' and 'Return values'.
+     */
+    ssize_t obtain(audio_utils_fifo_span<T> spans[2], size_t count = SIZE_MAX,
+            const struct timespec *timeout = NULL)
+    {
+        audio_utils_iovec iovec[2];
+        const ssize_t ret = mProvider.obtain(iovec, count, timeout);
+        for (int i = 0; i < 2; ++i) {
+            spans[i].mData = mBuffer + (size_t) iovec[i].mOffset * mSamplesPerFrame;
+            spans[i].mFrames = ret > 0 ? iovec[i].mLength : 0;
+        }
+        return ret;
+    }
+
+    /**
+     * Obtain a slice which is a single fragment.
+     * For a mirrored FIFO this is the entire slice, and otherwise it is the initial fragment of
+     * the slice, which ends at the end of the buffer if the slice wraps around.
+     * Either way, the frames obtained may then be released as usual.
+     *
+     * \param data    Set to the pointer to the first sample, undefined if the return value is
+     *                not positive.
+     * \param count   See audio_utils_fifo_provider::obtain.
+     * \param timeout See audio_utils_fifo_provider::obtain.
+     *
+     * \return Actual number of contiguous frames available, if greater than or equal to zero,
+     *         or a negative error code as for audio_utils_fifo_provider::obtain.
+     */
+    ssize_t obtainContiguous(T **data, size_t count = SIZE_MAX,
+            const struct timespec *timeout = NULL)
+    {
+        audio_utils_iovec iovec[2];
+        const ssize_t ret = mProvider.obtain(iovec, count, timeout);
+        *data = mBuffer + (size_t) iovec[0].mOffset * mSamplesPerFrame;
+        return ret > 0 ? (ssize_t) iovec[0].mLength : ret;
+    }
+
+    /** Release frames as for audio_utils_fifo_provider::release(). */
+    void release(size_t count)
+            { mProvider.release(count); }
+
+    /** Return the available frames as for audio_utils_fifo_provider::available(). */
+    ssize_t available()
+            { return mProvider.available(); }
+
+    /** Return the number of samples of type T in each frame. */
+    uint32_t samplesPerFrame() const
+            { return mSamplesPerFrame; }
+
+    /** Return a reference to the associated provider. */
+    audio_utils_fifo_provider& provider()
+            { return mProvider; }
+
+private:
+    audio_utils_fifo_provider&  mProvider;
+
+    // These fields are copied from fifo for better performance (avoids an extra de-reference)
+    T * const                   mBuffer;
+    const uint32_t              mSamplesPerFrame;
+};
+
+#endif  // !ANDROID_AUDIO_FIFO_VIEW_H
@@ -74,6 +74,18 @@ public:
         mWriterRear.storeRelease(mLocalRear);
     }
 
+    /**
+     * Set the minimum count for write() to use non-temporal stores, which bypass the cache of
+     * the writing core.  This can help for transfers which are large compared to the cache,
+     * or when the reader is on another core and the writer won't read the frames itself.
+     * The default is zero, which means to never use non-temporal stores.
+     *
+     * \param minFrames Minimum transfer count in frames, or zero for never.
+     */
+    void setNonTemporal(uint32_t minFrames) {
+        mNonTemporalFrames = minFrames;
+    }
+
 private:
     // Accessed by writer only using ordinary operations
     uint32_t    mLocalRear; // frame index of next frame slot available to write, or write index
@@ -82,6 +94,8 @@ private:
     const uint32_t                     mFrameCountP2;
     int32_t                    * const mBuffer;
     audio_utils_fifo_index&            mWriterRear;
+
+    uint32_t    mNonTemporalFrames; // minimum count for write() to use non-temporal stores
 };
 
 #endif // ANDROID_AUDIO_FIFO_WRITER32_H
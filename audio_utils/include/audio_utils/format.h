@@ -63,6 +63,33 @@ __BEGIN_DECLS
 void memcpy_by_audio_format(void *dst, audio_format_t dst_format,
         const void *src, audio_format_t src_format, size_t count);
 
+/**
+ * A copy with conversion between two particular buffer sample formats,
+ * as returned by memcpy_by_audio_format_get_function().
+ *
+ *  \param dst        Destination buffer
+ *  \param src        Source buffer
+ *  \param count      Number of samples to copy
+ */
+typedef void (*memcpy_by_audio_format_function_t)(void *dst, const void *src, size_t count);
+
+/**
+ * Resolves a pair of buffer sample formats to the function doing the copy with conversion,
+ * so that callers repeatedly converting between the same formats can cache it,
+ * instead of dispatching on the formats for every memcpy_by_audio_format().
+ *
+ * Calling the function is equivalent to calling memcpy_by_audio_format() with the
+ * same formats, and the same restrictions on the buffers apply.
+ *
+ *  \param dst_format Destination buffer format
+ *  \param src_format Source buffer format
+ *
+ * \return the function, or NULL if the conversion is not allowed by the rules of
+ *   memcpy_by_audio_format().
+ */
+memcpy_by_audio_format_function_t memcpy_by_audio_format_get_function(
+        audio_format_t dst_format, audio_format_t src_format);
+
 
 /**
  * This function creates an index array for converting audio data with different
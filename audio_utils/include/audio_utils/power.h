@@ -62,6 +62,22 @@ float audio_utils_compute_power_mono(const void *buffer, audio_format_t format,
 
 float audio_utils_compute_energy_mono(const void *buffer, audio_format_t format, size_t samples);
 
+/**
+ * \brief Compute the signal energy of each channel of interleaved frames, in one pass.
+ *
+ *   \param buffer       buffer of interleaved frames.
+ *   \param format       one of AUDIO_FORMAT_PCM_8_BIT, AUDIO_FORMAT_PCM_16_BIT,
+ *                       AUDIO_FORMAT_PCM_24_BIT_PACKED, AUDIO_FORMAT_PCM_8_24_BIT,
+ *                       AUDIO_FORMAT_PCM_32_BIT, AUDIO_FORMAT_PCM_FLOAT.
+ *   \param frames       number of audio frames in buffer.
+ *   \param channelCount number of channels per frame, > 0.
+ *   \param energies     array of channelCount elements, set to the signal energy of
+ *                       each channel as for audio_utils_compute_energy_mono().
+ */
+
+void audio_utils_compute_energy_by_channel(const void *buffer, audio_format_t format,
+        size_t frames, uint32_t channelCount, float *energies);
+
 /**
  * \brief  Returns true if the format is supported for compute_energy_for_mono()
  *         and compute_power_for_mono().
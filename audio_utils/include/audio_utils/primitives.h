@@ -632,6 +632,91 @@ size_t memcpy_by_index_array_initialization_src_index(int8_t *idxary, size_t idx
 size_t memcpy_by_index_array_initialization_dst_index(int8_t *idxary, size_t idxcount,
         uint32_t dst_mask, uint32_t src_mask);
 
+/** The maximum number of channels of a memcpy_by_index_array_plan_t. */
+#define MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS 32
+
+/** The maximum number of byte gathers of a memcpy_by_index_array_plan_t. */
+#define MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_GATHERS 32
+
+/**
+ * Classification of the channel mapping of a memcpy_by_index_array_plan_t.
+ * A mapping with none of these flags is the identity.
+ */
+enum {
+    /** A source channel is copied to a destination channel of a different index. */
+    MEMCPY_BY_INDEX_ARRAY_REORDER = 1 << 0,
+    /** A source channel is not copied. */
+    MEMCPY_BY_INDEX_ARRAY_DROP = 1 << 1,
+    /** A source channel is copied to more than one destination channel. */
+    MEMCPY_BY_INDEX_ARRAY_DUPLICATE = 1 << 2,
+    /** A destination channel is filled with 0. */
+    MEMCPY_BY_INDEX_ARRAY_ZERO_FILL = 1 << 3,
+};
+
+/**
+ * A precomputed channel remap for memcpy_by_index_array_with_plan(), equivalent to
+ * memcpy_by_index_array() with the index array it is initialized from.
+ *
+ * Initialization classifies the mapping and, for vector backends, translates it into
+ * byte shuffles of blocks of frames, so that copies do not interpret the index array
+ * per sample. The plan is allocated by the caller, does not reference the index array,
+ * and may be copied.
+ *
+ * The fields are private, other than flags.
+ */
+typedef struct {
+    uint32_t flags;             /**< MEMCPY_BY_INDEX_ARRAY_* flags classifying the mapping */
+    uint32_t dst_channels;
+    uint32_t src_channels;
+    uint32_t sample_size;
+    int8_t idxary[MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS];
+
+    /* The byte shuffle of blocks of block_frames, or none if block_frames is 0.
+     * Each 16 byte vector of a destination block is the OR of its gathers, or 0 if it has none.
+     */
+    uint16_t block_frames;
+    uint16_t src_block_bytes;
+    uint16_t dst_block_bytes;
+    uint16_t gather_count;
+    struct {
+        uint8_t dst;            /* the vector of the destination block written */
+        uint8_t src;            /* the offset in the source block of the 16 bytes read */
+        uint8_t index[16];      /* for each byte written, the byte read, or 0xff for 0 */
+    } gather[MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_GATHERS];
+} memcpy_by_index_array_plan_t;
+
+/**
+ * Initializes a plan for memcpy_by_index_array_with_plan().
+ *
+ *  \param plan          The plan to initialize
+ *  \param dst_channels  Number of destination channels per frame,
+ *                       at most MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS
+ *  \param src_channels  Number of source channels per frame,
+ *                       at most MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS
+ *  \param idxary        Array of dst_channels indices of channels in the source frame,
+ *                       or -1 for 0, as for memcpy_by_index_array()
+ *  \param sample_size   Size of each sample in bytes.  Must be 1, 2, 3, or 4.
+ *
+ * \return 0 on success, or -EINVAL if a parameter is out of range.
+ */
+int memcpy_by_index_array_plan_init(memcpy_by_index_array_plan_t *plan,
+        uint32_t dst_channels, uint32_t src_channels,
+        const int8_t *idxary, size_t sample_size);
+
+/**
+ * Copy frames as memcpy_by_index_array() does, using a plan from
+ * memcpy_by_index_array_plan_init(). The result is bit exact with memcpy_by_index_array().
+ *
+ *  \param dst    Destination buffer
+ *  \param src    Source buffer
+ *  \param plan   The initialized plan
+ *  \param count  Number of frames to copy
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void memcpy_by_index_array_with_plan(void *dst, const void *src,
+        const memcpy_by_index_array_plan_t *plan, size_t count);
+
 /**
  * Add and clamp signed 16-bit samples.
  *
@@ -704,6 +789,162 @@ void accumulate_i32(int32_t *dst, const int32_t *src, size_t count);
  */
 void accumulate_float(float *dst, const float *src, size_t count);
 
+/**
+ * Scale signed fixed point 16-bit Q0.15 samples and add them to single-precision floating-point
+ * samples, as accumulate_float() of the output of memcpy_to_float_from_i16() multiplied by gain,
+ * but reading the source only once. Result is not clamped.
+ *
+ *  \param dst     Destination buffer
+ *  \param src     Source buffer
+ *  \param count   Number of samples to add
+ *  \param gain    Gain applied to the source samples, after conversion to float
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_i16(float *dst, const int16_t *src, size_t count, float gain);
+
+/**
+ * Scale signed fixed-point packed 24 bit Q0.23 samples and add them to single-precision
+ * floating-point samples. See accumulate_float_from_i16().
+ * The packed 24 bit input is stored in native endian format in a uint8_t byte array.
+ *
+ *  \param dst     Destination buffer
+ *  \param src     Source buffer
+ *  \param count   Number of samples to add
+ *  \param gain    Gain applied to the source samples, after conversion to float
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_p24(float *dst, const uint8_t *src, size_t count, float gain);
+
+/**
+ * Scale signed fixed-point 32-bit Q0.31 samples and add them to single-precision
+ * floating-point samples. See accumulate_float_from_i16().
+ *
+ *  \param dst     Destination buffer
+ *  \param src     Source buffer
+ *  \param count   Number of samples to add
+ *  \param gain    Gain applied to the source samples, after conversion to float
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_i32(float *dst, const int32_t *src, size_t count, float gain);
+
+/**
+ * Scale single-precision floating-point samples and add them to single-precision
+ * floating-point samples. See accumulate_float_from_i16().
+ *
+ *  \param dst     Destination buffer
+ *  \param src     Source buffer
+ *  \param count   Number of samples to add
+ *  \param gain    Gain applied to the source samples
+ *
+ * The destination and source buffers must either be completely separate (non-overlapping), or
+ * they must both start at the same address.  Partially overlapping buffers are not supported.
+ */
+void accumulate_float_from_float(float *dst, const float *src, size_t count, float gain);
+
+/**
+ * Scale interleaved signed fixed point 16-bit Q0.15 frames with a gain per channel,
+ * and add them to single-precision floating-point frames with the same channel count.
+ * Result is not clamped.
+ *
+ *  \param dst            Destination buffer
+ *  \param src            Source buffer
+ *  \param frame_count    Number of frames to add
+ *  \param channel_count  Number of channels per frame, for both buffers
+ *  \param gains          Array of channel_count gains, applied to the source samples
+ *                        of each channel after conversion to float
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_i16_by_channel(float *dst, const int16_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains);
+
+/**
+ * Scale interleaved signed fixed-point packed 24 bit Q0.23 frames with a gain per channel,
+ * and add them to single-precision floating-point frames.
+ * See accumulate_float_from_i16_by_channel().
+ *
+ *  \param dst            Destination buffer
+ *  \param src            Source buffer
+ *  \param frame_count    Number of frames to add
+ *  \param channel_count  Number of channels per frame, for both buffers
+ *  \param gains          Array of channel_count gains
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_p24_by_channel(float *dst, const uint8_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains);
+
+/**
+ * Scale interleaved signed fixed-point 32-bit Q0.31 frames with a gain per channel,
+ * and add them to single-precision floating-point frames.
+ * See accumulate_float_from_i16_by_channel().
+ *
+ *  \param dst            Destination buffer
+ *  \param src            Source buffer
+ *  \param frame_count    Number of frames to add
+ *  \param channel_count  Number of channels per frame, for both buffers
+ *  \param gains          Array of channel_count gains
+ *
+ * The destination and source buffers must be completely separate (non-overlapping).
+ */
+void accumulate_float_from_i32_by_channel(float *dst, const int32_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains);
+
+/**
+ * Scale interleaved single-precision floating-point frames with a gain per channel,
+ * and add them to single-precision floating-point frames.
+ * See accumulate_float_from_i16_by_channel().
+ *
+ *  \param dst            Destination buffer
+ *  \param src            Source buffer
+ *  \param frame_count    Number of frames to add
+ *  \param channel_count  Number of channels per frame, for both buffers
+ *  \param gains          Array of channel_count gains
+ *
+ * The destination and source buffers must either be completely separate (non-overlapping), or
+ * they must both start at the same address.  Partially overlapping buffers are not supported.
+ */
+void accumulate_float_from_float_by_channel(float *dst, const float *src,
+        size_t frame_count, uint32_t channel_count, const float *gains);
+
+/**
+ * Implementations available for the memcpy_* conversion routines
+ * and the accumulate_float_from_* mixing routines.
+ *
+ * The scalar implementation is the reference. The vector implementations of the
+ * memcpy_* routines produce bit exact results with respect to the reference.
+ * Those of the accumulate_float_from_* routines may differ in the last bit,
+ * where the multiply and add are fused. The best supported implementation
+ * is selected automatically when the library is loaded, based on the features of the CPU.
+ */
+typedef enum {
+    AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR,
+    AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1,
+    AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2,
+    AUDIO_UTILS_PRIMITIVES_BACKEND_NEON,
+} audio_utils_primitives_backend_t;
+
+/**
+ * \return the implementation currently used by the memcpy_* and accumulate_float_from_* routines.
+ */
+audio_utils_primitives_backend_t audio_utils_primitives_get_backend(void);
+
+/**
+ * Selects the implementation used by the memcpy_* and accumulate_float_from_* routines.
+ * This is intended for testing and benchmarking, and is not thread-safe:
+ * it must not be called while other threads may be converting samples.
+ *
+ *  \param backend The implementation to use.
+ *
+ * \return
+ *  0 on success,
+ *  -EINVAL if the implementation is not supported by this build or CPU.
+ */
+int audio_utils_primitives_set_backend(audio_utils_primitives_backend_t backend);
+
 /**
  * Clamp (aka hard limit or clip) a signed 32-bit sample to 16-bit range.
  */
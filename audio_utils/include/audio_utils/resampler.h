@@ -29,6 +29,12 @@ __BEGIN_DECLS
 #define RESAMPLER_QUALITY_VOIP 3
 #define RESAMPLER_QUALITY_DESKTOP 5
 
+/** the maximum number of interleaved channels of a resampler */
+#define RESAMPLER_MAX_CHANNEL_COUNT 32
+
+/** the maximum drift of the input clock trimmed by a resampler, in parts per million */
+#define RESAMPLER_MAX_DRIFT_PPM 10000
+
 struct resampler_buffer {
     union {
         void*       raw;
@@ -85,12 +91,52 @@ struct resampler_itfe {
      * \return the latency introduced by the resampler in ns.
      */
     int32_t (*delay_ns)(struct resampler_itfe *resampler);
+    /**
+     * same as resample_from_input() for float samples, nominally in [-1.0, 1.0].
+     * The samples are resampled in float, without conversion to int16_t,
+     * and the output is not clamped.
+     */
+    int (*resample_from_input_float)(struct resampler_itfe *resampler,
+                    const float *in,
+                    size_t *inFrameCount,
+                    float *out,
+                    size_t *outFrameCount);
+    /**
+     * same as resample_from_input() for Q0.31 samples.
+     * The samples are resampled in float, so have at most 24 bits of precision,
+     * and the output is clamped.
+     */
+    int (*resample_from_input_i32)(struct resampler_itfe *resampler,
+                    const int32_t *in,
+                    size_t *inFrameCount,
+                    int32_t *out,
+                    size_t *outFrameCount);
+    /**
+     * release resampler resources, as called by release_resampler().
+     */
+    void (*release)(struct resampler_itfe *resampler);
+    /**
+     * trim the ratio of the sample rates for an input clock running drift_ppm parts per million
+     * faster than its nominal sample rate, or slower if negative: the resampler then consumes
+     * inSampleRate * (1 + drift_ppm / 1e6) input frames for outSampleRate output frames.
+     * drift_ppm must be in [-RESAMPLER_MAX_DRIFT_PPM, RESAMPLER_MAX_DRIFT_PPM].
+     * The trim may change at each call without a discontinuity of the output.
+     * The first call may allocate, as the resampler may need to interpolate its phases.
+     */
+    int (*set_input_drift_ppm)(struct resampler_itfe *resampler, float drift_ppm);
 };
 
 /**
  * create a resampler according to input parameters passed.
  * If resampler_buffer_provider is not NULL only resample_from_provider() can be called.
- * If resampler_buffer_provider is NULL only resample_from_input() can be called.
+ * If resampler_buffer_provider is NULL only resample_from_input() can be called,
+ * or its float and i32 variants; the provider only supplies int16_t samples.
+ * channelCount must be in [1, RESAMPLER_MAX_CHANNEL_COUNT].
+ *
+ * On Android the resampler is based on speex, as for create_speex_resampler().
+ * Elsewhere, where speex is not available, it is that of create_polyphase_resampler().
+ * Only polyphase resamplers share their filter banks, so on Android each call designs
+ * its filter again.
  */
 int create_resampler(uint32_t inSampleRate,
           uint32_t outSampleRate,
@@ -99,6 +145,36 @@ int create_resampler(uint32_t inSampleRate,
           struct resampler_buffer_provider *provider,
           struct resampler_itfe **);
 
+/**
+ * same as create_resampler(), for the polyphase windowed-sinc resampler of audio_utils,
+ * which resamples in float whatever the sample format. Its filter is designed for the
+ * quality as speex does, and its phases are exact if the ratio of the sample rates reduces
+ * to a fraction with a numerator (the output rate) of at most 256, as for 48 kHz to 16 kHz
+ * or 24 kHz, and 44.1 kHz to 48 kHz. Otherwise the coefficients are interpolated between
+ * 128 phases. A trim by set_input_drift_ppm() never resets its state, so the output stays
+ * continuous.
+ * The filter banks are shared by the open polyphase resamplers of the same ratio of sample
+ * rates and quality, so only the first of them designs its filter bank.
+ */
+int create_polyphase_resampler(uint32_t inSampleRate,
+          uint32_t outSampleRate,
+          uint32_t channelCount,
+          uint32_t quality,
+          struct resampler_buffer_provider *provider,
+          struct resampler_itfe **);
+
+/**
+ * same as create_resampler(), for a resampler based on speex.
+ * Each call designs its filter, as speex resamplers do not share their filter banks.
+ * Only available on Android.
+ */
+int create_speex_resampler(uint32_t inSampleRate,
+          uint32_t outSampleRate,
+          uint32_t channelCount,
+          uint32_t quality,
+          struct resampler_buffer_provider *provider,
+          struct resampler_itfe **);
+
 /**
  * release resampler resources.
  */
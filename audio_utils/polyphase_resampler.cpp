@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "polyphase_resampler"
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <log/log.h>
+
+#include <audio_utils/primitives.h>
+#include <audio_utils/resampler.h>
+#include "private/primitives_backend.h"
+#include "private/resampler_cache.h"
+
+namespace {
+
+// The filter design for each quality, as that of speex.
+struct Quality {
+    uint32_t taps;      // per phase, at unit ratio
+    double cutoff;      // of the passband, relative to the lower Nyquist frequency
+    double beta;        // of the Kaiser window
+};
+
+constexpr Quality kQualities[RESAMPLER_QUALITY_MAX + 1] = {
+    {8, 0.79, 5.0},
+    {16, 0.80, 5.5},
+    {32, 0.82, 6.5},
+    {48, 0.84, 7.0},
+    {64, 0.86, 7.5},
+    {80, 0.88, 8.0},
+    {96, 0.90, 8.5},
+    {128, 0.91, 9.0},
+    {160, 0.92, 10.0},
+    {192, 0.94, 11.0},
+    {256, 0.95, 12.0},
+};
+
+// The taps of each phase are a multiple of this, as required by resampler_fir_float.
+constexpr size_t kTapsAlignment = 16;
+// The maximum taps of each phase, which limits the quality of large downsampling ratios.
+constexpr size_t kMaxTaps = 1024;
+// Ratios with more phases than this have their coefficients interpolated between
+// kInterpolatedPhases phases.
+constexpr uint32_t kMaxExactPhases = 256;
+constexpr uint32_t kInterpolatedPhases = 128;
+// The input frames appended to the history at a time, beyond those of the filter.
+constexpr size_t kChunkFrames = 256;
+
+// The modified Bessel function of the first kind of order 0.
+double besselI0(double x)
+{
+    double sum = 1.;
+    double term = 1.;
+    for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+template <typename T> float toFloat(T sample);
+template <> float toFloat(int16_t sample) { return float_from_i16(sample); }
+template <> float toFloat(int32_t sample) { return float_from_i32(sample); }
+template <> float toFloat(float sample) { return sample; }
+
+template <typename T> T fromFloat(float sample);
+template <> int16_t fromFloat(float sample) { return clamp16_from_float(sample); }
+template <> int32_t fromFloat(float sample) { return clamp32_from_float(sample); }
+template <> float fromFloat(float sample) { return sample; }
+
+// As resampler_fir_float, for the scalar backend.
+void firFloat(float *dst, const float *src, size_t stride, uint32_t channelCount,
+        const float *coefs, const float *nextCoefs, float alpha, size_t taps)
+{
+    for (uint32_t ch = 0; ch < channelCount; ++ch) {
+        const float *x = src + ch * stride;
+        float sum = 0.f;
+        for (size_t i = 0; i < taps; ++i) {
+            sum += x[i] * coefs[i];
+        }
+        if (nextCoefs != nullptr) {
+            float next = 0.f;
+            for (size_t i = 0; i < taps; ++i) {
+                next += x[i] * nextCoefs[i];
+            }
+            sum += alpha * (next - sum);
+        }
+        dst[ch] = sum;
+    }
+}
+
+// The filters of the phases of a resampler, which upsamples by up and downsamples by down.
+struct FilterBank {
+    FilterBank(uint32_t up, uint32_t down, uint32_t quality, bool interpolated);
+
+    bool mInterpolated;             // whether the phases are interpolated
+    size_t mTaps;                   // of each phase
+    std::vector<float> mCoefs;      // mTaps coefficients for each phase, and for interpolated
+                                    // phases a last one, the first advanced by a frame
+};
+
+FilterBank::FilterBank(uint32_t up, uint32_t down, uint32_t quality, bool interpolated)
+{
+    const Quality &q = kQualities[quality];
+    // Downsampling lowers the cutoff, so more taps keep the same transition band.
+    const double ratio = std::min(1., (double) up / down);
+    const size_t taps = ceil(q.taps / ratio);
+    mTaps = std::min(kMaxTaps,
+            (taps + kTapsAlignment - 1) / kTapsAlignment * kTapsAlignment);
+    mInterpolated = interpolated;
+    const uint32_t phases = mInterpolated ? kInterpolatedPhases : up;
+    const size_t rows = phases + mInterpolated;
+
+    // Each phase samples the windowed sinc at t = k - (mTaps / 2 - 1) - phase / phases
+    // for taps k, and is normalized for unity gain at DC.
+    const double fc = 0.5 * q.cutoff * ratio;   // in cycles per input frame
+    const double halfWidth = mTaps / 2;
+    const double i0Beta = besselI0(q.beta);
+    mCoefs.resize(rows * mTaps);
+    for (size_t row = 0; row < rows; ++row) {
+        float *coefs = &mCoefs[row * mTaps];
+        double sum = 0.;
+        for (size_t k = 0; k < mTaps; ++k) {
+            const double t = (double) k - (halfWidth - 1) - (double) row / phases;
+            const double x = t / halfWidth;
+            const double window = fabs(x) < 1.
+                    ? besselI0(q.beta * sqrt(1. - x * x)) / i0Beta : 0.;
+            const double sinc = t == 0. ? 1. : sin(2. * M_PI * fc * t) / (2. * M_PI * fc * t);
+            const double coef = 2. * fc * sinc * window;
+            coefs[k] = coef;
+            sum += coef;
+        }
+        for (size_t k = 0; k < mTaps; ++k) {
+            coefs[k] /= sum;
+        }
+    }
+}
+
+// The filter banks in use, shared by the resamplers of the same ratio and quality,
+// whatever their channel count and sample rates. A bank is designed for the first
+// resampler using it, and freed with the last.
+class FilterBankCache {
+public:
+    static FilterBankCache &getInstance() {
+        static FilterBankCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const FilterBank> get(uint32_t up, uint32_t down, uint32_t quality,
+            bool interpolated) {
+        std::lock_guard<std::mutex> guard(mLock);
+        const auto key = std::make_tuple(up, down, quality, interpolated);
+        std::shared_ptr<const FilterBank> bank = mBanks[key].lock();
+        if (bank == nullptr) {
+            // Designed with the lock held, so that concurrent resamplers wait for the first.
+            bank = std::make_shared<const FilterBank>(up, down, quality, interpolated);
+            mBanks[key] = bank;
+            pruneLocked();
+        }
+        return bank;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(mLock);
+        pruneLocked();
+        return mBanks.size();
+    }
+
+private:
+    // Removes the banks no longer in use.
+    void pruneLocked() {
+        for (auto it = mBanks.begin(); it != mBanks.end(); ) {
+            it = it->second.expired() ? mBanks.erase(it) : std::next(it);
+        }
+    }
+
+    std::mutex mLock;
+    std::map<std::tuple<uint32_t, uint32_t, uint32_t, bool>,
+            std::weak_ptr<const FilterBank>> mBanks;
+};
+
+// A polyphase windowed-sinc resampler.
+//
+// The resampler upsamples by mUp and downsamples by mDown, the output and input rates
+// divided by their greatest common divisor. Output frame n is at time n * mDown / mUp
+// in input frames, that is mPos + mPhase / mUp relative to the history, and is the dot product
+// of mTaps input frames centered around it with the filter phase of mPhase.
+// A drift of the input clock trims the step of mDown phases by mStepTrim phases, which
+// accumulate in mPhaseFraction, between the interpolated phases.
+//
+// The input is kept in a history of each channel, so that the dot products are contiguous.
+class PolyphaseResampler : public resampler_itfe {
+public:
+    PolyphaseResampler(uint32_t inSampleRate, uint32_t outSampleRate, uint32_t channelCount,
+            uint32_t quality, resampler_buffer_provider *provider);
+
+    // Clears the history, as for a new resampler.
+    void clear();
+    int32_t delayNs() const;
+    int setInputDriftPpm(float driftPpm);
+    int resampleFromProvider(int16_t *out, size_t *outFrameCount);
+    template <typename T>
+    int resampleFromInput(const T *in, size_t *inFrameCount, T *out, size_t *outFrameCount);
+
+private:
+    // Discards the history before mPos.
+    void compact();
+    // Appends at most frameCount interleaved frames to the history, returning those appended.
+    template <typename T>
+    size_t append(const T *in, size_t frameCount);
+    // Writes at most frameCount output frames, returning those written.
+    template <typename T>
+    size_t produce(T *out, size_t frameCount);
+
+    resampler_buffer_provider * const mProvider;
+    const uint32_t mInSampleRate;
+    const uint32_t mChannelCount;
+    uint32_t mUp;                   // output rate divided by the gcd of the rates
+    uint32_t mDown;                 // input rate divided by the gcd of the rates
+    const uint32_t mQuality;
+    std::shared_ptr<const FilterBank> mBank;
+    bool mInterpolated;             // of mBank
+    size_t mTaps;                   // of mBank
+    const float *mCoefs;            // of mBank
+    size_t mCapacity;               // frames of the history of each channel
+    std::vector<float> mHistory;    // mCapacity frames for each channel
+    size_t mFrames;                 // frames of the history in use
+    size_t mPos;                    // first frame of the history of the next output frame
+    uint32_t mPhase;                // of the next output frame, in [0, mUp)
+    double mPhaseFraction;          // of the next output frame, in [0, 1)
+    double mStepTrim;               // phases added to the step of mDown phases
+    std::vector<float> mFrame;      // an output frame
+};
+
+PolyphaseResampler::PolyphaseResampler(uint32_t inSampleRate, uint32_t outSampleRate,
+        uint32_t channelCount, uint32_t quality, resampler_buffer_provider *provider)
+    : mProvider(provider)
+    , mInSampleRate(inSampleRate)
+    , mChannelCount(channelCount)
+    , mQuality(quality)
+    , mStepTrim(0.)
+    , mFrame(channelCount)
+{
+    const uint32_t gcd = std::gcd(inSampleRate, outSampleRate);
+    mUp = outSampleRate / gcd;
+    mDown = inSampleRate / gcd;
+    mBank = FilterBankCache::getInstance().get(mUp, mDown, quality, mUp > kMaxExactPhases);
+    mInterpolated = mBank->mInterpolated;
+    mTaps = mBank->mTaps;
+    mCoefs = mBank->mCoefs.data();
+    // The history must hold the filter, and a step of mDown / mUp frames beyond it.
+    mCapacity = mTaps + mDown / mUp + 1 + kChunkFrames;
+    mHistory.resize(mCapacity * channelCount);
+    clear();
+}
+
+void PolyphaseResampler::clear()
+{
+    // The first output frame is centered on the first input frame, preceded by silence.
+    std::fill(mHistory.begin(), mHistory.end(), 0.f);
+    mFrames = mTaps / 2 - 1;
+    mPos = 0;
+    mPhase = 0;
+    mPhaseFraction = 0.;
+}
+
+int32_t PolyphaseResampler::delayNs() const
+{
+    // The input frames after the time of the next output frame.
+    const double frames = (double) mFrames - (mPos + mTaps / 2 - 1)
+            - (mPhase + mPhaseFraction) / mUp;
+    return (int32_t) (1e9 * std::max(0., frames) / mInSampleRate);
+}
+
+int PolyphaseResampler::setInputDriftPpm(float driftPpm)
+{
+    if (!(fabsf(driftPpm) <= RESAMPLER_MAX_DRIFT_PPM)) {
+        return -EINVAL;
+    }
+    if (!mInterpolated) {
+        // The trimmed phases fall between the exact ones.
+        mBank = FilterBankCache::getInstance().get(mUp, mDown, mQuality, true /* interpolated */);
+        mInterpolated = true;
+        mCoefs = mBank->mCoefs.data();
+    }
+    mStepTrim = mDown * (driftPpm * 1e-6);
+    return 0;
+}
+
+void PolyphaseResampler::compact()
+{
+    const size_t discard = std::min(mPos, mFrames);
+    if (discard == 0) {
+        return;
+    }
+    for (uint32_t ch = 0; ch < mChannelCount; ++ch) {
+        float *history = &mHistory[ch * mCapacity];
+        memmove(history, history + discard, (mFrames - discard) * sizeof(float));
+    }
+    mFrames -= discard;
+    mPos -= discard;
+}
+
+template <typename T>
+size_t PolyphaseResampler::append(const T *in, size_t frameCount)
+{
+    const size_t frames = std::min(frameCount, mCapacity - mFrames);
+    for (uint32_t ch = 0; ch < mChannelCount; ++ch) {
+        float *history = &mHistory[ch * mCapacity + mFrames];
+        const T *src = in + ch;
+        for (size_t i = 0; i < frames; ++i) {
+            history[i] = toFloat(*src);
+            src += mChannelCount;
+        }
+    }
+    mFrames += frames;
+    return frames;
+}
+
+template <typename T>
+size_t PolyphaseResampler::produce(T *out, size_t frameCount)
+{
+    auto fir = primitives_get_table()->resampler_fir_float;
+    if (fir == NULL) {
+        fir = firFloat;
+    }
+    size_t written = 0;
+    for (; written < frameCount && mPos + mTaps <= mFrames; ++written) {
+        if (!mInterpolated) {
+            fir(mFrame.data(), &mHistory[mPos], mCapacity, mChannelCount,
+                    &mCoefs[mPhase * mTaps], nullptr /* nextCoefs */, 0.f /* alpha */, mTaps);
+        } else {
+            const double phase = (mPhase + mPhaseFraction) * kInterpolatedPhases / mUp;
+            const size_t row = phase;
+            fir(mFrame.data(), &mHistory[mPos], mCapacity, mChannelCount,
+                    &mCoefs[row * mTaps], &mCoefs[(row + 1) * mTaps], phase - row, mTaps);
+        }
+        for (uint32_t ch = 0; ch < mChannelCount; ++ch) {
+            *out++ = fromFloat<T>(mFrame[ch]);
+        }
+        if (mStepTrim == 0.) {
+            mPhase += mDown;
+        } else {
+            // At most RESAMPLER_MAX_DRIFT_PPM of mDown, so the step stays positive.
+            mPhaseFraction += mStepTrim;
+            const double whole = floor(mPhaseFraction);
+            mPhaseFraction -= whole;
+            mPhase += mDown + (int32_t) whole;
+        }
+        mPos += mPhase / mUp;
+        mPhase %= mUp;
+    }
+    return written;
+}
+
+template <typename T>
+int PolyphaseResampler::resampleFromInput(const T *in, size_t *inFrameCount,
+        T *out, size_t *outFrameCount)
+{
+    size_t read = 0;
+    size_t written = 0;
+    for (;;) {
+        written += produce(out + written * mChannelCount, *outFrameCount - written);
+        if (written == *outFrameCount || read == *inFrameCount) {
+            break;
+        }
+        compact();
+        read += append(in + read * mChannelCount, *inFrameCount - read);
+    }
+    *inFrameCount = read;
+    *outFrameCount = written;
+    ALOGV("resampleFromInput() DONE in %zu out %zu", read, written);
+    return 0;
+}
+
+int PolyphaseResampler::resampleFromProvider(int16_t *out, size_t *outFrameCount)
+{
+    size_t written = 0;
+    for (;;) {
+        written += produce(out + written * mChannelCount, *outFrameCount - written);
+        if (written == *outFrameCount) {
+            break;
+        }
+        compact();
+        // The input frames for the remaining output frames, less those in the history.
+        const size_t needed = mPos + mTaps - mFrames
+                + ((*outFrameCount - written - 1) * mDown + mPhase) / mUp;
+        resampler_buffer buf;
+        buf.frame_count = std::min(needed, mCapacity - mFrames);
+        mProvider->get_next_buffer(mProvider, &buf);
+        if (buf.raw == NULL) {
+            break;
+        }
+        append(buf.i16, buf.frame_count);
+        mProvider->release_buffer(mProvider, &buf);
+    }
+    *outFrameCount = written;
+    return 0;
+}
+
+PolyphaseResampler *fromItfe(resampler_itfe *resampler)
+{
+    return static_cast<PolyphaseResampler *>(resampler);
+}
+
+void polyphase_reset(resampler_itfe *resampler)
+{
+    fromItfe(resampler)->clear();
+}
+
+int polyphase_resample_from_provider(resampler_itfe *resampler,
+        int16_t *out, size_t *outFrameCount)
+{
+    if (resampler == NULL || out == NULL || outFrameCount == NULL) {
+        return -EINVAL;
+    }
+    return fromItfe(resampler)->resampleFromProvider(out, outFrameCount);
+}
+
+template <typename T>
+int polyphase_resample_from_input(resampler_itfe *resampler,
+        T *in, size_t *inFrameCount, std::remove_const_t<T> *out, size_t *outFrameCount)
+{
+    if (resampler == NULL || in == NULL || inFrameCount == NULL ||
+            out == NULL || outFrameCount == NULL) {
+        return -EINVAL;
+    }
+    return fromItfe(resampler)->resampleFromInput<std::remove_const_t<T>>(
+            in, inFrameCount, out, outFrameCount);
+}
+
+int32_t polyphase_delay_ns(resampler_itfe *resampler)
+{
+    return fromItfe(resampler)->delayNs();
+}
+
+int polyphase_set_input_drift_ppm(resampler_itfe *resampler, float driftPpm)
+{
+    if (resampler == NULL) {
+        return -EINVAL;
+    }
+    return fromItfe(resampler)->setInputDriftPpm(driftPpm);
+}
+
+void polyphase_release(resampler_itfe *resampler)
+{
+    delete fromItfe(resampler);
+}
+
+// The resample functions of a resampler without a provider, and vice versa.
+int no_resample_from_provider(resampler_itfe *, int16_t *, size_t *outFrameCount)
+{
+    *outFrameCount = 0;
+    return -ENOSYS;
+}
+
+template <typename T>
+int no_resample_from_input(resampler_itfe *, T *, size_t *, std::remove_const_t<T> *,
+        size_t *outFrameCount)
+{
+    if (outFrameCount != NULL) {
+        *outFrameCount = 0;
+    }
+    return -ENOSYS;
+}
+
+} // namespace
+
+int create_polyphase_resampler(uint32_t inSampleRate,
+                               uint32_t outSampleRate,
+                               uint32_t channelCount,
+                               uint32_t quality,
+                               struct resampler_buffer_provider *provider,
+                               struct resampler_itfe **resampler)
+{
+    ALOGV("create_polyphase_resampler() In SR %u Out SR %u channels %u",
+            inSampleRate, outSampleRate, channelCount);
+
+    if (resampler == NULL) {
+        return -EINVAL;
+    }
+    *resampler = NULL;
+    if (quality <= RESAMPLER_QUALITY_MIN || quality >= RESAMPLER_QUALITY_MAX
+            || channelCount == 0 || channelCount > RESAMPLER_MAX_CHANNEL_COUNT
+            || inSampleRate == 0 || outSampleRate == 0) {
+        return -EINVAL;
+    }
+
+    PolyphaseResampler *rsmp = new (std::nothrow) PolyphaseResampler(
+            inSampleRate, outSampleRate, channelCount, quality, provider);
+    if (rsmp == NULL) {
+        return -ENOMEM;
+    }
+    rsmp->reset = polyphase_reset;
+    rsmp->delay_ns = polyphase_delay_ns;
+    rsmp->release = polyphase_release;
+    rsmp->set_input_drift_ppm = polyphase_set_input_drift_ppm;
+    if (provider != NULL) {
+        rsmp->resample_from_provider = polyphase_resample_from_provider;
+        rsmp->resample_from_input = no_resample_from_input<int16_t>;
+        rsmp->resample_from_input_float = no_resample_from_input<const float>;
+        rsmp->resample_from_input_i32 = no_resample_from_input<const int32_t>;
+    } else {
+        rsmp->resample_from_provider = no_resample_from_provider;
+        rsmp->resample_from_input = polyphase_resample_from_input<int16_t>;
+        rsmp->resample_from_input_float = polyphase_resample_from_input<const float>;
+        rsmp->resample_from_input_i32 = polyphase_resample_from_input<const int32_t>;
+    }
+    *resampler = rsmp;
+    return 0;
+}
+
+#ifndef __ANDROID__
+// speex is only available on Android, see resampler.c.
+int create_resampler(uint32_t inSampleRate,
+                     uint32_t outSampleRate,
+                     uint32_t channelCount,
+                     uint32_t quality,
+                     struct resampler_buffer_provider *provider,
+                     struct resampler_itfe **resampler)
+{
+    return create_polyphase_resampler(inSampleRate, outSampleRate, channelCount, quality,
+            provider, resampler);
+}
+#endif
+
+void release_resampler(struct resampler_itfe *resampler)
+{
+    if (resampler != NULL) {
+        resampler->release(resampler);
+    }
+}
+
+size_t resampler_get_filter_bank_count(void)
+{
+    return FilterBankCache::getInstance().size();
+}
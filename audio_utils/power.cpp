@@ -23,6 +23,7 @@
 
 #include <audio_utils/power.h>
 #include <audio_utils/primitives.h>
+#include "private/primitives_backend.h"
 
 #if defined(__aarch64__) || defined(__ARM_NEON__)
 #include <arm_neon.h>
@@ -135,6 +136,62 @@ inline float energyMono(const void *amplitudes, size_t size)
     return energyMonoRef<FORMAT>(amplitudes, size);
 }
 
+template <audio_format_t FORMAT>
+inline void energyByChannelRef(
+        const void *amplitudes, size_t frames, uint32_t channelCount, float *energies)
+{
+    std::fill(energies, energies + channelCount, 0.f);
+    for (size_t i = 0; i < frames; ++i) {
+        for (uint32_t ch = 0; ch < channelCount; ++ch) {
+            const float amplitude = convertToFloatAndIncrement<FORMAT>(&amplitudes);
+            energies[ch] += amplitude * amplitude;
+        }
+    }
+}
+
+// Computes the energy of each channel with the kernel of the active primitives backend,
+// if it has one for the format; a channel count of 1 computes the energy of mono samples.
+// Returns false if there is no kernel.
+inline bool energyByChannelVector(const void *amplitudes, audio_format_t format,
+        size_t frames, uint32_t channelCount, float *energies)
+{
+    const primitives_table_t *table = primitives_get_table();
+    switch (format) {
+    case AUDIO_FORMAT_PCM_8_BIT:
+        if (table->energy_from_u8 == NULL) return false;
+        table->energy_from_u8(static_cast<const uint8_t *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    case AUDIO_FORMAT_PCM_16_BIT:
+        if (table->energy_from_i16 == NULL) return false;
+        table->energy_from_i16(static_cast<const int16_t *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+        if (table->energy_from_p24 == NULL) return false;
+        table->energy_from_p24(static_cast<const uint8_t *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    case AUDIO_FORMAT_PCM_8_24_BIT:
+        if (table->energy_from_q8_23 == NULL) return false;
+        table->energy_from_q8_23(static_cast<const int32_t *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    case AUDIO_FORMAT_PCM_32_BIT:
+        if (table->energy_from_i32 == NULL) return false;
+        table->energy_from_i32(static_cast<const int32_t *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    case AUDIO_FORMAT_PCM_FLOAT:
+        if (table->energy_from_float == NULL) return false;
+        table->energy_from_float(static_cast<const float *>(amplitudes),
+                frames, channelCount, energies);
+        return true;
+    default:
+        return false;
+    }
+}
+
 // fast float power computation for ARM processors that support NEON.
 #ifdef USE_NEON
 
@@ -241,6 +298,11 @@ inline float energyMono<AUDIO_FORMAT_PCM_8_24_BIT>(const void *amplitudes, size_
 
 float audio_utils_compute_energy_mono(const void *buffer, audio_format_t format, size_t samples)
 {
+    float energy;
+    if (energyByChannelVector(buffer, format, samples, 1 /*channelCount*/, &energy)) {
+        return energy;
+    }
+
     switch (format) {
     case AUDIO_FORMAT_PCM_8_BIT:
         return energyMono<AUDIO_FORMAT_PCM_8_BIT>(buffer, samples);
@@ -265,6 +327,45 @@ float audio_utils_compute_energy_mono(const void *buffer, audio_format_t format,
     }
 }
 
+void audio_utils_compute_energy_by_channel(const void *buffer, audio_format_t format,
+        size_t frames, uint32_t channelCount, float *energies)
+{
+    LOG_ALWAYS_FATAL_IF(channelCount == 0, "invalid channelCount: %u", channelCount);
+    if (energyByChannelVector(buffer, format, frames, channelCount, energies)) {
+        return;
+    }
+
+    switch (format) {
+    case AUDIO_FORMAT_PCM_8_BIT:
+        energyByChannelRef<AUDIO_FORMAT_PCM_8_BIT>(buffer, frames, channelCount, energies);
+        break;
+
+    case AUDIO_FORMAT_PCM_16_BIT:
+        energyByChannelRef<AUDIO_FORMAT_PCM_16_BIT>(buffer, frames, channelCount, energies);
+        break;
+
+    case AUDIO_FORMAT_PCM_24_BIT_PACKED:
+        energyByChannelRef<AUDIO_FORMAT_PCM_24_BIT_PACKED>(
+                buffer, frames, channelCount, energies);
+        break;
+
+    case AUDIO_FORMAT_PCM_8_24_BIT:
+        energyByChannelRef<AUDIO_FORMAT_PCM_8_24_BIT>(buffer, frames, channelCount, energies);
+        break;
+
+    case AUDIO_FORMAT_PCM_32_BIT:
+        energyByChannelRef<AUDIO_FORMAT_PCM_32_BIT>(buffer, frames, channelCount, energies);
+        break;
+
+    case AUDIO_FORMAT_PCM_FLOAT:
+        energyByChannelRef<AUDIO_FORMAT_PCM_FLOAT>(buffer, frames, channelCount, energies);
+        break;
+
+    default:
+        LOG_ALWAYS_FATAL("invalid format: %#x", format);
+    }
+}
+
 float audio_utils_compute_power_mono(const void *buffer, audio_format_t format, size_t samples)
 {
     return audio_utils_power_from_energy(
@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <errno.h>
+
 #include <cutils/bitops.h>  /* for popcount() */
 #include <audio_utils/primitives.h>
+#include "private/primitives_backend.h"
 #include "private/private.h"
 
 void ditherAndClamp(int32_t *out, const int32_t *sums, size_t pairs)
@@ -27,7 +30,7 @@ void ditherAndClamp(int32_t *out, const int32_t *sums, size_t pairs)
     }
 }
 
-void memcpy_to_i16_from_q4_27(int16_t *dst, const int32_t *src, size_t count)
+static void memcpy_to_i16_from_q4_27_ref(int16_t *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clamp16(*src++ >> 12);
@@ -57,28 +60,28 @@ void memcpy_to_u8_from_float(uint8_t *dst, const float *src, size_t count)
     }
 }
 
-void memcpy_to_i16_from_i32(int16_t *dst, const int32_t *src, size_t count)
+static void memcpy_to_i16_from_i32_ref(int16_t *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = *src++ >> 16;
     }
 }
 
-void memcpy_to_i16_from_float(int16_t *dst, const float *src, size_t count)
+static void memcpy_to_i16_from_float_ref(int16_t *dst, const float *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clamp16_from_float(*src++);
     }
 }
 
-void memcpy_to_float_from_q4_27(float *dst, const int32_t *src, size_t count)
+static void memcpy_to_float_from_q4_27_ref(float *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = float_from_q4_27(*src++);
     }
 }
 
-void memcpy_to_float_from_i16(float *dst, const int16_t *src, size_t count)
+static void memcpy_to_float_from_i16_ref(float *dst, const int16_t *src, size_t count)
 {
     dst += count;
     src += count;
@@ -96,7 +99,7 @@ void memcpy_to_float_from_u8(float *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_float_from_p24(float *dst, const uint8_t *src, size_t count)
+static void memcpy_to_float_from_p24_ref(float *dst, const uint8_t *src, size_t count)
 {
     dst += count;
     src += count * 3;
@@ -106,7 +109,7 @@ void memcpy_to_float_from_p24(float *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_i16_from_p24(int16_t *dst, const uint8_t *src, size_t count)
+static void memcpy_to_i16_from_p24_ref(int16_t *dst, const uint8_t *src, size_t count)
 {
     for (; count > 0; --count) {
 #if HAVE_BIG_ENDIAN
@@ -118,7 +121,7 @@ void memcpy_to_i16_from_p24(int16_t *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_i32_from_p24(int32_t *dst, const uint8_t *src, size_t count)
+static void memcpy_to_i32_from_p24_ref(int32_t *dst, const uint8_t *src, size_t count)
 {
     dst += count;
     src += count * 3;
@@ -132,7 +135,7 @@ void memcpy_to_i32_from_p24(int32_t *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_p24_from_i16(uint8_t *dst, const int16_t *src, size_t count)
+static void memcpy_to_p24_from_i16_ref(uint8_t *dst, const int16_t *src, size_t count)
 {
     dst += count * 3;
     src += count;
@@ -151,7 +154,7 @@ void memcpy_to_p24_from_i16(uint8_t *dst, const int16_t *src, size_t count)
     }
 }
 
-void memcpy_to_p24_from_float(uint8_t *dst, const float *src, size_t count)
+static void memcpy_to_p24_from_float_ref(uint8_t *dst, const float *src, size_t count)
 {
     for (; count > 0; --count) {
         int32_t ival = clamp24_from_float(*src++);
@@ -168,7 +171,7 @@ void memcpy_to_p24_from_float(uint8_t *dst, const float *src, size_t count)
     }
 }
 
-void memcpy_to_p24_from_q8_23(uint8_t *dst, const int32_t *src, size_t count)
+static void memcpy_to_p24_from_q8_23_ref(uint8_t *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         int32_t ival = clamp24_from_q8_23(*src++);
@@ -185,7 +188,7 @@ void memcpy_to_p24_from_q8_23(uint8_t *dst, const int32_t *src, size_t count)
     }
 }
 
-void memcpy_to_p24_from_i32(uint8_t *dst, const int32_t *src, size_t count)
+static void memcpy_to_p24_from_i32_ref(uint8_t *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         int32_t ival = *src++ >> 8;
@@ -202,7 +205,7 @@ void memcpy_to_p24_from_i32(uint8_t *dst, const int32_t *src, size_t count)
     }
 }
 
-void memcpy_to_q8_23_from_i16(int32_t *dst, const int16_t *src, size_t count)
+static void memcpy_to_q8_23_from_i16_ref(int32_t *dst, const int16_t *src, size_t count)
 {
     dst += count;
     src += count;
@@ -211,14 +214,15 @@ void memcpy_to_q8_23_from_i16(int32_t *dst, const int16_t *src, size_t count)
     }
 }
 
-void memcpy_to_q8_23_from_float_with_clamp(int32_t *dst, const float *src, size_t count)
+static void memcpy_to_q8_23_from_float_with_clamp_ref(
+        int32_t *dst, const float *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clamp24_from_float(*src++);
     }
 }
 
-void memcpy_to_q8_23_from_p24(int32_t *dst, const uint8_t *src, size_t count)
+static void memcpy_to_q8_23_from_p24_ref(int32_t *dst, const uint8_t *src, size_t count)
 {
     dst += count;
     src += count * 3;
@@ -232,21 +236,21 @@ void memcpy_to_q8_23_from_p24(int32_t *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_q4_27_from_float(int32_t *dst, const float *src, size_t count)
+static void memcpy_to_q4_27_from_float_ref(int32_t *dst, const float *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clampq4_27_from_float(*src++);
     }
 }
 
-void memcpy_to_i16_from_q8_23(int16_t *dst, const int32_t *src, size_t count)
+static void memcpy_to_i16_from_q8_23_ref(int16_t *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clamp16(*src++ >> 8);
     }
 }
 
-void memcpy_to_float_from_q8_23(float *dst, const int32_t *src, size_t count)
+static void memcpy_to_float_from_q8_23_ref(float *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = float_from_q8_23(*src++);
@@ -262,7 +266,7 @@ void memcpy_to_i32_from_u8(int32_t *dst, const uint8_t *src, size_t count)
     }
 }
 
-void memcpy_to_i32_from_i16(int32_t *dst, const int16_t *src, size_t count)
+static void memcpy_to_i32_from_i16_ref(int32_t *dst, const int16_t *src, size_t count)
 {
     dst += count;
     src += count;
@@ -271,14 +275,14 @@ void memcpy_to_i32_from_i16(int32_t *dst, const int16_t *src, size_t count)
     }
 }
 
-void memcpy_to_i32_from_float(int32_t *dst, const float *src, size_t count)
+static void memcpy_to_i32_from_float_ref(int32_t *dst, const float *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = clamp32_from_float(*src++);
     }
 }
 
-void memcpy_to_float_from_i32(float *dst, const int32_t *src, size_t count)
+static void memcpy_to_float_from_i32_ref(float *dst, const int32_t *src, size_t count)
 {
     for (; count > 0; --count) {
         *dst++ = float_from_i32(*src++);
@@ -562,6 +566,141 @@ size_t memcpy_by_index_array_initialization_dst_index(int8_t *idxary, size_t idx
     return dst_idx;
 }
 
+/* Translates the mapping of a plan into byte shuffles of blocks of frames,
+ * leaving block_frames 0 if it needs too many gathers.
+ */
+static void memcpy_by_index_array_plan_shuffle(memcpy_by_index_array_plan_t *plan)
+{
+    const size_t src_frame_bytes = plan->src_channels * plan->sample_size;
+    const size_t dst_frame_bytes = plan->dst_channels * plan->sample_size;
+    plan->block_frames = 0;
+    plan->gather_count = 0;
+    if (src_frame_bytes == 0 || dst_frame_bytes == 0) {
+        return;
+    }
+
+    /* the fewest frames reading at least one vector and writing whole vectors */
+    size_t frames = 1;
+    while ((frames * dst_frame_bytes) % 16 != 0 || frames * src_frame_bytes < 16) {
+        ++frames;
+    }
+    const size_t src_block_bytes = frames * src_frame_bytes;
+    const size_t dst_block_bytes = frames * dst_frame_bytes;
+    if (src_block_bytes - 16 > UINT8_MAX || dst_block_bytes / 16 > UINT8_MAX + 1) {
+        return;
+    }
+
+    size_t count = 0;
+    for (size_t vector = 0; vector < dst_block_bytes / 16; ++vector) {
+        /* the byte of the source block read for each byte of the vector, or -1 */
+        int source[16];
+        for (size_t i = 0; i < 16; ++i) {
+            const size_t dst_byte = vector * 16 + i;
+            const size_t frame = dst_byte / dst_frame_bytes;
+            const size_t channel = dst_byte % dst_frame_bytes / plan->sample_size;
+            const int index = plan->idxary[channel];
+            source[i] = index < 0 ? -1 : (int)(frame * src_frame_bytes
+                    + index * plan->sample_size + dst_byte % plan->sample_size);
+        }
+        /* greedily cover the bytes read, lowest first, with reads within the block */
+        for (;;) {
+            int lowest = -1;
+            for (size_t i = 0; i < 16; ++i) {
+                if (source[i] >= 0 && (lowest < 0 || source[i] < lowest)) {
+                    lowest = source[i];
+                }
+            }
+            if (lowest < 0) {
+                break;
+            }
+            if (count == MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_GATHERS) {
+                return;
+            }
+            const int offset = lowest < (int)src_block_bytes - 16
+                    ? lowest : (int)src_block_bytes - 16;
+            plan->gather[count].dst = vector;
+            plan->gather[count].src = offset;
+            for (size_t i = 0; i < 16; ++i) {
+                if (source[i] >= offset && source[i] < offset + 16) {
+                    plan->gather[count].index[i] = source[i] - offset;
+                    source[i] = -1;
+                } else {
+                    plan->gather[count].index[i] = 0xff;
+                }
+            }
+            ++count;
+        }
+    }
+    plan->block_frames = frames;
+    plan->src_block_bytes = src_block_bytes;
+    plan->dst_block_bytes = dst_block_bytes;
+    plan->gather_count = count;
+}
+
+int memcpy_by_index_array_plan_init(memcpy_by_index_array_plan_t *plan,
+        uint32_t dst_channels, uint32_t src_channels,
+        const int8_t *idxary, size_t sample_size)
+{
+    if (dst_channels > MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS
+            || src_channels > MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS
+            || sample_size < 1 || sample_size > 4) {
+        return -EINVAL;
+    }
+    uint32_t copies[MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS] = {};
+    uint32_t flags = 0;
+    for (uint32_t i = 0; i < dst_channels; ++i) {
+        const int index = idxary[i];
+        if (index >= (int)src_channels) {
+            return -EINVAL;
+        }
+        if (index < 0) {
+            flags |= MEMCPY_BY_INDEX_ARRAY_ZERO_FILL;
+            continue;
+        }
+        if (index != (int)i) {
+            flags |= MEMCPY_BY_INDEX_ARRAY_REORDER;
+        }
+        if (copies[index]++ > 0) {
+            flags |= MEMCPY_BY_INDEX_ARRAY_DUPLICATE;
+        }
+    }
+    for (uint32_t i = 0; i < src_channels; ++i) {
+        if (copies[i] == 0) {
+            flags |= MEMCPY_BY_INDEX_ARRAY_DROP;
+        }
+    }
+
+    memset(plan, 0, sizeof(*plan));
+    plan->flags = flags;
+    plan->dst_channels = dst_channels;
+    plan->src_channels = src_channels;
+    plan->sample_size = sample_size;
+    memcpy(plan->idxary, idxary, dst_channels * sizeof(*idxary));
+    if (flags != 0) {
+        memcpy_by_index_array_plan_shuffle(plan);
+    }
+    return 0;
+}
+
+void memcpy_by_index_array_with_plan(void *dst, const void *src,
+        const memcpy_by_index_array_plan_t *plan, size_t count)
+{
+    if (plan->flags == 0) { /* identity */
+        memcpy(dst, src, count * plan->dst_channels * plan->sample_size);
+        return;
+    }
+    const primitives_table_t *table = primitives_get_table();
+    if (plan->block_frames != 0 && table->memcpy_by_index_array_with_plan != NULL) {
+        const size_t blocks = count / plan->block_frames;
+        table->memcpy_by_index_array_with_plan(dst, src, plan, blocks);
+        dst = (uint8_t *)dst + blocks * plan->dst_block_bytes;
+        src = (const uint8_t *)src + blocks * plan->src_block_bytes;
+        count -= blocks * plan->block_frames;
+    }
+    memcpy_by_index_array(dst, plan->dst_channels, src, plan->src_channels,
+            plan->idxary, plan->sample_size, count);
+}
+
 void accumulate_i16(int16_t *dst, const int16_t *src, size_t count) {
     while (count--) {
         *dst = clamp16((int32_t)*dst + *src++);
@@ -616,3 +755,358 @@ void accumulate_float(float *dst, const float *src, size_t count) {
         *dst++ += *src++;
     }
 }
+
+static void accumulate_float_from_i16_ref(float *dst, const int16_t *src, size_t count,
+        float gain)
+{
+    const float g = gain * (1.f / (1 << 15));
+    for (; count > 0; --count) {
+        *dst++ += *src++ * g;
+    }
+}
+
+static void accumulate_float_from_p24_ref(float *dst, const uint8_t *src, size_t count,
+        float gain)
+{
+    const float g = gain * (1.f / (1UL << 31));
+    for (; count > 0; --count) {
+        *dst++ += i32_from_p24(src) * g;
+        src += 3;
+    }
+}
+
+static void accumulate_float_from_i32_ref(float *dst, const int32_t *src, size_t count,
+        float gain)
+{
+    const float g = gain * (1.f / (1UL << 31));
+    for (; count > 0; --count) {
+        *dst++ += *src++ * g;
+    }
+}
+
+static void accumulate_float_from_float_ref(float *dst, const float *src, size_t count,
+        float gain)
+{
+    for (; count > 0; --count) {
+        *dst++ += *src++ * gain;
+    }
+}
+
+static void accumulate_float_from_i16_by_channel_ref(float *dst, const int16_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    for (; frame_count > 0; --frame_count) {
+        for (uint32_t ch = 0; ch < channel_count; ++ch) {
+            *dst++ += *src++ * (gains[ch] * (1.f / (1 << 15)));
+        }
+    }
+}
+
+static void accumulate_float_from_p24_by_channel_ref(float *dst, const uint8_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    for (; frame_count > 0; --frame_count) {
+        for (uint32_t ch = 0; ch < channel_count; ++ch) {
+            *dst++ += i32_from_p24(src) * (gains[ch] * (1.f / (1UL << 31)));
+            src += 3;
+        }
+    }
+}
+
+static void accumulate_float_from_i32_by_channel_ref(float *dst, const int32_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    for (; frame_count > 0; --frame_count) {
+        for (uint32_t ch = 0; ch < channel_count; ++ch) {
+            *dst++ += *src++ * (gains[ch] * (1.f / (1UL << 31)));
+        }
+    }
+}
+
+static void accumulate_float_from_float_by_channel_ref(float *dst, const float *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    for (; frame_count > 0; --frame_count) {
+        for (uint32_t ch = 0; ch < channel_count; ++ch) {
+            *dst++ += *src++ * gains[ch];
+        }
+    }
+}
+
+static const primitives_table_t scalar_table = {
+    .memcpy_to_i16_from_q4_27 = memcpy_to_i16_from_q4_27_ref,
+    .memcpy_to_i16_from_i32 = memcpy_to_i16_from_i32_ref,
+    .memcpy_to_i16_from_float = memcpy_to_i16_from_float_ref,
+    .memcpy_to_float_from_q4_27 = memcpy_to_float_from_q4_27_ref,
+    .memcpy_to_float_from_i16 = memcpy_to_float_from_i16_ref,
+    .memcpy_to_p24_from_float = memcpy_to_p24_from_float_ref,
+    .memcpy_to_q8_23_from_i16 = memcpy_to_q8_23_from_i16_ref,
+    .memcpy_to_q8_23_from_float_with_clamp = memcpy_to_q8_23_from_float_with_clamp_ref,
+    .memcpy_to_q4_27_from_float = memcpy_to_q4_27_from_float_ref,
+    .memcpy_to_i16_from_q8_23 = memcpy_to_i16_from_q8_23_ref,
+    .memcpy_to_float_from_q8_23 = memcpy_to_float_from_q8_23_ref,
+    .memcpy_to_i32_from_i16 = memcpy_to_i32_from_i16_ref,
+    .memcpy_to_i32_from_float = memcpy_to_i32_from_float_ref,
+    .memcpy_to_float_from_i32 = memcpy_to_float_from_i32_ref,
+    .memcpy_to_float_from_p24 = memcpy_to_float_from_p24_ref,
+    .memcpy_to_i16_from_p24 = memcpy_to_i16_from_p24_ref,
+    .memcpy_to_i32_from_p24 = memcpy_to_i32_from_p24_ref,
+    .memcpy_to_p24_from_i16 = memcpy_to_p24_from_i16_ref,
+    .memcpy_to_p24_from_q8_23 = memcpy_to_p24_from_q8_23_ref,
+    .memcpy_to_p24_from_i32 = memcpy_to_p24_from_i32_ref,
+    .memcpy_to_q8_23_from_p24 = memcpy_to_q8_23_from_p24_ref,
+    .accumulate_float_from_i16 = accumulate_float_from_i16_ref,
+    .accumulate_float_from_p24 = accumulate_float_from_p24_ref,
+    .accumulate_float_from_i32 = accumulate_float_from_i32_ref,
+    .accumulate_float_from_float = accumulate_float_from_float_ref,
+    .accumulate_float_from_i16_by_channel = accumulate_float_from_i16_by_channel_ref,
+    .accumulate_float_from_p24_by_channel = accumulate_float_from_p24_by_channel_ref,
+    .accumulate_float_from_i32_by_channel = accumulate_float_from_i32_by_channel_ref,
+    .accumulate_float_from_float_by_channel = accumulate_float_from_float_by_channel_ref,
+};
+
+/* The table of the selected vector backend, with the scalar reference for
+ * any entries the backend does not implement.
+ */
+static primitives_table_t vector_table;
+
+/* The active implementation. It starts out as the scalar reference, so that the
+ * conversions are usable even by constructors running before ours.
+ */
+static const primitives_table_t *active_table = &scalar_table;
+static audio_utils_primitives_backend_t active_backend = AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR;
+
+static int is_backend_supported(audio_utils_primitives_backend_t backend)
+{
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+    __builtin_cpu_init(); /* may be called before the cpu model constructor */
+#endif
+    switch (backend) {
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR:
+        return 1;
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1:
+        return __builtin_cpu_supports("sse4.1");
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef PRIMITIVES_HAVE_NEON_BACKEND
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_NEON:
+        return 1;
+#endif
+    default:
+        return 0;
+    }
+}
+
+audio_utils_primitives_backend_t audio_utils_primitives_get_backend(void)
+{
+    return active_backend;
+}
+
+int audio_utils_primitives_set_backend(audio_utils_primitives_backend_t backend)
+{
+    if (!is_backend_supported(backend)) {
+        return -EINVAL;
+    }
+    if (backend == AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR) {
+        active_table = &scalar_table;
+        active_backend = backend;
+        return 0;
+    }
+    primitives_table_t table = scalar_table;
+    switch (backend) {
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1:
+        primitives_backend_sse4_1(&table);
+        break;
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2:
+        /* AVX2 implies SSE4.1, whose kernels are kept for entries AVX2 does not widen. */
+        primitives_backend_sse4_1(&table);
+        primitives_backend_avx2(&table);
+        break;
+#endif
+#ifdef PRIMITIVES_HAVE_NEON_BACKEND
+    case AUDIO_UTILS_PRIMITIVES_BACKEND_NEON:
+        primitives_backend_neon(&table);
+        break;
+#endif
+    default:
+        break;
+    }
+    active_table = &scalar_table; /* while vector_table is rewritten */
+    vector_table = table;
+    active_table = &vector_table;
+    active_backend = backend;
+    return 0;
+}
+
+const primitives_table_t *primitives_get_table(void)
+{
+    return active_table;
+}
+
+__attribute__((constructor))
+static void primitives_select_backend(void)
+{
+    /* in order of preference */
+    static const audio_utils_primitives_backend_t backends[] = {
+        AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2,
+        AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1,
+        AUDIO_UTILS_PRIMITIVES_BACKEND_NEON,
+    };
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); ++i) {
+        if (audio_utils_primitives_set_backend(backends[i]) == 0) {
+            return;
+        }
+    }
+}
+
+void memcpy_to_i16_from_q4_27(int16_t *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_i16_from_q4_27(dst, src, count);
+}
+
+void memcpy_to_i16_from_i32(int16_t *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_i16_from_i32(dst, src, count);
+}
+
+void memcpy_to_i16_from_float(int16_t *dst, const float *src, size_t count)
+{
+    active_table->memcpy_to_i16_from_float(dst, src, count);
+}
+
+void memcpy_to_float_from_q4_27(float *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_float_from_q4_27(dst, src, count);
+}
+
+void memcpy_to_float_from_i16(float *dst, const int16_t *src, size_t count)
+{
+    active_table->memcpy_to_float_from_i16(dst, src, count);
+}
+
+void memcpy_to_p24_from_float(uint8_t *dst, const float *src, size_t count)
+{
+    active_table->memcpy_to_p24_from_float(dst, src, count);
+}
+
+void memcpy_to_q8_23_from_i16(int32_t *dst, const int16_t *src, size_t count)
+{
+    active_table->memcpy_to_q8_23_from_i16(dst, src, count);
+}
+
+void memcpy_to_q8_23_from_float_with_clamp(int32_t *dst, const float *src, size_t count)
+{
+    active_table->memcpy_to_q8_23_from_float_with_clamp(dst, src, count);
+}
+
+void memcpy_to_q4_27_from_float(int32_t *dst, const float *src, size_t count)
+{
+    active_table->memcpy_to_q4_27_from_float(dst, src, count);
+}
+
+void memcpy_to_i16_from_q8_23(int16_t *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_i16_from_q8_23(dst, src, count);
+}
+
+void memcpy_to_float_from_q8_23(float *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_float_from_q8_23(dst, src, count);
+}
+
+void memcpy_to_i32_from_i16(int32_t *dst, const int16_t *src, size_t count)
+{
+    active_table->memcpy_to_i32_from_i16(dst, src, count);
+}
+
+void memcpy_to_i32_from_float(int32_t *dst, const float *src, size_t count)
+{
+    active_table->memcpy_to_i32_from_float(dst, src, count);
+}
+
+void memcpy_to_float_from_i32(float *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_float_from_i32(dst, src, count);
+}
+
+void memcpy_to_float_from_p24(float *dst, const uint8_t *src, size_t count)
+{
+    active_table->memcpy_to_float_from_p24(dst, src, count);
+}
+
+void memcpy_to_i16_from_p24(int16_t *dst, const uint8_t *src, size_t count)
+{
+    active_table->memcpy_to_i16_from_p24(dst, src, count);
+}
+
+void memcpy_to_i32_from_p24(int32_t *dst, const uint8_t *src, size_t count)
+{
+    active_table->memcpy_to_i32_from_p24(dst, src, count);
+}
+
+void memcpy_to_p24_from_i16(uint8_t *dst, const int16_t *src, size_t count)
+{
+    active_table->memcpy_to_p24_from_i16(dst, src, count);
+}
+
+void memcpy_to_p24_from_q8_23(uint8_t *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_p24_from_q8_23(dst, src, count);
+}
+
+void memcpy_to_p24_from_i32(uint8_t *dst, const int32_t *src, size_t count)
+{
+    active_table->memcpy_to_p24_from_i32(dst, src, count);
+}
+
+void memcpy_to_q8_23_from_p24(int32_t *dst, const uint8_t *src, size_t count)
+{
+    active_table->memcpy_to_q8_23_from_p24(dst, src, count);
+}
+
+void accumulate_float_from_i16(float *dst, const int16_t *src, size_t count, float gain)
+{
+    active_table->accumulate_float_from_i16(dst, src, count, gain);
+}
+
+void accumulate_float_from_p24(float *dst, const uint8_t *src, size_t count, float gain)
+{
+    active_table->accumulate_float_from_p24(dst, src, count, gain);
+}
+
+void accumulate_float_from_i32(float *dst, const int32_t *src, size_t count, float gain)
+{
+    active_table->accumulate_float_from_i32(dst, src, count, gain);
+}
+
+void accumulate_float_from_float(float *dst, const float *src, size_t count, float gain)
+{
+    active_table->accumulate_float_from_float(dst, src, count, gain);
+}
+
+void accumulate_float_from_i16_by_channel(float *dst, const int16_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    active_table->accumulate_float_from_i16_by_channel(dst, src, frame_count, channel_count, gains);
+}
+
+void accumulate_float_from_p24_by_channel(float *dst, const uint8_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    active_table->accumulate_float_from_p24_by_channel(dst, src, frame_count, channel_count, gains);
+}
+
+void accumulate_float_from_i32_by_channel(float *dst, const int32_t *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    active_table->accumulate_float_from_i32_by_channel(dst, src, frame_count, channel_count, gains);
+}
+
+void accumulate_float_from_float_by_channel(float *dst, const float *src,
+        size_t frame_count, uint32_t channel_count, const float *gains)
+{
+    active_table->accumulate_float_from_float_by_channel(dst, src, frame_count, channel_count, gains);
+}
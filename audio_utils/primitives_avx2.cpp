@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <immintrin.h>
+
+#include "private/primitives_backend.h"
+
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+
+// Only installed by primitives.c after checking the CPU supports AVX2.
+#define PRIMITIVES_TARGET __attribute__((target("avx2")))
+#include "private/primitives_vector.h"
+#include "private/power_vector.h"
+#include "private/resampler_vector.h"
+
+namespace {
+
+struct Avx2 {
+    static constexpr size_t kLanes = 8;
+    typedef __m256 F;
+    typedef __m256i I;
+
+    static PRIMITIVES_TARGET F loadF(const float *src) {
+        return _mm256_loadu_ps(src);
+    }
+    static PRIMITIVES_TARGET void storeF(float *dst, F v) {
+        _mm256_storeu_ps(dst, v);
+    }
+    static PRIMITIVES_TARGET I loadI32(const int32_t *src) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+    }
+    static PRIMITIVES_TARGET void storeI32(int32_t *dst, I v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+    }
+    static PRIMITIVES_TARGET I loadI16(const int16_t *src) {
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    }
+    static PRIMITIVES_TARGET void storeI16(int16_t *dst, I v) {
+        // packs operates within 128 bit lanes, so pack the two halves explicitly.
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packs_epi32(
+                _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+    }
+    static PRIMITIVES_TARGET void loadP24(const uint8_t *src, I *v) {
+        // As Sse4_1::loadP24(), with the spreading done on pairs of realigned vectors.
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+        const __m256i spread = _mm256_setr_epi8(
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+        v[0] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                _mm256_castsi128_si256(a), _mm_alignr_epi8(b, a, 12), 1), spread);
+        v[1] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_alignr_epi8(c, b, 8)), _mm_srli_si128(c, 4), 1),
+                spread);
+    }
+    static PRIMITIVES_TARGET void storeP24(uint8_t *dst, const I *v) {
+        // Each 128 bit lane packs to 12 bytes, which are then joined as in Sse4_1::storeP24().
+        const __m256i pack = _mm256_setr_epi8(
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i p01 = _mm256_shuffle_epi8(v[0], pack);
+        const __m256i p23 = _mm256_shuffle_epi8(v[1], pack);
+        const __m128i p0 = _mm256_castsi256_si128(p01);
+        const __m128i p1 = _mm256_extracti128_si256(p01, 1);
+        const __m128i p2 = _mm256_castsi256_si128(p23);
+        const __m128i p3 = _mm256_extracti128_si256(p23, 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16),
+                _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32),
+                _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+    }
+    static PRIMITIVES_TARGET void loadU8(const uint8_t *src, I *v) {
+        // See Sse4_1::loadU8().
+        const __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)),
+                _mm_set1_epi8(-128));
+        v[0] = _mm256_cvtepi8_epi32(b);
+        v[1] = _mm256_cvtepi8_epi32(_mm_srli_si128(b, 8));
+    }
+    static PRIMITIVES_TARGET F dupF(float f) {
+        return _mm256_set1_ps(f);
+    }
+    static PRIMITIVES_TARGET F mulF(F a, F b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static PRIMITIVES_TARGET F mulAddF(F a, F b, F c) {
+        // Not fused, as FMA is a separate CPU feature.
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+    }
+    static PRIMITIVES_TARGET F toF(I v) {
+        return _mm256_cvtepi32_ps(v);
+    }
+    static PRIMITIVES_TARGET I dupI(int32_t i) {
+        return _mm256_set1_epi32(i);
+    }
+    static PRIMITIVES_TARGET I clampI(I x, I lo, I hi) {
+        return _mm256_max_epi32(_mm256_min_epi32(x, hi), lo);
+    }
+    static PRIMITIVES_TARGET F clampF(F x, F lo, F hi) {
+        // minps returns the second operand if either is NaN, like fminf(NaN, hi).
+        return _mm256_max_ps(_mm256_min_ps(x, hi), lo);
+    }
+    static PRIMITIVES_TARGET I roundI32(F x) {
+        // See Sse4_1::roundI32().
+        const __m256 half = _mm256_or_ps(_mm256_and_ps(x, _mm256_set1_ps(-0.f)),
+                _mm256_set1_ps(0.49999997f));
+        const __m256i rounded = _mm256_cvttps_epi32(_mm256_add_ps(x, half));
+        return _mm256_xor_si256(rounded, _mm256_castps_si256(
+                _mm256_cmp_ps(x, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ)));
+    }
+    template <int N>
+    static PRIMITIVES_TARGET I shrI(I v) {
+        return _mm256_srai_epi32(v, N);
+    }
+    template <int N>
+    static PRIMITIVES_TARGET I shlI(I v) {
+        return _mm256_slli_epi32(v, N);
+    }
+};
+
+} // namespace
+
+void primitives_backend_avx2(primitives_table_t *table)
+{
+    fillPrimitivesTable<Avx2>(table);
+    fillPowerTable<Avx2>(table);
+    fillResamplerTable<Avx2>(table);
+}
+
+#endif // PRIMITIVES_HAVE_X86_BACKENDS
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "private/primitives_backend.h"
+
+#ifdef PRIMITIVES_HAVE_NEON_BACKEND
+
+#include <arm_neon.h>
+
+// NEON is part of the AArch64 baseline.
+#define PRIMITIVES_TARGET
+#include "private/primitives_vector.h"
+#include "private/channels_vector.h"
+#include "private/power_vector.h"
+#include "private/resampler_vector.h"
+
+namespace {
+
+struct Neon {
+    static constexpr size_t kLanes = 4;
+    typedef float32x4_t F;
+    typedef int32x4_t I;
+
+    static F loadF(const float *src) {
+        return vld1q_f32(src);
+    }
+    static void storeF(float *dst, F v) {
+        vst1q_f32(dst, v);
+    }
+    static I loadI32(const int32_t *src) {
+        return vld1q_s32(src);
+    }
+    static void storeI32(int32_t *dst, I v) {
+        vst1q_s32(dst, v);
+    }
+    static I loadI16(const int16_t *src) {
+        return vmovl_s16(vld1_s16(src));
+    }
+    static void storeI16(int16_t *dst, I v) {
+        vst1_s16(dst, vqmovn_s32(v));
+    }
+    static void loadP24(const uint8_t *src, I *v) {
+        // ld3 splits the bytes of the 16 samples into three planes, then each
+        // lane gathers its bytes from the planes, with index 0xff giving 0.
+        static const uint8_t index[4][16] = {
+            {0xff, 0, 16, 32, 0xff, 1, 17, 33, 0xff, 2, 18, 34, 0xff, 3, 19, 35},
+            {0xff, 4, 20, 36, 0xff, 5, 21, 37, 0xff, 6, 22, 38, 0xff, 7, 23, 39},
+            {0xff, 8, 24, 40, 0xff, 9, 25, 41, 0xff, 10, 26, 42, 0xff, 11, 27, 43},
+            {0xff, 12, 28, 44, 0xff, 13, 29, 45, 0xff, 14, 30, 46, 0xff, 15, 31, 47},
+        };
+        const uint8x16x3_t planes = vld3q_u8(src);
+        for (size_t i = 0; i < 4; ++i) {
+            v[i] = vreinterpretq_s32_u8(vqtbl3q_u8(planes, vld1q_u8(index[i])));
+        }
+    }
+    static void storeP24(uint8_t *dst, const I *v) {
+        // The reverse of loadP24(): gather the planes from the low 3 bytes of each lane.
+        static const uint8_t index[3][16] = {
+            {0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60},
+            {1, 5, 9, 13, 17, 21, 25, 29, 33, 37, 41, 45, 49, 53, 57, 61},
+            {2, 6, 10, 14, 18, 22, 26, 30, 34, 38, 42, 46, 50, 54, 58, 62},
+        };
+        const uint8x16x4_t lanes = {{
+            vreinterpretq_u8_s32(v[0]), vreinterpretq_u8_s32(v[1]),
+            vreinterpretq_u8_s32(v[2]), vreinterpretq_u8_s32(v[3]),
+        }};
+        uint8x16x3_t planes;
+        for (size_t i = 0; i < 3; ++i) {
+            planes.val[i] = vqtbl4q_u8(lanes, vld1q_u8(index[i]));
+        }
+        vst3q_u8(dst, planes);
+    }
+    static void loadU8(const uint8_t *src, I *v) {
+        // Flipping the sign bit of each byte subtracts 128, then sign extend.
+        const int8x16_t b = vreinterpretq_s8_u8(veorq_u8(vld1q_u8(src), vdupq_n_u8(0x80)));
+        const int16x8_t lo = vmovl_s8(vget_low_s8(b));
+        const int16x8_t hi = vmovl_s8(vget_high_s8(b));
+        v[0] = vmovl_s16(vget_low_s16(lo));
+        v[1] = vmovl_s16(vget_high_s16(lo));
+        v[2] = vmovl_s16(vget_low_s16(hi));
+        v[3] = vmovl_s16(vget_high_s16(hi));
+    }
+    static F dupF(float f) {
+        return vdupq_n_f32(f);
+    }
+    static F mulF(F a, F b) {
+        return vmulq_f32(a, b);
+    }
+    static F mulAddF(F a, F b, F c) {
+        return vfmaq_f32(c, a, b);
+    }
+    static F toF(I v) {
+        return vcvtq_f32_s32(v);
+    }
+    static I dupI(int32_t i) {
+        return vdupq_n_s32(i);
+    }
+    static I clampI(I x, I lo, I hi) {
+        return vmaxq_s32(vminq_s32(x, hi), lo);
+    }
+    static F clampF(F x, F lo, F hi) {
+        // fminnm and fmaxnm return the number if the other operand is NaN, like fminf.
+        return vmaxnmq_f32(vminnmq_f32(x, hi), lo);
+    }
+    static I roundI32(F x) {
+        // fcvtas rounds to nearest, ties away from 0, and saturates; NaN becomes 0.
+        return vcvtaq_s32_f32(x);
+    }
+    template <int N>
+    static I shrI(I v) {
+        return vshrq_n_s32(v, N);
+    }
+    template <int N>
+    static I shlI(I v) {
+        return vshlq_n_s32(v, N);
+    }
+
+    typedef uint8x16_t B;
+
+    static B loadB(const uint8_t *src) {
+        return vld1q_u8(src);
+    }
+    static void storeB(uint8_t *dst, B v) {
+        vst1q_u8(dst, v);
+    }
+    static B shuffleB(B v, B index) {
+        // tbl writes 0 where the index is out of range.
+        return vqtbl1q_u8(v, index);
+    }
+    static B orB(B a, B b) {
+        return vorrq_u8(a, b);
+    }
+    static B toB(I v) {
+        return vreinterpretq_u8_s32(v);
+    }
+    static I toI(B v) {
+        return vreinterpretq_s32_u8(v);
+    }
+    static I addI(I a, I b) {
+        return vaddq_s32(a, b);
+    }
+    static I andI(I a, I b) {
+        return vandq_s32(a, b);
+    }
+    static I xorI(I a, I b) {
+        return veorq_s32(a, b);
+    }
+    static void unzipI(I a, I b, I &even, I &odd) {
+        even = vuzp1q_s32(a, b);
+        odd = vuzp2q_s32(a, b);
+    }
+};
+
+} // namespace
+
+void primitives_backend_neon(primitives_table_t *table)
+{
+    fillPrimitivesTable<Neon>(table);
+    fillChannelsTable<Neon>(table);
+    fillPowerTable<Neon>(table);
+    fillResamplerTable<Neon>(table);
+}
+
+#endif // PRIMITIVES_HAVE_NEON_BACKEND
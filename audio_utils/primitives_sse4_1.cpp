@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <immintrin.h>
+
+#include "private/primitives_backend.h"
+
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+
+// Only installed by primitives.c after checking the CPU supports SSE4.1.
+#define PRIMITIVES_TARGET __attribute__((target("sse4.1")))
+#include "private/primitives_vector.h"
+#include "private/channels_vector.h"
+#include "private/power_vector.h"
+#include "private/resampler_vector.h"
+
+namespace {
+
+struct Sse4_1 {
+    static constexpr size_t kLanes = 4;
+    typedef __m128 F;
+    typedef __m128i I;
+
+    static PRIMITIVES_TARGET F loadF(const float *src) {
+        return _mm_loadu_ps(src);
+    }
+    static PRIMITIVES_TARGET void storeF(float *dst, F v) {
+        _mm_storeu_ps(dst, v);
+    }
+    static PRIMITIVES_TARGET I loadI32(const int32_t *src) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    }
+    static PRIMITIVES_TARGET void storeI32(int32_t *dst, I v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+    }
+    static PRIMITIVES_TARGET I loadI16(const int16_t *src) {
+        return _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+    }
+    static PRIMITIVES_TARGET void storeI16(int16_t *dst, I v) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packs_epi32(v, v));
+    }
+    static PRIMITIVES_TARGET void loadP24(const uint8_t *src, I *v) {
+        // Realign the 48 bytes into four vectors of 12 bytes, then spread each
+        // sample into the upper 3 bytes of its lane.
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+        const __m128i spread =
+                _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+        v[0] = _mm_shuffle_epi8(a, spread);
+        v[1] = _mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), spread);
+        v[2] = _mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), spread);
+        v[3] = _mm_shuffle_epi8(_mm_srli_si128(c, 4), spread);
+    }
+    static PRIMITIVES_TARGET void storeP24(uint8_t *dst, const I *v) {
+        // Pack each vector to 12 bytes, then join them into three vectors of 16 bytes.
+        const __m128i pack =
+                _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m128i p0 = _mm_shuffle_epi8(v[0], pack);
+        const __m128i p1 = _mm_shuffle_epi8(v[1], pack);
+        const __m128i p2 = _mm_shuffle_epi8(v[2], pack);
+        const __m128i p3 = _mm_shuffle_epi8(v[3], pack);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16),
+                _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32),
+                _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+    }
+    static PRIMITIVES_TARGET void loadU8(const uint8_t *src, I *v) {
+        // Flipping the sign bit of each byte subtracts 128, then sign extend.
+        const __m128i b = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)),
+                _mm_set1_epi8(-128));
+        v[0] = _mm_cvtepi8_epi32(b);
+        v[1] = _mm_cvtepi8_epi32(_mm_srli_si128(b, 4));
+        v[2] = _mm_cvtepi8_epi32(_mm_srli_si128(b, 8));
+        v[3] = _mm_cvtepi8_epi32(_mm_srli_si128(b, 12));
+    }
+    static PRIMITIVES_TARGET F dupF(float f) {
+        return _mm_set1_ps(f);
+    }
+    static PRIMITIVES_TARGET F mulF(F a, F b) {
+        return _mm_mul_ps(a, b);
+    }
+    static PRIMITIVES_TARGET F mulAddF(F a, F b, F c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static PRIMITIVES_TARGET F toF(I v) {
+        return _mm_cvtepi32_ps(v);
+    }
+    static PRIMITIVES_TARGET I dupI(int32_t i) {
+        return _mm_set1_epi32(i);
+    }
+    static PRIMITIVES_TARGET I clampI(I x, I lo, I hi) {
+        return _mm_max_epi32(_mm_min_epi32(x, hi), lo);
+    }
+    static PRIMITIVES_TARGET F clampF(F x, F lo, F hi) {
+        // minps returns the second operand if either is NaN, like fminf(NaN, hi).
+        return _mm_max_ps(_mm_min_ps(x, hi), lo);
+    }
+    static PRIMITIVES_TARGET I roundI32(F x) {
+        // Adding the float just below 0.5 (with the sign of x) then truncating
+        // rounds to nearest, ties away from 0, without double rounding.
+        const __m128 half = _mm_or_ps(_mm_and_ps(x, _mm_set1_ps(-0.f)),
+                _mm_set1_ps(0.49999997f));
+        const __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(x, half));
+        // cvttps returns 0x80000000 on overflow and for NaN; flip the positive overflows.
+        return _mm_xor_si128(rounded,
+                _mm_castps_si128(_mm_cmpge_ps(x, _mm_set1_ps(2147483648.f))));
+    }
+    template <int N>
+    static PRIMITIVES_TARGET I shrI(I v) {
+        return _mm_srai_epi32(v, N);
+    }
+    template <int N>
+    static PRIMITIVES_TARGET I shlI(I v) {
+        return _mm_slli_epi32(v, N);
+    }
+
+    typedef __m128i B;
+
+    static PRIMITIVES_TARGET B loadB(const uint8_t *src) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    }
+    static PRIMITIVES_TARGET void storeB(uint8_t *dst, B v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+    }
+    static PRIMITIVES_TARGET B shuffleB(B v, B index) {
+        // pshufb writes 0 where the index has the high bit set.
+        return _mm_shuffle_epi8(v, index);
+    }
+    static PRIMITIVES_TARGET B orB(B a, B b) {
+        return _mm_or_si128(a, b);
+    }
+    static PRIMITIVES_TARGET B toB(I v) {
+        return v;
+    }
+    static PRIMITIVES_TARGET I toI(B v) {
+        return v;
+    }
+    static PRIMITIVES_TARGET I addI(I a, I b) {
+        return _mm_add_epi32(a, b);
+    }
+    static PRIMITIVES_TARGET I andI(I a, I b) {
+        return _mm_and_si128(a, b);
+    }
+    static PRIMITIVES_TARGET I xorI(I a, I b) {
+        return _mm_xor_si128(a, b);
+    }
+    static PRIMITIVES_TARGET void unzipI(I a, I b, I &even, I &odd) {
+        const __m128 fa = _mm_castsi128_ps(a);
+        const __m128 fb = _mm_castsi128_ps(b);
+        even = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+        odd = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+};
+
+} // namespace
+
+void primitives_backend_sse4_1(primitives_table_t *table)
+{
+    fillPrimitivesTable<Sse4_1>(table);
+    fillChannelsTable<Sse4_1>(table);
+    fillPowerTable<Sse4_1>(table);
+    fillResamplerTable<Sse4_1>(table);
+}
+
+#endif // PRIMITIVES_HAVE_X86_BACKENDS
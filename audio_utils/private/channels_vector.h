@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_CHANNELS_VECTOR_H
+#define ANDROID_AUDIO_CHANNELS_VECTOR_H
+
+#ifndef __cplusplus
+#error channels_vector.h is C++ only
+#endif
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "private/primitives_vector.h"
+
+/*
+ * Channel expand and contract kernels for adjust_channels(), and the remap kernel for
+ * memcpy_by_index_array_with_plan(), shared by the vector
+ * backends with 16 byte shuffles. Included after primitives_vector.h, whose traits
+ * class V must also provide:
+ *
+ *   typename V::B               vector of 16 bytes.
+ *   loadB(), storeB()           unaligned load and store.
+ *   shuffleB(v, index)          byte i is v[index[i]], or 0 if index[i] is 0xff.
+ *   orB()                       bitwise or.
+ *   toB(), toI()                reinterpret between V::I and V::B.
+ *   addI(), andI(), xorI()      lanewise add, and, xor.
+ *   unzipI(a, b, even, odd)     even and odd lanes of a followed by b.
+ *
+ * The kernels must be bit exact with channels.c, including in place.
+ */
+
+namespace {
+
+constexpr size_t kMaxChannelFrameBytes = 32;    // 8 channels of 4 bytes
+constexpr size_t kMaxChannelGathers = 16;
+constexpr size_t kMaxChannelVectors = 16;
+
+// Expanding or contracting a block of frames is a fixed shuffle of its bytes:
+// each 16 byte vector written is the OR of its gathers, each shuffling 16 bytes read
+// from the block. This is computed at compile time for each shape and sample size.
+struct ChannelShuffle {
+    struct Gather {
+        size_t dst = 0;             // the vector of the block written
+        size_t src = 0;             // the offset in the block of the 16 bytes read
+        uint8_t index[16] = {};     // for each byte written, the byte read, or 0xff for 0
+    };
+
+    bool valid = true;              // false if there would be too many gathers
+    size_t frames = 0;              // per block
+    size_t srcBytes = 0;
+    size_t dstBytes = 0;
+    int map[kMaxChannelFrameBytes] = {}; // per byte of an output frame, the input byte or -1
+    size_t count = 0;
+    Gather gather[kMaxChannelGathers] = {};
+
+    constexpr ChannelShuffle(size_t inChans, size_t outChans, size_t sampleSize) {
+        // As EXPAND_MONO_TO_MULTI(), EXPAND_CHANNELS() and CONTRACT_CHANNELS().
+        for (size_t ch = 0; ch < outChans; ++ch) {
+            const size_t inCh = inChans == 1 && ch < 2 ? 0 : ch;
+            for (size_t i = 0; i < sampleSize; ++i) {
+                map[ch * sampleSize + i] = inCh < inChans ? int(inCh * sampleSize + i) : -1;
+            }
+        }
+        // The fewest frames reading at least one vector and writing whole vectors.
+        const size_t inFrameBytes = inChans * sampleSize;
+        const size_t outFrameBytes = outChans * sampleSize;
+        frames = 1;
+        while ((frames * outFrameBytes) % 16 != 0 || frames * inFrameBytes < 16) {
+            ++frames;
+        }
+        srcBytes = frames * inFrameBytes;
+        dstBytes = frames * outFrameBytes;
+        if (dstBytes > 16 * kMaxChannelVectors) {
+            valid = false;
+            return;
+        }
+        for (size_t vector = 0; vector < dstBytes / 16; ++vector) {
+            int source[16] = {};
+            for (size_t i = 0; i < 16; ++i) {
+                const size_t outByte = vector * 16 + i;
+                const int inByte = map[outByte % outFrameBytes];
+                source[i] = inByte < 0
+                        ? -1 : int(outByte / outFrameBytes * inFrameBytes) + inByte;
+            }
+            // Greedily cover the bytes read, lowest first, with reads within the block.
+            for (;;) {
+                int lowest = -1;
+                for (size_t i = 0; i < 16; ++i) {
+                    if (source[i] >= 0 && (lowest < 0 || source[i] < lowest)) {
+                        lowest = source[i];
+                    }
+                }
+                if (lowest < 0) break;
+                if (count == kMaxChannelGathers) {
+                    valid = false;
+                    return;
+                }
+                const int offset = std::min(lowest, int(srcBytes) - 16);
+                Gather &g = gather[count++];
+                g.dst = vector;
+                g.src = offset;
+                for (size_t i = 0; i < 16; ++i) {
+                    if (source[i] >= offset && source[i] < offset + 16) {
+                        g.index[i] = source[i] - offset;
+                        source[i] = -1;
+                    } else {
+                        g.index[i] = 0xff;
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Inlined into shuffleChannels(), where the shuffle is a constant and the loops unroll.
+template <typename V>
+PRIMITIVES_TARGET inline __attribute__((always_inline)) void shuffleChannelBlock(
+        const ChannelShuffle &shuffle, uint8_t *dst, const uint8_t *src)
+{
+    // The whole block is read before it is written, for in-place use.
+    typename V::B out[kMaxChannelVectors] = {};
+#pragma GCC unroll 16
+    for (size_t i = 0; i < shuffle.count; ++i) {
+        const ChannelShuffle::Gather &g = shuffle.gather[i];
+        out[g.dst] = V::orB(out[g.dst], V::shuffleB(V::loadB(src + g.src), V::loadB(g.index)));
+    }
+#pragma GCC unroll 16
+    for (size_t i = 0; i < shuffle.dstBytes / 16; ++i) {
+        V::storeB(dst + i * 16, out[i]);
+    }
+}
+
+template <typename V, size_t kIn, size_t kOut, size_t kSize>
+PRIMITIVES_TARGET void shuffleChannels(uint8_t *dst, const uint8_t *src, size_t frameCount)
+{
+    static constexpr ChannelShuffle kShuffle(kIn, kOut, kSize);
+    static_assert(kShuffle.valid, "channel shuffle needs too many gathers");
+    constexpr size_t kInFrameBytes = kIn * kSize;
+    constexpr size_t kOutFrameBytes = kOut * kSize;
+
+    const size_t blocks = frameCount / kShuffle.frames;
+    const size_t tailBytes = frameCount % kShuffle.frames * kOutFrameBytes;
+    const uint8_t *tailSrc = src + blocks * kShuffle.srcBytes;
+    uint8_t *tailDst = dst + blocks * kShuffle.dstBytes;
+    if constexpr (kOut > kIn) {
+        // From back to front, as expand_channels().
+        for (size_t i = tailBytes; i-- > 0; ) {
+            const int inByte = kShuffle.map[i % kOutFrameBytes];
+            tailDst[i] = inByte < 0 ? 0 : tailSrc[i / kOutFrameBytes * kInFrameBytes + inByte];
+        }
+        for (size_t block = blocks; block-- > 0; ) {
+            shuffleChannelBlock<V>(kShuffle,
+                    dst + block * kShuffle.dstBytes, src + block * kShuffle.srcBytes);
+        }
+    } else {
+        // From front to back, as contract_channels().
+        for (size_t block = 0; block < blocks; ++block) {
+            shuffleChannelBlock<V>(kShuffle,
+                    dst + block * kShuffle.dstBytes, src + block * kShuffle.srcBytes);
+        }
+        for (size_t i = 0; i < tailBytes; ++i) {
+            const int inByte = kShuffle.map[i % kOutFrameBytes];
+            tailDst[i] = tailSrc[i / kOutFrameBytes * kInFrameBytes + inByte];
+        }
+    }
+}
+
+// Samples as read by CONTRACT_TO_MONO() and CONTRACT_TO_MONO_24(): 8 bit samples are unsigned.
+template <size_t kSize>
+inline int32_t loadChannelSample(const uint8_t *src)
+{
+    if constexpr (kSize == 1) {
+        return src[0];
+    } else if constexpr (kSize == 2) {
+        int16_t sample;
+        memcpy(&sample, src, sizeof(sample));
+        return sample;
+    } else if constexpr (kSize == 3) {
+        return int32_t(uint32_t(src[0]) << 8 | uint32_t(src[1]) << 16 | uint32_t(src[2]) << 24)
+                >> 8;
+    } else {
+        int32_t sample;
+        memcpy(&sample, src, sizeof(sample));
+        return sample;
+    }
+}
+
+// The average of two samples, rounded down, without overflow.
+template <typename V>
+PRIMITIVES_TARGET inline typename V::I averageI(typename V::I a, typename V::I b)
+{
+    return V::addI(V::andI(a, b), V::template shrI<1>(V::xorI(a, b)));
+}
+
+// Stereo to mono, averaging the two channels as CONTRACT_TO_MONO() does.
+template <typename V, size_t kSize>
+PRIMITIVES_TARGET void averageChannelsToMono(uint8_t *dst, const uint8_t *src, size_t frameCount)
+{
+    static_assert(V::kLanes == 4, "lanes hold 4 frames");
+    if constexpr (kSize == 1) {
+        // Spread 4 frames of 2 bytes to lanes, and pack the low byte of each lane back.
+        static const uint8_t spread[4][16] = {
+            {0, 0xff, 0xff, 0xff, 2, 0xff, 0xff, 0xff, 4, 0xff, 0xff, 0xff, 6, 0xff, 0xff, 0xff},
+            {1, 0xff, 0xff, 0xff, 3, 0xff, 0xff, 0xff, 5, 0xff, 0xff, 0xff, 7, 0xff, 0xff, 0xff},
+            {8, 0xff, 0xff, 0xff, 10, 0xff, 0xff, 0xff, 12, 0xff, 0xff, 0xff, 14, 0xff, 0xff, 0xff},
+            {9, 0xff, 0xff, 0xff, 11, 0xff, 0xff, 0xff, 13, 0xff, 0xff, 0xff, 15, 0xff, 0xff, 0xff},
+        };
+        static const uint8_t pack[4][16] = {
+            {0, 4, 8, 12, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+            {0xff, 0xff, 0xff, 0xff, 0, 4, 8, 12, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+            {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0, 4, 8, 12, 0xff, 0xff, 0xff, 0xff},
+            {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0, 4, 8, 12},
+        };
+        for (; frameCount >= 16; frameCount -= 16) {
+            const typename V::B v[2] = {V::loadB(src), V::loadB(src + 16)};
+            typename V::B out = {};
+            for (size_t i = 0; i < 4; ++i) {
+                const typename V::I a = V::toI(V::shuffleB(v[i / 2], V::loadB(spread[i % 2 * 2])));
+                const typename V::I b =
+                        V::toI(V::shuffleB(v[i / 2], V::loadB(spread[i % 2 * 2 + 1])));
+                out = V::orB(out, V::shuffleB(V::toB(averageI<V>(a, b)), V::loadB(pack[i])));
+            }
+            V::storeB(dst, out);
+            src += 32;
+            dst += 16;
+        }
+    } else if constexpr (kSize == 2) {
+        for (; frameCount >= 4; frameCount -= 4) {
+            const typename V::I v = V::toI(V::loadB(src));
+            const typename V::I left = V::template shrI<16>(V::template shlI<16>(v));
+            const typename V::I right = V::template shrI<16>(v);
+            V::storeI16(reinterpret_cast<int16_t *>(dst), averageI<V>(left, right));
+            src += 16;
+            dst += 8;
+        }
+    } else if constexpr (kSize == 3) {
+        // The samples are in the upper 24 bits of each lane, so the average is shifted down.
+        for (; frameCount >= kP24Block; frameCount -= kP24Block) {
+            typename V::I v[2 * kP24Block / V::kLanes];
+            V::loadP24(src, v);
+            V::loadP24(src + 3 * kP24Block, v + kP24Block / V::kLanes);
+            typename V::I out[kP24Block / V::kLanes];
+            for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+                typename V::I left, right;
+                V::unzipI(v[2 * i], v[2 * i + 1], left, right);
+                out[i] = V::template shrI<8>(averageI<V>(left, right));
+            }
+            V::storeP24(dst, out);
+            src += 6 * kP24Block;
+            dst += 3 * kP24Block;
+        }
+    } else {
+        for (; frameCount >= 4; frameCount -= 4) {
+            typename V::I left, right;
+            V::unzipI(V::toI(V::loadB(src)), V::toI(V::loadB(src + 16)), left, right);
+            V::storeB(dst, V::toB(averageI<V>(left, right)));
+            src += 32;
+            dst += 16;
+        }
+    }
+    for (; frameCount > 0; --frameCount) {
+        const int32_t left = loadChannelSample<kSize>(src);
+        const int32_t right = loadChannelSample<kSize>(src + kSize);
+        const int32_t average = (left & right) + ((left ^ right) >> 1);
+        memcpy(dst, &average, kSize); // little endian
+        src += 2 * kSize;
+        dst += kSize;
+    }
+}
+
+typedef void (*ChannelsKernel)(uint8_t *dst, const uint8_t *src, size_t frameCount);
+
+struct ChannelsKernels {
+    size_t inChans;
+    size_t outChans;
+    ChannelsKernel bySize[4];
+};
+
+template <typename V, size_t kIn, size_t kOut>
+constexpr ChannelsKernels shuffleChannelsKernels()
+{
+    return {kIn, kOut, {
+        shuffleChannels<V, kIn, kOut, 1>, shuffleChannels<V, kIn, kOut, 2>,
+        shuffleChannels<V, kIn, kOut, 3>, shuffleChannels<V, kIn, kOut, 4>,
+    }};
+}
+
+template <typename V>
+int adjustChannels(void *dst, const void *src, size_t inChans, size_t outChans,
+        unsigned sampleSize, size_t frameCount)
+{
+    static constexpr ChannelsKernels kKernels[] = {
+        {2, 1, {
+            averageChannelsToMono<V, 1>, averageChannelsToMono<V, 2>,
+            averageChannelsToMono<V, 3>, averageChannelsToMono<V, 4>,
+        }},
+        shuffleChannelsKernels<V, 1, 2>(),
+        shuffleChannelsKernels<V, 2, 4>(),
+        shuffleChannelsKernels<V, 4, 2>(),
+        shuffleChannelsKernels<V, 2, 6>(),
+        shuffleChannelsKernels<V, 6, 2>(),
+        shuffleChannelsKernels<V, 2, 8>(),
+        shuffleChannelsKernels<V, 8, 2>(),
+    };
+    if (sampleSize < 1 || sampleSize > 4) {
+        return -EINVAL;
+    }
+    for (const ChannelsKernels &kernels : kKernels) {
+        if (kernels.inChans == inChans && kernels.outChans == outChans) {
+            kernels.bySize[sampleSize - 1](static_cast<uint8_t *>(dst),
+                    static_cast<const uint8_t *>(src), frameCount);
+            return 0;
+        }
+    }
+    return -EINVAL;
+}
+
+// The runtime counterpart of shuffleChannels(), for the gathers of a
+// memcpy_by_index_array_plan_t, which has no tail.
+template <typename V>
+PRIMITIVES_TARGET void shuffleChannelsWithPlan(void *dst, const void *src,
+        const memcpy_by_index_array_plan_t *plan, size_t blocks)
+{
+    uint8_t *out = static_cast<uint8_t *>(dst);
+    const uint8_t *in = static_cast<const uint8_t *>(src);
+    static const uint8_t kZeroBytes[16] = {};
+    const size_t vectors = plan->dst_block_bytes / 16;
+    // Each vector is a single shuffle, as for reorders of 4 or 8 channels, only if every
+    // vector has exactly one gather: a vector may have none, and another several.
+    bool singleGathers = plan->gather_count == vectors;
+    for (size_t i = 0; singleGathers && i < vectors; ++i) {
+        singleGathers = plan->gather[i].dst == i;
+    }
+    if (singleGathers) {
+        for (size_t block = 0; block < blocks; ++block) {
+            for (size_t i = 0; i < vectors; ++i) {
+                const auto &g = plan->gather[i];
+                V::storeB(out + i * 16, V::shuffleB(V::loadB(in + g.src), V::loadB(g.index)));
+            }
+            out += plan->dst_block_bytes;
+            in += plan->src_block_bytes;
+        }
+        return;
+    }
+    for (size_t block = 0; block < blocks; ++block) {
+        // The gathers of a vector are adjacent, in increasing order of vector.
+        size_t i = 0;
+        for (size_t vector = 0; vector < vectors; ++vector) {
+            typename V::B v = V::loadB(kZeroBytes);
+            for (; i < plan->gather_count && plan->gather[i].dst == vector; ++i) {
+                const auto &g = plan->gather[i];
+                v = V::orB(v, V::shuffleB(V::loadB(in + g.src), V::loadB(g.index)));
+            }
+            V::storeB(out + vector * 16, v);
+        }
+        out += plan->dst_block_bytes;
+        in += plan->src_block_bytes;
+    }
+}
+
+template <typename V>
+void fillChannelsTable(primitives_table_t *table)
+{
+    table->adjust_channels = adjustChannels<V>;
+    table->memcpy_by_index_array_with_plan = shuffleChannelsWithPlan<V>;
+}
+
+} // namespace
+
+#endif // ANDROID_AUDIO_CHANNELS_VECTOR_H
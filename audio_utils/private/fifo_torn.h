@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_TORN_H
+#define ANDROID_AUDIO_FIFO_TORN_H
+
+// Overwrite detection shared by the lock-free drains of PowerLog and SimpleLog.
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+
+#include <audio_utils/fifo.h>
+
+// Returns how many of the actual frames at the front of those just read by reader may have
+// been overwritten during the copy, and so must be discarded.
+// The reader does not throttle the writer, so the oldest frames read may have been overwritten
+// while they were copied.  The writer must write one frame at a time, so this is possible
+// for a slot only if the frames still available and those just read fill the fifo.
+// The fence orders the copy before the load of the writer index by obtain().
+static inline size_t fifoTornFrames(audio_utils_fifo_reader &reader, size_t actual)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    audio_utils_iovec iovec[2];
+    const ssize_t filled = reader.obtain(iovec, SIZE_MAX, NULL /*timeout*/);
+    if (filled < 0) {
+        return actual;
+    }
+    const size_t frameCount = reader.capacity();
+    if ((size_t) filled + actual < frameCount) {
+        return 0;
+    }
+    return std::min(actual, (size_t) filled + actual - frameCount + 1);
+}
+
+#endif  // !ANDROID_AUDIO_FIFO_TORN_H
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_FIFO_WORDS_H
+#define ANDROID_AUDIO_FIFO_WORDS_H
+
+// Copies of 32-bit words shared by audio_utils_fifo_writer32 and audio_utils_fifo_reader32.
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// TODO templatize int32_t
+
+static inline void memcpyWords(int32_t *dst, const int32_t *src, uint32_t count)
+{
+    switch (count) {
+    case 0: break;
+// TODO templatize here also, but first confirm no performance regression compared to current
+#define _(n) \
+    case n: { \
+        struct s##n { int32_t a[n]; }; \
+        *(struct s##n *)dst = *(const struct s##n *)src; \
+        break; \
+    }
+    _(1) _(2) _(3) _(4) _(5) _(6) _(7) _(8) _(9) _(10) _(11) _(12) _(13) _(14) _(15) _(16)
+#undef _
+    default:
+        memcpy(dst, src, count * sizeof(int32_t));
+        break;
+    }
+}
+
+// Same as memcpyWords, but with non-temporal stores where supported, so that a large copy
+// does not evict the rest of the cache of the copying core for data it will not read again.
+// The stores are ordered before any later store-release, as required to commit them.
+static inline void memcpyWordsNonTemporal(int32_t *dst, const int32_t *src, uint32_t count)
+{
+#if defined(__SSE2__)
+    // Single words until dst is aligned for 16-byte stores.
+    for (; count > 0 && ((uintptr_t) dst & 15) != 0; --count) {
+        _mm_stream_si32(dst++, *src++);
+    }
+    for (; count >= 4; count -= 4, dst += 4, src += 4) {
+        _mm_stream_si128((__m128i *) dst, _mm_loadu_si128((const __m128i *) src));
+    }
+    for (; count > 0; --count) {
+        _mm_stream_si32(dst++, *src++);
+    }
+    // Non-temporal stores are weakly ordered, even on x86.
+    _mm_sfence();
+#elif defined(__aarch64__)
+    for (; count >= 8; count -= 8, dst += 8, src += 8) {
+        const int32x4_t a = vld1q_s32(src);
+        const int32x4_t b = vld1q_s32(src + 4);
+        __asm__ __volatile__("stnp %q0, %q1, [%2]" : : "w" (a), "w" (b), "r" (dst) : "memory");
+    }
+    memcpyWords(dst, src, count);
+    // A later store-release orders these stores too, so no barrier is needed.
+#else
+    memcpyWords(dst, src, count);
+#endif
+}
+
+#endif  // !ANDROID_AUDIO_FIFO_WORDS_H
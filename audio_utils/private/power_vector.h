@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_POWER_VECTOR_H
+#define ANDROID_AUDIO_POWER_VECTOR_H
+
+#ifndef __cplusplus
+#error power_vector.h is C++ only
+#endif
+
+#include "private/primitives_vector.h"
+
+/*
+ * Energy kernels for audio_utils_compute_energy_mono() and
+ * audio_utils_compute_energy_by_channel(), shared by the vector backends.
+ * Included after primitives_vector.h, whose traits class V must also provide:
+ *
+ *   loadU8(src, v)              load kP24Block unsigned 8 bit samples, less 128,
+ *                               into the vectors v[kP24Block / kLanes].
+ *
+ * Unlike the conversions, the kernels are not bit exact with the scalar code in power.cpp,
+ * as the order of the additions differs.  They are more precise: the squares are summed in
+ * independent float accumulators, one per lane, and these are added in double precision
+ * every kEnergyFlushBlocks blocks and at the end.
+ */
+
+namespace {
+
+template <typename V>
+struct U8Source {
+    typedef uint8_t S;
+    static constexpr size_t kStride = 1;
+    static float scale() { return 1.f / (1 << 7); }
+    static PRIMITIVES_TARGET void load(const S *src, typename V::F *f) {
+        typename V::I v[kP24Block / V::kLanes];
+        V::loadU8(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            f[i] = V::toF(v[i]);
+        }
+    }
+    static float scalar(const S *src) { return (int)*src - 128; }
+};
+
+template <typename V>
+struct Q8_23Source : public I32Source<V> {
+    static float scale() { return 1.f / (1 << 23); }
+};
+
+// Bounds the number of squares summed in each float accumulator.
+constexpr size_t kEnergyFlushBlocks = 64;
+
+// Adds the accumulators of energyFrom() to the sums of their channels, and clears them.
+template <typename V>
+PRIMITIVES_TARGET void flushEnergy(typename V::F *accum, uint32_t channelCount, double *sums)
+{
+    float lanes[kMaxVectorGainChannels * kP24Block];
+    for (size_t i = 0; i < channelCount * kP24Block / V::kLanes; ++i) {
+        V::storeF(lanes + i * V::kLanes, accum[i]);
+        accum[i] = V::dupF(0.f);
+    }
+    for (size_t i = 0; i < channelCount * kP24Block; ++i) {
+        sums[i % channelCount] += lanes[i];
+    }
+}
+
+template <typename V, typename Source>
+PRIMITIVES_TARGET void energyFrom(const typename Source::S *src, size_t frameCount,
+        uint32_t channelCount, float *energies)
+{
+    constexpr size_t kVectors = kP24Block / V::kLanes;
+    const double scale = Source::scale();
+    if (channelCount > kMaxVectorGainChannels) {
+        for (uint32_t ch = 0; ch < channelCount; ++ch) {
+            energies[ch] = 0.f;
+        }
+        for (; frameCount > 0; --frameCount) {
+            for (uint32_t ch = 0; ch < channelCount; ++ch) {
+                const float amplitude = Source::scalar(src) * Source::scale();
+                energies[ch] += amplitude * amplitude;
+                src += Source::kStride;
+            }
+        }
+        return;
+    }
+
+    // As for accumulateFloatFromByChannel(), kP24Block frames are channelCount blocks of
+    // kP24Block samples, so each lane of each accumulator always sees the same channel.
+    double sums[kMaxVectorGainChannels] = {};
+    typename V::F accum[kMaxVectorGainChannels * kVectors];
+    const size_t vectors = channelCount * kVectors;
+    for (size_t i = 0; i < vectors; ++i) {
+        accum[i] = V::dupF(0.f);
+    }
+    typename V::F f[kVectors];
+    size_t blocks = 0;
+    for (; frameCount >= kP24Block; frameCount -= kP24Block) {
+        for (size_t block = 0; block < channelCount; ++block) {
+            Source::load(src, f);
+            for (size_t i = 0; i < kVectors; ++i) {
+                typename V::F &a = accum[block * kVectors + i];
+                a = V::mulAddF(f[i], f[i], a);
+            }
+            src += kP24Block * Source::kStride;
+        }
+        if (++blocks == kEnergyFlushBlocks) {
+            flushEnergy<V>(accum, channelCount, sums);
+            blocks = 0;
+        }
+    }
+    flushEnergy<V>(accum, channelCount, sums);
+    for (; frameCount > 0; --frameCount) {
+        for (uint32_t ch = 0; ch < channelCount; ++ch) {
+            const double amplitude = Source::scalar(src);
+            sums[ch] += amplitude * amplitude;
+            src += Source::kStride;
+        }
+    }
+    for (uint32_t ch = 0; ch < channelCount; ++ch) {
+        energies[ch] = sums[ch] * (scale * scale);
+    }
+}
+
+template <typename V>
+void fillPowerTable(primitives_table_t *table)
+{
+    table->energy_from_u8 = energyFrom<V, U8Source<V>>;
+    table->energy_from_i16 = energyFrom<V, I16Source<V>>;
+    table->energy_from_p24 = energyFrom<V, P24Source<V>>;
+    table->energy_from_q8_23 = energyFrom<V, Q8_23Source<V>>;
+    table->energy_from_i32 = energyFrom<V, I32Source<V>>;
+    table->energy_from_float = energyFrom<V, FloatSource<V>>;
+}
+
+} // namespace
+
+#endif // ANDROID_AUDIO_POWER_VECTOR_H
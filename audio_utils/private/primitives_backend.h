@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_PRIMITIVES_BACKEND_H
+#define ANDROID_AUDIO_PRIMITIVES_BACKEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/cdefs.h>
+
+#include <audio_utils/primitives.h>
+
+__BEGIN_DECLS
+
+/* The vector backends shuffle bytes assuming little endian sample layout. */
+#if (defined(__x86_64__) || defined(__i386__)) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PRIMITIVES_HAVE_X86_BACKENDS
+#endif
+#if defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define PRIMITIVES_HAVE_NEON_BACKEND
+#endif
+
+/* Conversion and mixing routines which have vector implementations.
+ *
+ * primitives.c owns the active table, which is initialized with the scalar
+ * reference implementation and replaced by the best supported backend
+ * when the library is loaded.
+ */
+typedef struct {
+    void (*memcpy_to_i16_from_q4_27)(int16_t *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_i16_from_i32)(int16_t *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_i16_from_float)(int16_t *dst, const float *src, size_t count);
+    void (*memcpy_to_float_from_q4_27)(float *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_float_from_i16)(float *dst, const int16_t *src, size_t count);
+    void (*memcpy_to_p24_from_float)(uint8_t *dst, const float *src, size_t count);
+    void (*memcpy_to_q8_23_from_i16)(int32_t *dst, const int16_t *src, size_t count);
+    void (*memcpy_to_q8_23_from_float_with_clamp)(int32_t *dst, const float *src, size_t count);
+    void (*memcpy_to_q4_27_from_float)(int32_t *dst, const float *src, size_t count);
+    void (*memcpy_to_i16_from_q8_23)(int16_t *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_float_from_q8_23)(float *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_i32_from_i16)(int32_t *dst, const int16_t *src, size_t count);
+    void (*memcpy_to_i32_from_float)(int32_t *dst, const float *src, size_t count);
+    void (*memcpy_to_float_from_i32)(float *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_float_from_p24)(float *dst, const uint8_t *src, size_t count);
+    void (*memcpy_to_i16_from_p24)(int16_t *dst, const uint8_t *src, size_t count);
+    void (*memcpy_to_i32_from_p24)(int32_t *dst, const uint8_t *src, size_t count);
+    void (*memcpy_to_p24_from_i16)(uint8_t *dst, const int16_t *src, size_t count);
+    void (*memcpy_to_p24_from_q8_23)(uint8_t *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_p24_from_i32)(uint8_t *dst, const int32_t *src, size_t count);
+    void (*memcpy_to_q8_23_from_p24)(int32_t *dst, const uint8_t *src, size_t count);
+    void (*accumulate_float_from_i16)(float *dst, const int16_t *src, size_t count, float gain);
+    void (*accumulate_float_from_p24)(float *dst, const uint8_t *src, size_t count, float gain);
+    void (*accumulate_float_from_i32)(float *dst, const int32_t *src, size_t count, float gain);
+    void (*accumulate_float_from_float)(float *dst, const float *src, size_t count, float gain);
+    void (*accumulate_float_from_i16_by_channel)(float *dst, const int16_t *src,
+            size_t frame_count, uint32_t channel_count, const float *gains);
+    void (*accumulate_float_from_p24_by_channel)(float *dst, const uint8_t *src,
+            size_t frame_count, uint32_t channel_count, const float *gains);
+    void (*accumulate_float_from_i32_by_channel)(float *dst, const int32_t *src,
+            size_t frame_count, uint32_t channel_count, const float *gains);
+    void (*accumulate_float_from_float_by_channel)(float *dst, const float *src,
+            size_t frame_count, uint32_t channel_count, const float *gains);
+
+    /* The entries below are NULL in the scalar table, for which callers use
+     * their own generic code.
+     */
+
+    /* As adjust_channels() for frame_count frames, returning 0, or -EINVAL
+     * without converting if the channel counts or sample size have no vector kernel.
+     */
+    int (*adjust_channels)(void *dst, const void *src, size_t in_chans, size_t out_chans,
+            unsigned sample_size, size_t frame_count);
+    /* As memcpy_by_index_array_with_plan() for blocks of the plan's block_frames. */
+    void (*memcpy_by_index_array_with_plan)(void *dst, const void *src,
+            const memcpy_by_index_array_plan_t *plan, size_t blocks);
+    /* As audio_utils_compute_energy_by_channel() for each sample format. */
+    void (*energy_from_u8)(const uint8_t *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    void (*energy_from_i16)(const int16_t *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    void (*energy_from_p24)(const uint8_t *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    void (*energy_from_q8_23)(const int32_t *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    void (*energy_from_i32)(const int32_t *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    void (*energy_from_float)(const float *src, size_t frame_count, uint32_t channel_count,
+            float *energies);
+    /* One output frame of the polyphase resampler: for each channel, the dot product of
+     * the taps samples at src + channel * stride with coefs, or if next_coefs is not NULL,
+     * that interpolated by alpha towards the dot product with next_coefs.
+     * taps is a multiple of 16.
+     */
+    void (*resampler_fir_float)(float *dst, const float *src, size_t stride,
+            uint32_t channel_count, const float *coefs, const float *next_coefs, float alpha,
+            size_t taps);
+} primitives_table_t;
+
+/* Returns the table of the active backend, for use elsewhere in the library. */
+const primitives_table_t *primitives_get_table(void);
+
+/* Each backend overwrites the table entries it implements.
+ * The caller must have checked that the CPU supports the backend.
+ */
+#ifdef PRIMITIVES_HAVE_X86_BACKENDS
+void primitives_backend_sse4_1(primitives_table_t *table);
+void primitives_backend_avx2(primitives_table_t *table);
+#endif
+#ifdef PRIMITIVES_HAVE_NEON_BACKEND
+void primitives_backend_neon(primitives_table_t *table);
+#endif
+
+__END_DECLS
+
+#endif /*ANDROID_AUDIO_PRIMITIVES_BACKEND_H*/
@@ -0,0 +1,574 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_PRIMITIVES_VECTOR_H
+#define ANDROID_AUDIO_PRIMITIVES_VECTOR_H
+
+#ifndef __cplusplus
+#error primitives_vector.h is C++ only
+#endif
+
+#include <audio_utils/primitives.h>
+#include "private/primitives_backend.h"
+
+/*
+ * Conversion kernels shared by the vector backends.
+ *
+ * Each backend translation unit defines PRIMITIVES_TARGET to the function attribute
+ * enabling its instruction set (empty if the instruction set is the baseline),
+ * and a traits class V describing a vector of V::kLanes 32-bit lanes:
+ *
+ *   typename V::F, V::I         float and int32_t vector types.
+ *   loadF(), storeF()           unaligned float load and store.
+ *   loadI32(), storeI32()       unaligned int32_t load and store.
+ *   loadI16()                   load int16_t and sign extend to int32_t.
+ *   storeI16()                  saturate int32_t to int16_t and store.
+ *   loadP24(src, v)             load kP24Block packed 24 bit samples into the vectors
+ *                               v[kP24Block / kLanes], as the upper 24 bits of each lane
+ *                               like i32_from_p24().
+ *   storeP24(dst, v)            store the low 24 bits of each lane of the vectors
+ *                               v[kP24Block / kLanes] as kP24Block packed 24 bit samples.
+ *   dupF(), mulF()              broadcast and multiply.
+ *   mulAddF(a, b, c)            a * b + c, fused or not.
+ *   dupI(), clampI(x, lo, hi)   broadcast and clamp.
+ *   toF()                       int32_t to float, rounding to nearest, ties to even.
+ *   clampF(x, lo, hi)           fmaxf(fminf(x, hi), lo) including the NaN behavior.
+ *   roundI32()                  float to int32_t, rounding to nearest, ties away from 0,
+ *                               saturating, with NaN as for a scalar cast.
+ *   shrI<N>(), shlI<N>()        arithmetic right and left shifts.
+ *
+ * The kernels must be bit exact with the scalar reference in primitives.c,
+ * and keep its in-place behavior: shrinking copies go upwards, expanding
+ * copies go downwards. The remainder not filling a vector uses the scalar code.
+ *
+ * Everything here has internal linkage, as the same kernels are compiled once per
+ * instruction set, and must never be merged by the linker.
+ */
+
+namespace {
+
+// Packed 24 bit samples are converted in blocks of 16, which are 48 bytes,
+// so whole vectors are loaded and stored without reading or writing past the block.
+constexpr size_t kP24Block = 16;
+
+template <typename V>
+PRIMITIVES_TARGET inline typename V::I clampAndRound(
+        typename V::F f, float scale, float limneg, float limpos)
+{
+    return V::roundI32(V::clampF(V::mulF(f, V::dupF(scale)), V::dupF(limneg), V::dupF(limpos)));
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI16FromQ4_27(int16_t *dst, const int32_t *src, size_t count)
+{
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI16(dst, V::template shrI<12>(V::loadI32(src)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clamp16(*src++ >> 12);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI16FromI32(int16_t *dst, const int32_t *src, size_t count)
+{
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI16(dst, V::template shrI<16>(V::loadI32(src)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = *src++ >> 16;
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI16FromFloat(int16_t *dst, const float *src, size_t count)
+{
+    static const float scale = 1 << 15;
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI16(dst, clampAndRound<V>(V::loadF(src), scale, -scale, scale - 1.f));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clamp16_from_float(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToFloatFromQ4_27(float *dst, const int32_t *src, size_t count)
+{
+    static const float scale = 1. / (float)(1UL << 27);
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeF(dst, V::mulF(V::toF(V::loadI32(src)), V::dupF(scale)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = float_from_q4_27(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToFloatFromI16(float *dst, const int16_t *src, size_t count)
+{
+    static const float scale = 1. / (float)(1UL << 15);
+    dst += count;
+    src += count;
+    for (; count % V::kLanes != 0; --count) {
+        *--dst = float_from_i16(*--src);
+    }
+    for (; count > 0; count -= V::kLanes) {
+        dst -= V::kLanes;
+        src -= V::kLanes;
+        V::storeF(dst, V::mulF(V::toF(V::loadI16(src)), V::dupF(scale)));
+    }
+}
+
+PRIMITIVES_TARGET inline void storeP24Sample(uint8_t *dst, int32_t ival)
+{
+    *dst++ = ival;
+    *dst++ = ival >> 8;
+    *dst++ = ival >> 16;
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToP24FromFloat(uint8_t *dst, const float *src, size_t count)
+{
+    static const float scale = 1 << 23;
+    typename V::I v[kP24Block / V::kLanes];
+    for (; count >= kP24Block; count -= kP24Block) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            v[i] = clampAndRound<V>(V::loadF(src + i * V::kLanes), scale, -scale, scale - 1.f);
+        }
+        V::storeP24(dst, v);
+        dst += kP24Block * 3;
+        src += kP24Block;
+    }
+    for (; count > 0; --count) {
+        storeP24Sample(dst, clamp24_from_float(*src++));
+        dst += 3;
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToP24FromQ8_23(uint8_t *dst, const int32_t *src, size_t count)
+{
+    const typename V::I limneg = V::dupI(-0x800000);
+    const typename V::I limpos = V::dupI(0x7fffff);
+    typename V::I v[kP24Block / V::kLanes];
+    for (; count >= kP24Block; count -= kP24Block) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            v[i] = V::clampI(V::loadI32(src + i * V::kLanes), limneg, limpos);
+        }
+        V::storeP24(dst, v);
+        dst += kP24Block * 3;
+        src += kP24Block;
+    }
+    for (; count > 0; --count) {
+        storeP24Sample(dst, clamp24_from_q8_23(*src++));
+        dst += 3;
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToP24FromI32(uint8_t *dst, const int32_t *src, size_t count)
+{
+    typename V::I v[kP24Block / V::kLanes];
+    for (; count >= kP24Block; count -= kP24Block) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            v[i] = V::template shrI<8>(V::loadI32(src + i * V::kLanes));
+        }
+        V::storeP24(dst, v);
+        dst += kP24Block * 3;
+        src += kP24Block;
+    }
+    for (; count > 0; --count) {
+        storeP24Sample(dst, *src++ >> 8);
+        dst += 3;
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToP24FromI16(uint8_t *dst, const int16_t *src, size_t count)
+{
+    typename V::I v[kP24Block / V::kLanes];
+    dst += count * 3;
+    src += count;
+    for (; count % kP24Block != 0; --count) {
+        dst -= 3;
+        storeP24Sample(dst, (int32_t)*--src << 8);
+    }
+    for (; count > 0; count -= kP24Block) {
+        dst -= kP24Block * 3;
+        src -= kP24Block;
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            v[i] = V::template shlI<8>(V::loadI16(src + i * V::kLanes));
+        }
+        V::storeP24(dst, v);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToFloatFromP24(float *dst, const uint8_t *src, size_t count)
+{
+    static const float scale = 1. / (float)(1UL << 31);
+    typename V::I v[kP24Block / V::kLanes];
+    dst += count;
+    src += count * 3;
+    for (; count % kP24Block != 0; --count) {
+        src -= 3;
+        *--dst = float_from_p24(src);
+    }
+    for (; count > 0; count -= kP24Block) {
+        dst -= kP24Block;
+        src -= kP24Block * 3;
+        V::loadP24(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            V::storeF(dst + i * V::kLanes, V::mulF(V::toF(v[i]), V::dupF(scale)));
+        }
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI16FromP24(int16_t *dst, const uint8_t *src, size_t count)
+{
+    typename V::I v[kP24Block / V::kLanes];
+    for (; count >= kP24Block; count -= kP24Block) {
+        V::loadP24(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            V::storeI16(dst + i * V::kLanes, V::template shrI<16>(v[i]));
+        }
+        dst += kP24Block;
+        src += kP24Block * 3;
+    }
+    for (; count > 0; --count) {
+        *dst++ = i32_from_p24(src) >> 16;
+        src += 3;
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI32FromP24(int32_t *dst, const uint8_t *src, size_t count)
+{
+    typename V::I v[kP24Block / V::kLanes];
+    dst += count;
+    src += count * 3;
+    for (; count % kP24Block != 0; --count) {
+        src -= 3;
+        *--dst = i32_from_p24(src);
+    }
+    for (; count > 0; count -= kP24Block) {
+        dst -= kP24Block;
+        src -= kP24Block * 3;
+        V::loadP24(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            V::storeI32(dst + i * V::kLanes, v[i]);
+        }
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToQ8_23FromP24(int32_t *dst, const uint8_t *src, size_t count)
+{
+    typename V::I v[kP24Block / V::kLanes];
+    dst += count;
+    src += count * 3;
+    for (; count % kP24Block != 0; --count) {
+        src -= 3;
+        *--dst = i32_from_p24(src) >> 8;
+    }
+    for (; count > 0; count -= kP24Block) {
+        dst -= kP24Block;
+        src -= kP24Block * 3;
+        V::loadP24(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            V::storeI32(dst + i * V::kLanes, V::template shrI<8>(v[i]));
+        }
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToQ8_23FromI16(int32_t *dst, const int16_t *src, size_t count)
+{
+    dst += count;
+    src += count;
+    for (; count % V::kLanes != 0; --count) {
+        *--dst = (int32_t)*--src << 8;
+    }
+    for (; count > 0; count -= V::kLanes) {
+        dst -= V::kLanes;
+        src -= V::kLanes;
+        V::storeI32(dst, V::template shlI<8>(V::loadI16(src)));
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToQ8_23FromFloatWithClamp(
+        int32_t *dst, const float *src, size_t count)
+{
+    static const float scale = 1 << 23;
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI32(dst, clampAndRound<V>(V::loadF(src), scale, -scale, scale - 1.f));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clamp24_from_float(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToQ4_27FromFloat(int32_t *dst, const float *src, size_t count)
+{
+    // roundI32() saturates, which is the clamping to [-16.0, 16.0) done by the reference.
+    static const float scale = (float)(1UL << 27);
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI32(dst, V::roundI32(V::mulF(V::loadF(src), V::dupF(scale))));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clampq4_27_from_float(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI16FromQ8_23(int16_t *dst, const int32_t *src, size_t count)
+{
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI16(dst, V::template shrI<8>(V::loadI32(src)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clamp16(*src++ >> 8);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToFloatFromQ8_23(float *dst, const int32_t *src, size_t count)
+{
+    static const float scale = 1. / (float)(1UL << 23);
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeF(dst, V::mulF(V::toF(V::loadI32(src)), V::dupF(scale)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = float_from_q8_23(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI32FromI16(int32_t *dst, const int16_t *src, size_t count)
+{
+    dst += count;
+    src += count;
+    for (; count % V::kLanes != 0; --count) {
+        *--dst = (int32_t)*--src << 16;
+    }
+    for (; count > 0; count -= V::kLanes) {
+        dst -= V::kLanes;
+        src -= V::kLanes;
+        V::storeI32(dst, V::template shlI<16>(V::loadI16(src)));
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToI32FromFloat(int32_t *dst, const float *src, size_t count)
+{
+    // roundI32() saturates, which is the clamping to [-1.0, 1.0) done by the reference.
+    static const float scale = (float)(1UL << 31);
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeI32(dst, V::roundI32(V::mulF(V::loadF(src), V::dupF(scale))));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = clamp32_from_float(*src++);
+    }
+}
+
+template <typename V>
+PRIMITIVES_TARGET void memcpyToFloatFromI32(float *dst, const int32_t *src, size_t count)
+{
+    static const float scale = 1. / (float)(1UL << 31);
+    for (; count >= V::kLanes; count -= V::kLanes) {
+        V::storeF(dst, V::mulF(V::toF(V::loadI32(src)), V::dupF(scale)));
+        dst += V::kLanes;
+        src += V::kLanes;
+    }
+    for (; count > 0; --count) {
+        *dst++ = float_from_i32(*src++);
+    }
+}
+
+// Sources of the accumulate_float_from_* kernels, which load kP24Block samples
+// at a time as float, before scaling.
+template <typename V>
+struct I16Source {
+    typedef int16_t S;
+    static constexpr size_t kStride = 1; // elements of S per sample
+    static float scale() { return 1.f / (1 << 15); }
+    static PRIMITIVES_TARGET void load(const S *src, typename V::F *f) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            f[i] = V::toF(V::loadI16(src + i * V::kLanes));
+        }
+    }
+    static float scalar(const S *src) { return *src; }
+};
+
+template <typename V>
+struct P24Source {
+    typedef uint8_t S;
+    static constexpr size_t kStride = 3;
+    static float scale() { return 1.f / (1UL << 31); }
+    static PRIMITIVES_TARGET void load(const S *src, typename V::F *f) {
+        typename V::I v[kP24Block / V::kLanes];
+        V::loadP24(src, v);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            f[i] = V::toF(v[i]);
+        }
+    }
+    static float scalar(const S *src) { return i32_from_p24(src); }
+};
+
+template <typename V>
+struct I32Source {
+    typedef int32_t S;
+    static constexpr size_t kStride = 1;
+    static float scale() { return 1.f / (1UL << 31); }
+    static PRIMITIVES_TARGET void load(const S *src, typename V::F *f) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            f[i] = V::toF(V::loadI32(src + i * V::kLanes));
+        }
+    }
+    static float scalar(const S *src) { return *src; }
+};
+
+template <typename V>
+struct FloatSource {
+    typedef float S;
+    static constexpr size_t kStride = 1;
+    static float scale() { return 1.f; }
+    static PRIMITIVES_TARGET void load(const S *src, typename V::F *f) {
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            f[i] = V::loadF(src + i * V::kLanes);
+        }
+    }
+    static float scalar(const S *src) { return *src; }
+};
+
+template <typename V, typename Source>
+PRIMITIVES_TARGET void accumulateFloatFrom(
+        float *dst, const typename Source::S *src, size_t count, float gain)
+{
+    const float g = gain * Source::scale();
+    const typename V::F vg = V::dupF(g);
+    typename V::F f[kP24Block / V::kLanes];
+    for (; count >= kP24Block; count -= kP24Block) {
+        Source::load(src, f);
+        for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+            float *d = dst + i * V::kLanes;
+            V::storeF(d, V::mulAddF(f[i], vg, V::loadF(d)));
+        }
+        dst += kP24Block;
+        src += kP24Block * Source::kStride;
+    }
+    for (; count > 0; --count) {
+        *dst++ += Source::scalar(src) * g;
+        src += Source::kStride;
+    }
+}
+
+// Channel counts above this use the scalar code.
+constexpr uint32_t kMaxVectorGainChannels = 8;
+
+template <typename V, typename Source>
+PRIMITIVES_TARGET void accumulateFloatFromByChannel(float *dst, const typename Source::S *src,
+        size_t frameCount, uint32_t channelCount, const float *gains)
+{
+    if (channelCount <= kMaxVectorGainChannels) {
+        // kP24Block frames are channelCount blocks of kP24Block samples,
+        // after which the pattern of gains repeats.
+        float pattern[kP24Block * kMaxVectorGainChannels];
+        for (size_t i = 0; i < kP24Block * channelCount; ++i) {
+            pattern[i] = gains[i % channelCount] * Source::scale();
+        }
+        typename V::F f[kP24Block / V::kLanes];
+        for (; frameCount >= kP24Block; frameCount -= kP24Block) {
+            for (size_t block = 0; block < channelCount; ++block) {
+                Source::load(src, f);
+                for (size_t i = 0; i < kP24Block / V::kLanes; ++i) {
+                    float *d = dst + i * V::kLanes;
+                    const float *g = pattern + block * kP24Block + i * V::kLanes;
+                    V::storeF(d, V::mulAddF(f[i], V::loadF(g), V::loadF(d)));
+                }
+                dst += kP24Block;
+                src += kP24Block * Source::kStride;
+            }
+        }
+    }
+    for (; frameCount > 0; --frameCount) {
+        for (uint32_t ch = 0; ch < channelCount; ++ch) {
+            *dst++ += Source::scalar(src) * (gains[ch] * Source::scale());
+            src += Source::kStride;
+        }
+    }
+}
+
+template <typename V>
+void fillPrimitivesTable(primitives_table_t *table)
+{
+    table->memcpy_to_i16_from_q4_27 = memcpyToI16FromQ4_27<V>;
+    table->memcpy_to_i16_from_i32 = memcpyToI16FromI32<V>;
+    table->memcpy_to_i16_from_float = memcpyToI16FromFloat<V>;
+    table->memcpy_to_float_from_q4_27 = memcpyToFloatFromQ4_27<V>;
+    table->memcpy_to_float_from_i16 = memcpyToFloatFromI16<V>;
+    table->memcpy_to_p24_from_float = memcpyToP24FromFloat<V>;
+    table->memcpy_to_q8_23_from_i16 = memcpyToQ8_23FromI16<V>;
+    table->memcpy_to_q8_23_from_float_with_clamp = memcpyToQ8_23FromFloatWithClamp<V>;
+    table->memcpy_to_q4_27_from_float = memcpyToQ4_27FromFloat<V>;
+    table->memcpy_to_i16_from_q8_23 = memcpyToI16FromQ8_23<V>;
+    table->memcpy_to_float_from_q8_23 = memcpyToFloatFromQ8_23<V>;
+    table->memcpy_to_i32_from_i16 = memcpyToI32FromI16<V>;
+    table->memcpy_to_i32_from_float = memcpyToI32FromFloat<V>;
+    table->memcpy_to_float_from_i32 = memcpyToFloatFromI32<V>;
+    table->memcpy_to_float_from_p24 = memcpyToFloatFromP24<V>;
+    table->memcpy_to_i16_from_p24 = memcpyToI16FromP24<V>;
+    table->memcpy_to_i32_from_p24 = memcpyToI32FromP24<V>;
+    table->memcpy_to_p24_from_i16 = memcpyToP24FromI16<V>;
+    table->memcpy_to_p24_from_q8_23 = memcpyToP24FromQ8_23<V>;
+    table->memcpy_to_p24_from_i32 = memcpyToP24FromI32<V>;
+    table->memcpy_to_q8_23_from_p24 = memcpyToQ8_23FromP24<V>;
+    table->accumulate_float_from_i16 = accumulateFloatFrom<V, I16Source<V>>;
+    table->accumulate_float_from_p24 = accumulateFloatFrom<V, P24Source<V>>;
+    table->accumulate_float_from_i32 = accumulateFloatFrom<V, I32Source<V>>;
+    table->accumulate_float_from_float = accumulateFloatFrom<V, FloatSource<V>>;
+    table->accumulate_float_from_i16_by_channel = accumulateFloatFromByChannel<V, I16Source<V>>;
+    table->accumulate_float_from_p24_by_channel = accumulateFloatFromByChannel<V, P24Source<V>>;
+    table->accumulate_float_from_i32_by_channel = accumulateFloatFromByChannel<V, I32Source<V>>;
+    table->accumulate_float_from_float_by_channel =
+            accumulateFloatFromByChannel<V, FloatSource<V>>;
+}
+
+} // namespace
+
+#endif // ANDROID_AUDIO_PRIMITIVES_VECTOR_H
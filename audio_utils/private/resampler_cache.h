@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_RESAMPLER_CACHE_H
+#define ANDROID_AUDIO_RESAMPLER_CACHE_H
+
+#include <stddef.h>
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+/* Not part of the public interface, only for the tests of the filter bank cache.
+ *
+ * Returns the number of filter banks in use by the resamplers of
+ * create_polyphase_resampler(). The filter banks are shared by the resamplers
+ * of the same ratio of sample rates and quality, so that creating a resampler
+ * like another is cheap.
+ */
+size_t resampler_get_filter_bank_count(void);
+
+__END_DECLS
+
+#endif // ANDROID_AUDIO_RESAMPLER_CACHE_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_RESAMPLER_VECTOR_H
+#define ANDROID_AUDIO_RESAMPLER_VECTOR_H
+
+#ifndef __cplusplus
+#error resampler_vector.h is C++ only
+#endif
+
+#include "private/primitives_vector.h"
+
+/*
+ * The FIR kernel of the polyphase resampler, shared by the vector backends.
+ * Included after primitives_vector.h, whose traits class V is sufficient.
+ *
+ * As for the energies, the kernel is not bit exact with the scalar code in
+ * polyphase_resampler.cpp, as the order of the additions differs.
+ */
+
+namespace {
+
+// Sums the lanes of two accumulators.
+template <typename V>
+PRIMITIVES_TARGET inline float sumLanes(typename V::F a, typename V::F b)
+{
+    float lanes[2 * V::kLanes];
+    V::storeF(lanes, a);
+    V::storeF(lanes + V::kLanes, b);
+    float sum = 0.f;
+    for (size_t i = 0; i < V::kLanes; ++i) {
+        sum += lanes[i] + lanes[i + V::kLanes];
+    }
+    return sum;
+}
+
+// The dot product of taps samples and coefficients, in two accumulators to hide the latency
+// of the multiply adds. taps is a multiple of 16, so of 2 * V::kLanes.
+template <typename V>
+PRIMITIVES_TARGET inline float dotF(const float *x, const float *coefs, size_t taps)
+{
+    typename V::F a = V::dupF(0.f);
+    typename V::F b = V::dupF(0.f);
+    for (size_t i = 0; i < taps; i += 2 * V::kLanes) {
+        a = V::mulAddF(V::loadF(x + i), V::loadF(coefs + i), a);
+        b = V::mulAddF(V::loadF(x + i + V::kLanes), V::loadF(coefs + i + V::kLanes), b);
+    }
+    return sumLanes<V>(a, b);
+}
+
+template <typename V>
+PRIMITIVES_TARGET void resamplerFirFloat(float *dst, const float *src, size_t stride,
+        uint32_t channelCount, const float *coefs, const float *nextCoefs, float alpha,
+        size_t taps)
+{
+    for (uint32_t ch = 0; ch < channelCount; ++ch) {
+        const float *x = src + ch * stride;
+        float sum = dotF<V>(x, coefs, taps);
+        if (nextCoefs != nullptr) {
+            sum += alpha * (dotF<V>(x, nextCoefs, taps) - sum);
+        }
+        dst[ch] = sum;
+    }
+}
+
+template <typename V>
+void fillResamplerTable(primitives_table_t *table)
+{
+    table->resampler_fir_float = resamplerFirFloat<V>;
+}
+
+} // namespace
+
+#endif // ANDROID_AUDIO_RESAMPLER_VECTOR_H
@@ -18,11 +18,13 @@
 #define LOG_TAG "resampler"
 
 #include <errno.h>
+#include <math.h>
 #include <stdlib.h>
 
 #include <log/log.h>
 
 #include <system/audio.h>
+#include <audio_utils/primitives.h>
 #include <audio_utils/resampler.h>
 #include <speex/speex_resampler.h>
 
@@ -187,7 +189,128 @@ int resampler_resample_from_input(struct resampler_itfe *resampler,
     return 0;
 }
 
-int create_resampler(uint32_t inSampleRate,
+int resampler_resample_from_input_float(struct resampler_itfe *resampler,
+                                        const float *in,
+                                        size_t *inFrameCount,
+                                        float *out,
+                                        size_t *outFrameCount)
+{
+    struct resampler *rsmp = (struct resampler *)resampler;
+
+    if (rsmp == NULL || in == NULL || inFrameCount == NULL ||
+            out == NULL || outFrameCount == NULL) {
+        return -EINVAL;
+    }
+    if (rsmp->provider != NULL) {
+        *outFrameCount = 0;
+        return -ENOSYS;
+    }
+
+    // speex resamples in float natively, so there is no conversion here.
+    spx_uint32_t inFrames = *inFrameCount;
+    spx_uint32_t outFrames = *outFrameCount;
+    if (rsmp->channel_count == 1) {
+        speex_resampler_process_float(rsmp->speex_resampler,
+                                      0,
+                                      in,
+                                      &inFrames,
+                                      out,
+                                      &outFrames);
+    } else {
+        speex_resampler_process_interleaved_float(rsmp->speex_resampler,
+                                                  in,
+                                                  &inFrames,
+                                                  out,
+                                                  &outFrames);
+    }
+    *inFrameCount = inFrames;
+    *outFrameCount = outFrames;
+
+    ALOGV("resampler_resample_from_input_float() DONE in %zu out %zu",
+            *inFrameCount, *outFrameCount);
+
+    return 0;
+}
+
+// The number of samples converted at a time by resampler_resample_from_input_i32().
+#define I32_CHUNK_SAMPLES 1024
+
+int resampler_resample_from_input_i32(struct resampler_itfe *resampler,
+                                      const int32_t *in,
+                                      size_t *inFrameCount,
+                                      int32_t *out,
+                                      size_t *outFrameCount)
+{
+    struct resampler *rsmp = (struct resampler *)resampler;
+
+    if (rsmp == NULL || in == NULL || inFrameCount == NULL ||
+            out == NULL || outFrameCount == NULL) {
+        return -EINVAL;
+    }
+    if (rsmp->provider != NULL) {
+        *outFrameCount = 0;
+        return -ENOSYS;
+    }
+
+    // Converts to and from float in chunks small enough for the stack, which stay in cache.
+    float inFloat[I32_CHUNK_SAMPLES];
+    float outFloat[I32_CHUNK_SAMPLES];
+    const uint32_t channelCount = rsmp->channel_count;
+    const size_t chunkFrames = I32_CHUNK_SAMPLES / channelCount;
+    size_t framesRd = 0;
+    size_t framesWr = 0;
+    while (framesRd < *inFrameCount && framesWr < *outFrameCount) {
+        size_t inFrames = *inFrameCount - framesRd;
+        if (inFrames > chunkFrames) {
+            inFrames = chunkFrames;
+        }
+        size_t outFrames = *outFrameCount - framesWr;
+        if (outFrames > chunkFrames) {
+            outFrames = chunkFrames;
+        }
+        memcpy_to_float_from_i32(inFloat, in + framesRd * channelCount, inFrames * channelCount);
+        resampler_resample_from_input_float(resampler, inFloat, &inFrames, outFloat, &outFrames);
+        memcpy_to_i32_from_float(out + framesWr * channelCount, outFloat,
+                outFrames * channelCount);
+        framesRd += inFrames;
+        framesWr += outFrames;
+        if (inFrames == 0 && outFrames == 0) {
+            break;
+        }
+    }
+    *inFrameCount = framesRd;
+    *outFrameCount = framesWr;
+
+    ALOGV("resampler_resample_from_input_i32() DONE in %zu out %zu",
+            *inFrameCount, *outFrameCount);
+
+    return 0;
+}
+
+int resampler_set_input_drift_ppm(struct resampler_itfe *resampler, float drift_ppm)
+{
+    struct resampler *rsmp = (struct resampler *)resampler;
+
+    if (rsmp == NULL || !(fabsf(drift_ppm) <= RESAMPLER_MAX_DRIFT_PPM)) {
+        return -EINVAL;
+    }
+    // speex takes the ratio of input to output frames as a fraction,
+    // scaled to the largest terms within 32 bits for a resolution of about 1e-9.
+    const uint32_t maxRate = rsmp->in_sample_rate > rsmp->out_sample_rate ?
+            rsmp->in_sample_rate : rsmp->out_sample_rate;
+    const double scale = floor(UINT32_MAX / (maxRate * (1. + RESAMPLER_MAX_DRIFT_PPM * 1e-6)));
+    const uint32_t den = (uint32_t)(rsmp->out_sample_rate * scale);
+    const uint32_t num = (uint32_t)(rsmp->in_sample_rate * scale * (1. + drift_ppm * 1e-6) + 0.5);
+    if (speex_resampler_set_rate_frac(rsmp->speex_resampler, num, den,
+            rsmp->in_sample_rate, rsmp->out_sample_rate) != RESAMPLER_ERR_SUCCESS) {
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static void resampler_release(struct resampler_itfe *resampler);
+
+int create_speex_resampler(uint32_t inSampleRate,
                     uint32_t outSampleRate,
                     uint32_t channelCount,
                     uint32_t quality,
@@ -197,7 +320,7 @@ int create_resampler(uint32_t inSampleRate,
     int error;
     struct resampler *rsmp;
 
-    ALOGV("create_resampler() In SR %d Out SR %d channels %d",
+    ALOGV("create_speex_resampler() In SR %d Out SR %d channels %d",
          inSampleRate, outSampleRate, channelCount);
 
     if (resampler == NULL) {
@@ -210,6 +333,10 @@ int create_resampler(uint32_t inSampleRate,
         return -EINVAL;
     }
 
+    if (channelCount == 0 || channelCount > RESAMPLER_MAX_CHANNEL_COUNT) {
+        return -EINVAL;
+    }
+
     rsmp = (struct resampler *)calloc(1, sizeof(struct resampler));
 
     rsmp->speex_resampler = speex_resampler_init(channelCount,
@@ -227,6 +354,10 @@ int create_resampler(uint32_t inSampleRate,
     rsmp->itfe.resample_from_provider = resampler_resample_from_provider;
     rsmp->itfe.resample_from_input = resampler_resample_from_input;
     rsmp->itfe.delay_ns = resampler_delay_ns;
+    rsmp->itfe.resample_from_input_float = resampler_resample_from_input_float;
+    rsmp->itfe.resample_from_input_i32 = resampler_resample_from_input_i32;
+    rsmp->itfe.release = resampler_release;
+    rsmp->itfe.set_input_drift_ppm = resampler_set_input_drift_ppm;
 
     rsmp->provider = provider;
     rsmp->in_sample_rate = inSampleRate;
@@ -243,12 +374,12 @@ int create_resampler(uint32_t inSampleRate,
     rsmp->speex_delay_ns += (int32_t)((1000000000 * (int64_t)frames) / rsmp->out_sample_rate);
 
     *resampler = &rsmp->itfe;
-    ALOGV("create_resampler() DONE rsmp %p &rsmp->itfe %p speex %p",
+    ALOGV("create_speex_resampler() DONE rsmp %p &rsmp->itfe %p speex %p",
          rsmp, &rsmp->itfe, rsmp->speex_resampler);
     return 0;
 }
 
-void release_resampler(struct resampler_itfe *resampler)
+static void resampler_release(struct resampler_itfe *resampler)
 {
     struct resampler *rsmp = (struct resampler *)resampler;
 
@@ -263,3 +394,14 @@ void release_resampler(struct resampler_itfe *resampler)
     }
     free(rsmp);
 }
+
+int create_resampler(uint32_t inSampleRate,
+                    uint32_t outSampleRate,
+                    uint32_t channelCount,
+                    uint32_t quality,
+                    struct resampler_buffer_provider* provider,
+                    struct resampler_itfe **resampler)
+{
+    return create_speex_resampler(inSampleRate, outSampleRate, channelCount, quality,
+            provider, resampler);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_AUDIO_UTILS_TESTS_ALLOC_COUNTER_H
+#define ANDROID_AUDIO_UTILS_TESTS_ALLOC_COUNTER_H
+
+// Counts the allocations and mutex locks of the current thread while tCounting is set,
+// by interposing malloc(), calloc(), realloc() and pthread_mutex_lock(), and replacing
+// the global operator new, including its aligned and nothrow overloads.
+// Include it in exactly one source file of a test binary.
+
+#include <algorithm>
+#include <atomic>
+#include <dlfcn.h>
+#include <new>
+#include <pthread.h>
+#include <stdlib.h>
+
+static thread_local bool tCounting;
+static std::atomic_int gAllocations;
+static std::atomic_int gLocks;
+
+extern "C" void *malloc(size_t size) {
+    static const auto real = reinterpret_cast<void *(*)(size_t)>(dlsym(RTLD_NEXT, "malloc"));
+    if (tCounting) {
+        gAllocations++;
+    }
+    return real(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+    static const auto real = reinterpret_cast<void *(*)(size_t, size_t)>(
+            dlsym(RTLD_NEXT, "calloc"));
+    if (tCounting) {
+        gAllocations++;
+    }
+    return real(count, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+    static const auto real = reinterpret_cast<void *(*)(void *, size_t)>(
+            dlsym(RTLD_NEXT, "realloc"));
+    if (tCounting) {
+        gAllocations++;
+    }
+    return real(p, size);
+}
+
+// Counted by malloc().
+void *operator new(size_t size) {
+    void *p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return malloc(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    if (tCounting) {
+        gAllocations++;
+    }
+    void *p;
+    if (posix_memalign(&p, std::max((size_t) alignment, sizeof(void *)), size) != 0) {
+        return nullptr;
+    }
+    return p;
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    void *p = operator new(size, alignment, std::nothrow);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t /* size */) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::align_val_t /* alignment */) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t /* size */, std::align_val_t /* alignment */) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, std::align_val_t /* alignment */, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex) {
+    static const auto real = reinterpret_cast<int (*)(pthread_mutex_t *)>(
+            dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    if (tCounting) {
+        gLocks++;
+    }
+    return real(mutex);
+}
+
+#endif // ANDROID_AUDIO_UTILS_TESTS_ALLOC_COUNTER_H
@@ -44,6 +44,18 @@ echo "format tests"
 adb push $OUT/data/nativetest/format_tests/format_tests /system/bin
 adb shell /system/bin/format_tests
 
+echo "mixer tests"
+adb push $OUT/data/nativetest/mixer_tests/mixer_tests /system/bin
+adb shell /system/bin/mixer_tests
+
+echo "echo_reference tests"
+adb push $OUT/data/nativetest/echo_reference_tests/echo_reference_tests /system/bin
+adb shell /system/bin/echo_reference_tests
+
+echo "resampler tests"
+adb push $OUT/data/nativetest/resampler_tests/resampler_tests /system/bin
+adb shell /system/bin/resampler_tests
+
 echo "simplelog tests"
 adb push $OUT/data/nativetest/simplelog_tests/simplelog_tests /system/bin
 adb shell /system/bin/simplelog_tests
@@ -64,6 +76,26 @@ echo "logplot tests"
 adb push $OUT/data/nativetest/logplot_tests/logplot_tests /system/bin
 adb shell /system/bin/logplot_tests
 
+echo "fifo_mpmc tests"
+adb push $OUT/data/nativetest/fifo_mpmc_tests/fifo_mpmc_tests /system/bin
+adb shell /system/bin/fifo_mpmc_tests
+
+echo "fifo_wake tests"
+adb push $OUT/data/nativetest/fifo_wake_tests/fifo_wake_tests /system/bin
+adb shell /system/bin/fifo_wake_tests
+
+echo "fifo_view tests"
+adb push $OUT/data/nativetest/fifo_view_tests/fifo_view_tests /system/bin
+adb shell /system/bin/fifo_view_tests
+
+echo "fifo32 tests"
+adb push $OUT/data/nativetest/fifo32_tests/fifo32_tests /system/bin
+adb shell /system/bin/fifo32_tests
+
+echo "fifo_broadcast tests"
+adb push $OUT/data/nativetest/fifo_broadcast_tests/fifo_broadcast_tests /system/bin
+adb shell /system/bin/fifo_broadcast_tests
+
 echo "benchmarking_statistics"
 adb push $OUT/system/bin/statistics_benchmark /system/bin
 adb shell /system/bin/statistics_benchmark
@@ -71,3 +103,7 @@ adb shell /system/bin/statistics_benchmark
 echo "benchmarking primitives"
 adb push $OUT/system/bin/primitives_benchmark /system/bin
 adb shell /system/bin/primitives_benchmark
+
+echo "benchmarking resampler"
+adb push $OUT/system/bin/resampler_benchmark /system/bin
+adb shell /system/bin/resampler_benchmark
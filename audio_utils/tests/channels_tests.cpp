@@ -18,12 +18,14 @@
 #define LOG_TAG "audio_utils_channels_tests"
 
 #include <math.h>
+#include <random>
 #include <vector>
 
 #include <gtest/gtest.h>
 #include <log/log.h>
 
 #include <audio_utils/channels.h>
+#include <audio_utils/primitives.h>
 
 // TODO: Make a common include file for helper functions.
 
@@ -201,3 +203,62 @@ TEST(audio_utils_channels, adjust_channels_non_destructive) {
     // Comparison array must be identical to reference.
     expectEq(u16inout, u16ref);
 }
+
+// Runs adjust_channels() with the given primitives backend, either in place or not,
+// on a buffer of max(inChans, outChans) channels filled from src.
+static std::vector<uint8_t> adjustChannelsWithBackend(
+        audio_utils_primitives_backend_t backend, bool inPlace, const std::vector<uint8_t> &src,
+        size_t inChans, size_t outChans, unsigned sampleSize, size_t frames, size_t *outBytes)
+{
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(backend));
+    std::vector<uint8_t> in(src.begin(), src.end());
+    std::vector<uint8_t> out(src.rbegin(), src.rend());
+    *outBytes = adjust_channels(in.data(), inChans, inPlace ? in.data() : out.data(), outChans,
+            sampleSize, frames * inChans * sampleSize);
+    return inPlace ? in : out;
+}
+
+TEST(audio_utils_channels, adjust_channels_backends_bit_exact) {
+    const audio_utils_primitives_backend_t original = audio_utils_primitives_get_backend();
+    constexpr size_t maxChans = 8;
+    constexpr size_t frameCounts[] = {0, 1, 15, 16, 17, 31, 48, 63, 100, 255, 256, 257, 1000};
+    std::minstd_rand gen(42);
+    std::uniform_int_distribution<> dis(0, UINT8_MAX);
+    std::vector<uint8_t> src(frameCounts[std::size(frameCounts) - 1] * maxChans * 4);
+    for (auto &byte : src) {
+        byte = dis(gen);
+    }
+
+    // The vector kernels cover common channel counts, the others check the fallback.
+    for (const audio_utils_primitives_backend_t backend : {
+            AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1,
+            AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2,
+            AUDIO_UTILS_PRIMITIVES_BACKEND_NEON}) {
+        if (audio_utils_primitives_set_backend(backend) != 0) continue;
+        for (size_t inChans = 1; inChans <= maxChans; ++inChans) {
+            for (size_t outChans = 1; outChans <= maxChans; ++outChans) {
+                for (unsigned sampleSize = 1; sampleSize <= 4; ++sampleSize) {
+                    for (const size_t frames : frameCounts) {
+                        for (const bool inPlace : {false, true}) {
+                            SCOPED_TRACE(testing::Message() << "backend " << backend
+                                    << " " << inChans << " to " << outChans
+                                    << " channels of " << sampleSize << " bytes, "
+                                    << frames << " frames" << (inPlace ? " in place" : ""));
+                            size_t expectedBytes, checkBytes;
+                            const std::vector<uint8_t> expected = adjustChannelsWithBackend(
+                                    AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR, inPlace, src,
+                                    inChans, outChans, sampleSize, frames, &expectedBytes);
+                            const std::vector<uint8_t> check = adjustChannelsWithBackend(
+                                    backend, inPlace, src,
+                                    inChans, outChans, sampleSize, frames, &checkBytes);
+                            ASSERT_EQ(frames * outChans * sampleSize, expectedBytes);
+                            ASSERT_EQ(expectedBytes, checkBytes);
+                            ASSERT_EQ(expected, check);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(original));
+}
@@ -0,0 +1,421 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_echo_reference_tests"
+
+#include <math.h>
+#include <stdlib.h>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+#include <audio_utils/Statistics.h>
+#include <audio_utils/clock.h>
+#include <gtest/gtest.h>
+#include <system/audio.h>
+#include <audio_utils/echo_reference.h>
+
+#include "alloc_counter.h"
+
+static constexpr uint32_t kWriteSampleRate = 48000;
+static constexpr int64_t kPeriodNs = 10000000;          // of the writes and reads
+static constexpr int32_t kPlaybackDelayNs = 30000000;
+static constexpr int32_t kCaptureDelayNs = 10000000;
+
+static struct timespec timespecFromNs(int64_t ns) {
+    return {(time_t) (ns / 1000000000), (long) (ns % 1000000000)};
+}
+
+static int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return audio_utils_ns_from_timespec(&ts);
+}
+
+static void sleepUntilNs(int64_t ns) {
+    const struct timespec ts = timespecFromNs(ns);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL /* remain */);
+}
+
+TEST(audio_utils_echo_reference, invalid) {
+    struct echo_reference_itfe *er;
+    EXPECT_EQ(-EINVAL, create_echo_reference(AUDIO_FORMAT_PCM_FLOAT, 1, 16000,
+            AUDIO_FORMAT_PCM_FLOAT, 2, 48000, &er));
+    EXPECT_EQ(-EINVAL, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 1, 16000,
+            AUDIO_FORMAT_PCM_16_BIT, 1, 48000, &er));
+    EXPECT_EQ(-EINVAL, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 1, 0,
+            AUDIO_FORMAT_PCM_16_BIT, 2, 48000, &er));
+    EXPECT_EQ(NULL, er);
+}
+
+TEST(audio_utils_echo_reference, silent_until_written) {
+    struct echo_reference_itfe *er;
+    ASSERT_EQ(0, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 1, 16000,
+            AUDIO_FORMAT_PCM_16_BIT, 2, 48000, &er));
+    std::vector<int16_t> frames(160, 1);
+    struct echo_reference_buffer buffer = {frames.data(), frames.size(), kCaptureDelayNs,
+            timespecFromNs(monotonicNs())};
+    EXPECT_EQ(0, er->read(er, &buffer));
+    EXPECT_EQ(std::vector<int16_t>(frames.size()), frames);
+    EXPECT_EQ(0, er->read(er, NULL));
+    release_echo_reference(er);
+}
+
+// The writer and the reader run on their own threads, at the pace of their periods,
+// with time stamps as from the DMA positions of the playback and capture.
+// The playback clock runs writeDriftPpm faster than the capture clock.
+// The writer renders a click every 100 ms on its left channel, which the reader captures at once.
+// The latency is the mean difference between the capture time of a click read in
+// the echo reference, and its render time; the jitter is their standard deviation.
+// For a stereo read, the writer renders a sine on its right channel, which the reader
+// checks is read without discontinuities.
+static void testTwoThreads(uint32_t readSampleRate, uint32_t readChannelCount,
+        size_t periods = 100, double writeDriftPpm = 0., bool driftCompensation = false) {
+    struct echo_reference_itfe *er;
+    ASSERT_EQ(0, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, readChannelCount,
+            readSampleRate, AUDIO_FORMAT_PCM_16_BIT, 2, kWriteSampleRate, &er));
+    ASSERT_EQ(0, echo_reference_set_drift_compensation(er, driftCompensation));
+
+    constexpr size_t kClickFrames = kWriteSampleRate / 10;
+    constexpr double kSineHz = 250.;
+    const double sineAmplitude = readChannelCount == 2 ? 8192. : 0.;
+    const size_t writeFrames = kWriteSampleRate * kPeriodNs / 1000000000;
+    const size_t readFrames = readSampleRate * kPeriodNs / 1000000000;
+    // The periods of the writes and the clicks, on the capture clock.
+    const double writePeriodNs = kPeriodNs / (1. + writeDriftPpm * 1e-6);
+    const double clickPeriodNs = writePeriodNs * kClickFrames / writeFrames;
+    // Starts the threads after the set up, with the reads half a period after the writes.
+    const int64_t startNs = monotonicNs() + kPeriodNs;
+
+    android::audio_utils::Statistics<double> writeNs;
+    std::thread writer([&] {
+        std::vector<int16_t> frames(writeFrames * 2);
+        for (size_t period = 0; period < periods; ++period) {
+            const int64_t nowNs = startNs + (int64_t) (period * writePeriodNs);
+            sleepUntilNs(nowNs);
+            for (size_t i = 0; i < writeFrames; ++i) {
+                const size_t frame = period * writeFrames + i;
+                frames[2 * i] = frame % kClickFrames == 0 ? 16384 : 0;
+                frames[2 * i + 1] = sineAmplitude
+                        * sin(2. * M_PI * kSineHz * frame / kWriteSampleRate);
+            }
+            // The first frame written is rendered kPlaybackDelayNs after nowNs.
+            struct echo_reference_buffer buffer = {frames.data(), writeFrames,
+                    kPlaybackDelayNs, timespecFromNs(nowNs)};
+            const int64_t beginNs = monotonicNs();
+            er->write(er, &buffer);
+            writeNs.add(monotonicNs() - beginNs);
+        }
+        er->write(er, NULL);
+    });
+
+    // The capture times of the clicks read, and the sine read.
+    std::vector<int64_t> clickNs;
+    std::vector<int16_t> sine;
+    std::thread reader([&] {
+        std::vector<int16_t> frames(readFrames * readChannelCount);
+        int16_t peak = 0;
+        int64_t peakNs = 0;
+        for (size_t period = 0; period < periods; ++period) {
+            const int64_t nowNs = startNs + period * kPeriodNs + kPeriodNs / 2;
+            sleepUntilNs(nowNs);
+            // The first frame read was captured kCaptureDelayNs before nowNs.
+            const int64_t captureNs = nowNs - kCaptureDelayNs;
+            struct echo_reference_buffer buffer = {frames.data(), readFrames,
+                    kCaptureDelayNs, timespecFromNs(nowNs)};
+            er->read(er, &buffer);
+            EXPECT_EQ(0, buffer.delay_ns);
+            for (size_t i = 0; i < readFrames; ++i) {
+                const int16_t sample = frames[i * readChannelCount];
+                if (sample > peak) {
+                    peak = sample;
+                    peakNs = captureNs + (int64_t) i * 1000000000 / readSampleRate;
+                } else if (peak > 0 && sample < peak / 2) {
+                    if (peak > 2048) {
+                        clickNs.push_back(peakNs);
+                    }
+                    peak = 0;
+                }
+                if (readChannelCount == 2) {
+                    sine.push_back(frames[i * 2 + 1]);
+                }
+            }
+        }
+        er->read(er, NULL);
+    });
+    writer.join();
+    reader.join();
+    const float driftPpm = echo_reference_get_drift_ppm(er);
+    release_echo_reference(er);
+
+    // All the clicks written after the first read, which starts the writes, are read.
+    const int64_t firstRenderNs = startNs + kPlaybackDelayNs;
+    const int64_t lastCaptureNs = startNs + kPeriodNs / 2 - kCaptureDelayNs
+            + (periods - 1) * kPeriodNs;
+    const int64_t lastRenderNs = firstRenderNs + (int64_t) ((periods - 1) * writePeriodNs);
+    size_t expectedClicks = 0;
+    for (double renderNs = firstRenderNs; renderNs < std::min(lastCaptureNs, lastRenderNs);
+            renderNs += clickPeriodNs) {
+        expectedClicks += renderNs >= firstRenderNs + writePeriodNs;
+    }
+    EXPECT_LE(expectedClicks, clickNs.size());
+
+    android::audio_utils::Statistics<double> latencyNs;
+    for (const int64_t ns : clickNs) {
+        const int64_t click = llround((ns - firstRenderNs) / clickPeriodNs);
+        latencyNs.add(ns - (firstRenderNs + click * clickPeriodNs));
+    }
+    printf("read %u Hz: latency %.1f us, jitter %.1f us, max write %.1f us, drift %.1f ppm\n",
+            readSampleRate, latencyNs.getMean() * 1e-3, latencyNs.getStdDev() * 1e-3,
+            writeNs.getMax() * 1e-3, driftPpm);
+    // Within the frames of the read and the write, and those of the resampler phase,
+    // and for a drift, the deviation accumulated until it is estimated.
+    const double frameNs = 1e9 / readSampleRate + 1e9 / kWriteSampleRate
+            + fabs(writeDriftPpm) * 100.;
+    EXPECT_LE(latencyNs.getMax(), frameNs);
+    EXPECT_GE(latencyNs.getMin(), -frameNs);
+    EXPECT_LE(latencyNs.getStdDev(), frameNs / 2);
+    if (driftCompensation) {
+        EXPECT_NEAR(writeDriftPpm, driftPpm, 10.);
+    }
+
+    // Once read, the second differences of the sine stay those of its frequency.
+    const double step = 2. * M_PI * kSineHz / readSampleRate;
+    const double maxDifference = 2. * sineAmplitude * step * step + 8.;
+    const size_t firstSample = readSampleRate / 10;
+    // Until the writer stops, at most a period before the reader.
+    for (size_t i = firstSample + 1; i + 1 + 2 * readFrames < sine.size(); ++i) {
+        const int difference = sine[i + 1] - 2 * sine[i] + sine[i - 1];
+        ASSERT_LE(abs(difference), maxDifference) << "at frame " << i;
+    }
+}
+
+TEST(audio_utils_echo_reference, two_threads) {
+    testTwoThreads(48000 /* readSampleRate */, 2 /* readChannelCount */);
+}
+
+TEST(audio_utils_echo_reference, two_threads_resampled) {
+    testTwoThreads(16000 /* readSampleRate */, 1 /* readChannelCount */);
+}
+
+TEST(audio_utils_echo_reference, two_threads_drift_compensated) {
+    // Without the compensation, the reference would lag by up to 300 us, below the threshold
+    // of its realignment.
+    testTwoThreads(16000 /* readSampleRate */, 2 /* readChannelCount */, 300 /* periods */,
+            100. /* writeDriftPpm */, true /* driftCompensation */);
+}
+
+// The writer and the reader are called in turn on this thread, in the order of their synthetic
+// time stamps, so that long runs take little time. Stereo frames are written every
+// writePeriodNs, and read at readSampleRate every readPeriodNs, with the playback clock running
+// writeDriftPpm faster than the capture clock. As for testTwoThreads(), the writer renders
+// clicks on its left channel, every 300 ms so that a misalignment by a multiple of 100 ms
+// is not hidden, and a sine on its right channel.
+// Once aligned, the clicks must be read at their render time, and the sine without
+// discontinuities, so without any realignment of the reference until the end.
+static void testSyntheticTime(uint32_t readSampleRate, int64_t writePeriodNs,
+        int64_t readPeriodNs, int32_t playbackDelayNs, double seconds,
+        double writeDriftPpm = 0., bool driftCompensation = false) {
+    struct echo_reference_itfe *er;
+    ASSERT_EQ(0, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 2, readSampleRate,
+            AUDIO_FORMAT_PCM_16_BIT, 2, kWriteSampleRate, &er));
+    ASSERT_EQ(0, echo_reference_set_drift_compensation(er, driftCompensation));
+
+    constexpr size_t kClickFrames = kWriteSampleRate * 3 / 10;
+    constexpr double kSineHz = 250.;
+    constexpr double kSineAmplitude = 8192.;
+    // The clicks and the sine read until the reference is aligned are not checked.
+    constexpr int64_t kAlignmentNs = 200000000;
+    const size_t writeFrames = kWriteSampleRate * writePeriodNs / 1000000000;
+    const size_t readFrames = readSampleRate * readPeriodNs / 1000000000;
+    // The periods of the writes and the clicks, on the capture clock.
+    const double scaledWritePeriodNs = writePeriodNs / (1. + writeDriftPpm * 1e-6);
+    const double clickPeriodNs = scaledWritePeriodNs * kClickFrames / writeFrames;
+    const int64_t startNs = monotonicNs();
+    const int64_t endNs = startNs + (int64_t) (seconds * 1e9);
+    // The render time of the first frame written, a click, though discarded until the first read.
+    const int64_t firstRenderNs = startNs + playbackDelayNs;
+
+    std::vector<int16_t> writeBuffer(writeFrames * 2);
+    std::vector<int16_t> readBuffer(readFrames * 2);
+    std::vector<int64_t> clickNs;
+    std::vector<int16_t> sine;
+    int16_t peak = 0;
+    int64_t peakNs = 0;
+    size_t writes = 0;
+    size_t reads = 0;
+    for (;;) {
+        const int64_t writeNs = startNs + (int64_t) (writes * scaledWritePeriodNs);
+        const int64_t readNs = startNs + reads * readPeriodNs + readPeriodNs / 2;
+        if (std::min(writeNs, readNs) >= endNs) {
+            break;
+        }
+        if (writeNs <= readNs) {
+            for (size_t i = 0; i < writeFrames; ++i) {
+                const size_t frame = writes * writeFrames + i;
+                writeBuffer[2 * i] = frame % kClickFrames == 0 ? 16384 : 0;
+                writeBuffer[2 * i + 1] = kSineAmplitude
+                        * sin(2. * M_PI * kSineHz * frame / kWriteSampleRate);
+            }
+            struct echo_reference_buffer buffer = {writeBuffer.data(), writeFrames,
+                    playbackDelayNs, timespecFromNs(writeNs)};
+            ASSERT_EQ(0, er->write(er, &buffer));
+            ++writes;
+            continue;
+        }
+        const int64_t captureNs = readNs - kCaptureDelayNs;
+        struct echo_reference_buffer buffer = {readBuffer.data(), readFrames,
+                kCaptureDelayNs, timespecFromNs(readNs)};
+        ASSERT_EQ(0, er->read(er, &buffer));
+        for (size_t i = 0; i < readFrames; ++i) {
+            const int16_t sample = readBuffer[i * 2];
+            if (sample > peak) {
+                peak = sample;
+                peakNs = captureNs + (int64_t) i * 1000000000 / readSampleRate;
+            } else if (peak > 0 && sample < peak / 2) {
+                if (peak > 2048 && peakNs >= startNs + kAlignmentNs) {
+                    clickNs.push_back(peakNs);
+                }
+                peak = 0;
+            }
+            if (captureNs >= startNs + kAlignmentNs) {
+                sine.push_back(readBuffer[i * 2 + 1]);
+            }
+        }
+        ++reads;
+    }
+    er->write(er, NULL);
+    er->read(er, NULL);
+    const float driftPpm = echo_reference_get_drift_ppm(er);
+    release_echo_reference(er);
+
+    // All the clicks rendered from the alignment until the last read are read.
+    const double lastRenderNs = endNs - readPeriodNs - kCaptureDelayNs;
+    const size_t expectedClicks = (lastRenderNs - (startNs + kAlignmentNs)) / clickPeriodNs;
+    EXPECT_LE(expectedClicks, clickNs.size());
+
+    android::audio_utils::Statistics<double> latencyNs;
+    for (const int64_t ns : clickNs) {
+        const int64_t click = llround((ns - firstRenderNs) / clickPeriodNs);
+        latencyNs.add(ns - (firstRenderNs + click * clickPeriodNs));
+    }
+    printf("write %.1f ms, read %.1f ms at %u Hz, drift %.1f ppm: latency %.1f us, "
+            "min %.1f us, max %.1f us, drift estimate %.1f ppm\n",
+            writePeriodNs * 1e-6, readPeriodNs * 1e-6, readSampleRate, writeDriftPpm,
+            latencyNs.getMean() * 1e-3, latencyNs.getMin() * 1e-3, latencyNs.getMax() * 1e-3,
+            driftPpm);
+    // Within the frames of the read and the write, and those of the resampler phase,
+    // and for a drift, the deviation accumulated until it is estimated.
+    const double frameNs = 1e9 / readSampleRate + 1e9 / kWriteSampleRate
+            + fabs(writeDriftPpm) * 100.;
+    EXPECT_LE(latencyNs.getMax(), frameNs);
+    EXPECT_GE(latencyNs.getMin(), -frameNs);
+    if (driftCompensation) {
+        EXPECT_NEAR(writeDriftPpm, driftPpm, 1.);
+    }
+
+    // The second differences of the sine stay those of its frequency.
+    const double step = 2. * M_PI * kSineHz / readSampleRate;
+    const double maxDifference = 2. * kSineAmplitude * step * step + 8.;
+    for (size_t i = 1; i + 1 < sine.size(); ++i) {
+        const int difference = sine[i + 1] - 2 * sine[i] + sine[i - 1];
+        ASSERT_LE(abs(difference), maxDifference) << "at frame " << i;
+    }
+}
+
+TEST(audio_utils_echo_reference, short_writes) {
+    // 20 writes of 1 ms for each read of 20 ms, rendered 100 ms after they are written.
+    testSyntheticTime(16000 /* readSampleRate */, 1000000 /* writePeriodNs */,
+            20000000 /* readPeriodNs */, 100000000 /* playbackDelayNs */, 5. /* seconds */);
+}
+
+// A minute of drift compensation, much longer than the correction of the alignment,
+// so that a correction of the wrong sign would realign the reference.
+TEST(audio_utils_echo_reference, drift_compensated_long_run) {
+    for (const double writeDriftPpm : {0., 100., -100., 500.}) {
+        SCOPED_TRACE(writeDriftPpm);
+        testSyntheticTime(16000 /* readSampleRate */, kPeriodNs /* writePeriodNs */,
+                kPeriodNs /* readPeriodNs */, kPlaybackDelayNs, 60. /* seconds */,
+                writeDriftPpm, true /* driftCompensation */);
+    }
+}
+
+// Once the drift compensation is disabled, a reference at the sampling rate of the capture
+// is copied again, as if the drift compensation had never been enabled.
+TEST(audio_utils_echo_reference, drift_compensation_disabled) {
+    struct echo_reference_itfe *ers[2];
+    for (auto &er : ers) {
+        ASSERT_EQ(0, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 2, kWriteSampleRate,
+                AUDIO_FORMAT_PCM_16_BIT, 2, kWriteSampleRate, &er));
+    }
+    ASSERT_EQ(0, echo_reference_set_drift_compensation(ers[1], true));
+    ASSERT_EQ(0, echo_reference_set_drift_compensation(ers[1], false));
+
+    const size_t frameCount = kWriteSampleRate * kPeriodNs / 1000000000;
+    std::vector<int16_t> writeBuffer(frameCount * 2);
+    std::vector<int16_t> readBuffers[2] = {writeBuffer, writeBuffer};
+    const int64_t startNs = monotonicNs();
+    for (size_t period = 0; period < 50; ++period) {
+        for (size_t i = 0; i < writeBuffer.size(); ++i) {
+            writeBuffer[i] = 8192. * sin(2. * M_PI * (period * writeBuffer.size() + i) / 97.);
+        }
+        const int64_t writeNs = startNs + period * kPeriodNs;
+        for (size_t j = 0; j < 2; ++j) {
+            struct echo_reference_buffer buffer = {writeBuffer.data(), frameCount,
+                    kPlaybackDelayNs, timespecFromNs(writeNs)};
+            ASSERT_EQ(0, ers[j]->write(ers[j], &buffer));
+            buffer = {readBuffers[j].data(), frameCount, kCaptureDelayNs,
+                    timespecFromNs(writeNs + kPeriodNs / 2)};
+            ASSERT_EQ(0, ers[j]->read(ers[j], &buffer));
+        }
+        ASSERT_EQ(readBuffers[0], readBuffers[1]) << "period " << period;
+    }
+    for (auto &er : ers) {
+        er->write(er, NULL);
+        er->read(er, NULL);
+        release_echo_reference(er);
+    }
+}
+
+TEST(audio_utils_echo_reference, write_does_not_block_or_allocate) {
+    struct echo_reference_itfe *er;
+    ASSERT_EQ(0, create_echo_reference(AUDIO_FORMAT_PCM_16_BIT, 1, 16000,
+            AUDIO_FORMAT_PCM_16_BIT, 2, kWriteSampleRate, &er));
+    std::vector<int16_t> frames(480 * 2);
+    std::vector<int16_t> readFrames(160);
+    int64_t nowNs = monotonicNs();
+    struct echo_reference_buffer buffer = {readFrames.data(), readFrames.size(),
+            kCaptureDelayNs, timespecFromNs(nowNs)};
+    er->read(er, &buffer);  // starts reading
+
+    gAllocations = 0;
+    gLocks = 0;
+    tCounting = true;
+    for (int i = 0; i < 100; ++i) {
+        nowNs += kPeriodNs;
+        struct echo_reference_buffer buffer = {frames.data(), 480, kPlaybackDelayNs,
+                timespecFromNs(nowNs)};
+        EXPECT_EQ(0, er->write(er, &buffer));
+    }
+    tCounting = false;
+    EXPECT_EQ(0, gAllocations);
+    EXPECT_EQ(0, gLocks);
+
+    er->write(er, NULL);
+    er->read(er, NULL);
+    release_echo_reference(er);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo32_tests"
+
+#include <vector>
+
+#include <audio_utils/fifo_reader32.h>
+#include <audio_utils/fifo_writer32.h>
+#include <gtest/gtest.h>
+
+class audio_utils_fifo32 : public ::testing::TestWithParam<uint32_t /*nonTemporalFrames*/> {
+};
+
+TEST_P(audio_utils_fifo32, round_trip) {
+    constexpr uint32_t kFrameCount = 64;
+    std::vector<int32_t> buffer(kFrameCount);
+    audio_utils_fifo fifo(kFrameCount, sizeof(int32_t), buffer.data());
+    audio_utils_fifo_writer32 writer(fifo);
+    audio_utils_fifo_reader32 reader(fifo);
+    writer.setNonTemporal(GetParam());
+    reader.setNonTemporal(GetParam());
+
+    // Transfer counts which are not divisors of the capacity, so that transfers wrap around.
+    int32_t next = 0, expected = 0;
+    std::vector<int32_t> frames(kFrameCount);
+    for (uint32_t count : {1u, 5u, 17u, 40u, 64u, 3u, 33u, 64u, 7u}) {
+        for (uint32_t i = 0; i < count; ++i) {
+            frames[i] = next++;
+        }
+        writer.write(frames.data(), count);
+        EXPECT_EQ(0u, reader.loadAcquire());    // not yet committed
+        writer.storeRelease();
+        ASSERT_EQ(count, reader.loadAcquire());
+
+        // A read of part of the frames, then a read of the rest with read1.
+        const uint32_t part = count / 2;
+        ASSERT_EQ(part, reader.read(frames.data(), part));
+        for (uint32_t i = part; i < count; ++i) {
+            frames[i] = reader.read1();
+        }
+        EXPECT_EQ(0u, reader.read(frames.data(), count));
+        for (uint32_t i = 0; i < count; ++i) {
+            ASSERT_EQ(expected++, frames[i]);
+        }
+        reader.storeRelease();
+    }
+    EXPECT_EQ(0u, reader.totalLost());
+}
+
+INSTANTIATE_TEST_CASE_P(nonTemporal, audio_utils_fifo32, ::testing::Values(0u, 1u, 16u));
+
+TEST(audio_utils_fifo_reader32, ordinary_writer_is_throttled) {
+    constexpr uint32_t kFrameCount = 16;
+    int32_t buffer[kFrameCount];
+    audio_utils_fifo fifo(kFrameCount, sizeof(int32_t), buffer);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader32 reader(fifo);
+
+    int32_t frames[kFrameCount] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    ASSERT_EQ(12, writer.write(frames, 12));
+    ASSERT_EQ(12u, reader.loadAcquire());
+    ASSERT_EQ(10u, reader.read(frames, 10));
+    EXPECT_EQ(10, frames[9]);
+    // The writer sees the frames read only after the reader commits them.
+    EXPECT_EQ(4, writer.available());
+    reader.storeRelease();
+    EXPECT_EQ(14, writer.available());
+}
+
+TEST(audio_utils_fifo_reader32, overrun) {
+    constexpr uint32_t kFrameCount = 16;
+    int32_t buffer[kFrameCount];
+    audio_utils_fifo fifo(kFrameCount, sizeof(int32_t), buffer, false /*throttlesWriter*/);
+    audio_utils_fifo_writer32 writer(fifo);
+    audio_utils_fifo_reader32 reader(fifo, false /*throttlesWriter*/);
+
+    for (int32_t i = 0; i < 20; ++i) {
+        writer.write1(i);
+    }
+    writer.storeRelease();
+    // The first 4 frames were overwritten, and the rest are still valid.
+    ASSERT_EQ(kFrameCount, reader.loadAcquire());
+    EXPECT_EQ(4u, reader.totalLost());
+    int32_t frames[kFrameCount];
+    ASSERT_EQ(kFrameCount, reader.read(frames, kFrameCount));
+    for (uint32_t i = 0; i < kFrameCount; ++i) {
+        EXPECT_EQ((int32_t) i + 4, frames[i]);
+    }
+}
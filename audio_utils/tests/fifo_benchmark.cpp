@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <audio_utils/fifo.h>
+#include <audio_utils/fifo_reader32.h>
+#include <audio_utils/fifo_writer32.h>
+#include <benchmark/benchmark.h>
+
+static constexpr uint32_t kFrameCount = 1024;
+
+// The indices side by side, as callers have typically allocated them.
+struct AdjacentIndices {
+    audio_utils_fifo_index mRear;
+    audio_utils_fifo_index mFront;
+};
+
+// Transfers frames of int32_t between a writer and a throttling reader on another thread,
+// both polling without blocking, and without hysteresis wakes, to measure the cost of
+// the index traffic between the cores.
+// The first argument is the number of frames per transfer, and the second argument is
+// 0 for adjacent indices and 1 for the padded audio_utils_fifo_control.
+static void BM_FifoTransfer(benchmark::State& state) {
+    const size_t count = state.range(0);
+    std::vector<int32_t> buffer(kFrameCount);
+    AdjacentIndices adjacent;
+    audio_utils_fifo_control control;
+    audio_utils_fifo_index& rear = state.range(1) == 0 ? adjacent.mRear : control.mRear;
+    audio_utils_fifo_index& front = state.range(1) == 0 ? adjacent.mFront : control.mFront;
+    audio_utils_fifo fifo(kFrameCount, sizeof(int32_t), buffer.data(), rear, &front);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    writer.setHysteresis(0 /*armLevel*/, kFrameCount /*triggerLevel*/);
+    reader.setHysteresis(kFrameCount /*armLevel*/, 0 /*triggerLevel*/);
+
+    std::atomic<bool> done(false);
+    std::thread readerThread([&]() {
+        std::vector<int32_t> frames(count);
+        while (!done.load(std::memory_order_relaxed)) {
+            benchmark::DoNotOptimize(reader.read(frames.data(), count));
+        }
+    });
+
+    std::vector<int32_t> frames(count);
+    for (auto _ : state) {
+        for (size_t written = 0; written < count; ) {
+            const ssize_t actual = writer.write(frames.data() + written, count - written);
+            if (actual > 0) {
+                written += actual;
+            }
+        }
+    }
+    done = true;
+    readerThread.join();
+
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(state.range(1) == 0 ? "adjacent" : "padded");
+}
+
+BENCHMARK(BM_FifoTransfer)->ArgsProduct({{1, 32, 256}, {0, 1}})->UseRealTime();
+
+// Same as BM_FifoTransfer with padded indices, but with writer32 and reader32.
+// The writer checks the front index itself, as writer32 does not support throttling.
+// The first argument is the number of frames per transfer, and the second argument is
+// the minimum transfer count for non-temporal stores by the writer, or 0 for never.
+static void BM_Fifo32Transfer(benchmark::State& state) {
+    const uint32_t count = state.range(0);
+    std::vector<int32_t> buffer(kFrameCount);
+    audio_utils_fifo_control control;
+    audio_utils_fifo fifo(kFrameCount, sizeof(int32_t), buffer.data(), control);
+    audio_utils_fifo_writer32 writer(fifo);
+    audio_utils_fifo_reader32 reader(fifo);
+    writer.setNonTemporal(state.range(1));
+
+    std::atomic<bool> done(false);
+    std::thread readerThread([&]() {
+        std::vector<int32_t> frames(count);
+        while (!done.load(std::memory_order_relaxed)) {
+            if (reader.loadAcquire() > 0) {
+                benchmark::DoNotOptimize(reader.read(frames.data(), count));
+                reader.storeRelease();
+            }
+        }
+    });
+
+    std::vector<int32_t> frames(count);
+    uint32_t rear = 0;
+    for (auto _ : state) {
+        for (uint32_t written = 0; written < count; ) {
+            const uint32_t avail = kFrameCount - (rear - control.mFront.loadAcquire());
+            const uint32_t actual = std::min(avail, count - written);
+            if (actual > 0) {
+                writer.write(frames.data() + written, actual);
+                writer.storeRelease();
+                rear += actual;
+                written += actual;
+            }
+        }
+    }
+    done = true;
+    readerThread.join();
+
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(state.range(1) == 0 ? "temporal" : "non-temporal");
+}
+
+BENCHMARK(BM_Fifo32Transfer)->ArgsProduct({{1, 32, 256}, {0}})->UseRealTime();
+BENCHMARK(BM_Fifo32Transfer)->Args({256, 256})->UseRealTime();
+
+BENCHMARK_MAIN();
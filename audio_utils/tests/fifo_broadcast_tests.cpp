@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_broadcast_tests"
+
+#include <errno.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <audio_utils/fifo_broadcast.h>
+#include <gtest/gtest.h>
+
+TEST(audio_utils_fifo_broadcast, lag_of_each_reader) {
+    int16_t buffer[16];
+    audio_utils_fifo_broadcast fifo(std::size(buffer), sizeof(buffer[0]), buffer, 4 /*slotCount*/);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_broadcast_reader fast(fifo);
+    audio_utils_fifo_broadcast_reader slow(fifo);
+    ASSERT_EQ(0, fast.slot());
+    ASSERT_EQ(1, slow.slot());
+
+    audio_utils_fifo_lag lag = fifo.lag();
+    EXPECT_EQ(2u, lag.mReaders);
+    EXPECT_EQ(0u, lag.mMinLag);
+    EXPECT_EQ(0u, lag.mMaxLag);
+
+    int16_t frames[16] = {};
+    ASSERT_EQ(10, writer.write(frames, 10));
+    ASSERT_EQ(8, fast.read(frames, 8));
+    ASSERT_EQ(3, slow.read(frames, 3));
+    EXPECT_EQ(2, fifo.readerLag(fast.slot()));
+    EXPECT_EQ(7, fifo.readerLag(slow.slot()));
+
+    lag = fifo.lag();
+    EXPECT_EQ(2u, lag.mReaders);
+    EXPECT_EQ(2u, lag.mMinLag);
+    EXPECT_EQ(7u, lag.mMaxLag);
+    EXPECT_EQ(slow.slot(), lag.mSlowest);
+    EXPECT_EQ(slow.slot(), fifo.slowestReader());
+    EXPECT_EQ(0u, lag.mTotalLost);
+
+    // The fast reader falls behind.
+    ASSERT_EQ(6, writer.write(frames, 6));
+    ASSERT_EQ(13, slow.read(frames, 16));
+    EXPECT_EQ(fast.slot(), fifo.slowestReader());
+}
+
+TEST(audio_utils_fifo_broadcast, lag_after_overrun) {
+    int16_t buffer[8];
+    audio_utils_fifo_broadcast fifo(std::size(buffer), sizeof(buffer[0]), buffer, 1 /*slotCount*/);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_broadcast_reader reader(fifo);
+
+    // The writer is not throttled, so it overruns the reader.
+    int16_t frames[8] = {};
+    ASSERT_EQ(8, writer.write(frames, 8));
+    ASSERT_EQ(8, writer.write(frames, 8));
+    ASSERT_EQ(3, writer.write(frames, 3));
+    EXPECT_EQ(19, fifo.readerLag(reader.slot()));
+
+    // The reader catches up, and publishes the frames it lost.
+    size_t lost;
+    EXPECT_EQ(-EOVERFLOW, reader.read(frames, 8, NULL /*timeout*/, &lost));
+    EXPECT_EQ(11u, lost);
+    uint64_t totalLost;
+    EXPECT_EQ(8, fifo.readerLag(reader.slot(), &totalLost));
+    EXPECT_EQ(11u, totalLost);
+    EXPECT_EQ(11u, fifo.lag().mTotalLost);
+    ASSERT_EQ(8, reader.read(frames, 8));
+    EXPECT_EQ(0, fifo.readerLag(reader.slot()));
+}
+
+TEST(audio_utils_fifo_broadcast, register_and_unregister) {
+    int16_t buffer[8];
+    audio_utils_fifo_broadcast fifo(std::size(buffer), sizeof(buffer[0]), buffer, 2 /*slotCount*/);
+    audio_utils_fifo_writer writer(fifo);
+    EXPECT_EQ(-1, fifo.slowestReader());
+    EXPECT_EQ(0u, fifo.lag().mReaders);
+    EXPECT_EQ(-ENOENT, fifo.readerLag(0));
+    EXPECT_EQ(-EINVAL, fifo.readerLag(2));
+
+    audio_utils_fifo_broadcast_reader first(fifo);
+    {
+        audio_utils_fifo_broadcast_reader second(fifo);
+        audio_utils_fifo_broadcast_reader third(fifo);
+        EXPECT_EQ(1, second.slot());
+        // All slots are in use, but the reader still works.
+        EXPECT_EQ(-1, third.slot());
+        int16_t frames[4] = {};
+        ASSERT_EQ(4, writer.write(frames, 4));
+        EXPECT_EQ(4, third.read(frames, 4));
+        EXPECT_EQ(2u, fifo.lag().mReaders);
+    }
+    EXPECT_EQ(-ENOENT, fifo.readerLag(1));
+    EXPECT_EQ(1u, fifo.lag().mReaders);
+
+    // A new reader reuses the freed slot, and starts with no lag.
+    audio_utils_fifo_broadcast_reader fourth(fifo);
+    EXPECT_EQ(1, fourth.slot());
+    EXPECT_EQ(0, fifo.readerLag(fourth.slot()));
+    EXPECT_EQ(4, fifo.readerLag(first.slot()));
+}
+
+// The writer observes the lag of readers in other processes.
+TEST(audio_utils_fifo_broadcast, multi_process) {
+    static const uint32_t kFrameCount = 64;
+    static const uint32_t kSlotCount = 2;
+    struct Shared {
+        audio_utils_fifo_index      mRear;
+        audio_utils_fifo_reader_slot mSlots[kSlotCount];
+        int32_t                     mBuffer[kFrameCount];
+        std::atomic_int             mReady;
+    };
+    void *p = mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+            -1 /*fd*/, 0 /*offset*/);
+    ASSERT_NE(MAP_FAILED, p);
+    Shared *shared = new (p) Shared();
+
+    pid_t pids[kSlotCount];
+    for (uint32_t i = 0; i < kSlotCount; ++i) {
+        pids[i] = fork();
+        ASSERT_NE(-1, pids[i]);
+        if (pids[i] == 0) {
+            audio_utils_fifo_broadcast fifo(kFrameCount, sizeof(int32_t), shared->mBuffer,
+                    shared->mRear, shared->mSlots, kSlotCount);
+            audio_utils_fifo_broadcast_reader reader(fifo);
+            // Reader i reads 10 * (i + 1) frames, then waits to be killed.
+            const uint32_t count = 10 * (i + 1);
+            int32_t frames[kFrameCount];
+            uint32_t total = 0;
+            shared->mReady++;
+            while (total < count) {
+                ssize_t actual = reader.read(&frames[total], count - total);
+                if (actual > 0) {
+                    total += actual;
+                } else {
+                    usleep(1000);
+                }
+            }
+            shared->mReady++;
+            for (;;) {
+                pause();
+            }
+        }
+    }
+
+    audio_utils_fifo_broadcast fifo(kFrameCount, sizeof(int32_t), shared->mBuffer,
+            shared->mRear, shared->mSlots, kSlotCount);
+    audio_utils_fifo_writer writer(fifo);
+    while (shared->mReady < (int) kSlotCount) {
+        usleep(1000);
+    }
+    int32_t frames[32] = {};
+    ASSERT_EQ(32, writer.write(frames, 32));
+    while (shared->mReady < (int) kSlotCount * 2) {
+        usleep(1000);
+    }
+
+    const audio_utils_fifo_lag lag = fifo.lag();
+    EXPECT_EQ(kSlotCount, lag.mReaders);
+    EXPECT_EQ(12u, lag.mMinLag);
+    EXPECT_EQ(22u, lag.mMaxLag);
+    const int32_t slowest = lag.mSlowest;
+    ASSERT_GE(slowest, 0);
+    EXPECT_EQ(22, fifo.readerLag(slowest));
+
+    for (uint32_t i = 0; i < kSlotCount; ++i) {
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL /*wstatus*/, 0 /*options*/);
+    }
+    // Killed readers keep their slots.
+    EXPECT_EQ(kSlotCount, fifo.lag().mReaders);
+    munmap(p, sizeof(Shared));
+}
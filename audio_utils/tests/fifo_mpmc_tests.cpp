@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_mpmc_tests"
+
+#include <atomic>
+#include <limits.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <audio_utils/fifo_mpmc.h>
+#include <gtest/gtest.h>
+
+// Each frame identifies its writer, counting from 1 so that silence is writer 0,
+// and its sequence number for that writer.
+struct Frame {
+    uint32_t writer;
+    uint32_t sequence;
+};
+
+static const struct timespec kForever = {LONG_MAX /*tv_sec*/, 0 /*tv_nsec*/};
+static const struct timespec kPoll = {0 /*tv_sec*/, 10000000 /*tv_nsec*/};
+
+TEST(audio_utils_fifo_mpmc, reserve_and_commit_in_order) {
+    Frame buffer[8];
+    audio_utils_fifo_mpmc fifo(std::size(buffer), sizeof(Frame), buffer);
+    audio_utils_fifo_multi_writer first(fifo);
+    audio_utils_fifo_multi_writer second(fifo);
+    audio_utils_fifo_multi_reader reader(fifo);
+
+    // Each writer reserves its own frames.
+    audio_utils_iovec iovec[2];
+    ASSERT_EQ(3, first.obtain(iovec, 3));
+    EXPECT_EQ(0u, iovec[0].mOffset);
+    ASSERT_EQ(5, second.obtain(iovec, SIZE_MAX));
+    EXPECT_EQ(3u, iovec[0].mOffset);
+    EXPECT_EQ(5u, iovec[0].mLength);
+    EXPECT_EQ(0, first.available());
+    for (uint32_t i = 0; i < 5; ++i) {
+        buffer[3 + i] = {2, i};
+    }
+
+    // The second writer's commit waits for the first.
+    std::thread commit([&]() { second.release(5); });
+    Frame frames[8];
+    EXPECT_EQ(0, reader.available());
+    for (uint32_t i = 0; i < 2; ++i) {
+        buffer[i] = {1, i};
+    }
+    first.release(2); // the third frame is committed as silence
+    commit.join();
+
+    ASSERT_EQ(8, reader.read(frames, std::size(frames)));
+    for (uint32_t i = 0; i < 8; ++i) {
+        const Frame expected = i < 2 ? Frame{1, i} : i < 3 ? Frame{0, 0} : Frame{2, i - 3};
+        EXPECT_EQ(expected.writer, frames[i].writer) << "i=" << i;
+        EXPECT_EQ(expected.sequence, frames[i].sequence) << "i=" << i;
+    }
+    EXPECT_EQ(2u, first.totalReleased());
+    EXPECT_EQ(8u, reader.totalReleased());
+    EXPECT_EQ(8, first.available());
+}
+
+// Writers write frames in random counts, while readers read them in random counts,
+// and every frame written must be read exactly once.
+static void stress(uint32_t frameCount, size_t writerCount, size_t readerCount) {
+    constexpr uint32_t kFramesPerWriter = 50000;
+    std::vector<Frame> buffer(frameCount);
+    audio_utils_fifo_mpmc fifo(frameCount, sizeof(Frame), buffer.data());
+
+    std::vector<std::thread> writers;
+    for (size_t w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&fifo, w]() {
+            audio_utils_fifo_multi_writer writer(fifo);
+            std::minstd_rand gen(w);
+            std::vector<Frame> frames(16);
+            for (uint32_t sequence = 0; sequence < kFramesPerWriter; ) {
+                const size_t count = std::min<size_t>(1 + gen() % frames.size(),
+                        kFramesPerWriter - sequence);
+                for (size_t i = 0; i < count; ++i) {
+                    frames[i] = {(uint32_t) w + 1, sequence + (uint32_t) i};
+                }
+                const ssize_t written = writer.write(frames.data(), count, &kForever);
+                if (written == -EWOULDBLOCK || written == -EINTR) {
+                    continue;
+                }
+                ASSERT_GT(written, 0);
+                sequence += written;
+            }
+        });
+    }
+
+    std::atomic<size_t> remaining(writerCount * kFramesPerWriter);
+    std::vector<std::vector<uint32_t>> received(readerCount * writerCount);
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r]() {
+            audio_utils_fifo_multi_reader reader(fifo);
+            std::minstd_rand gen(r + 100);
+            std::vector<Frame> frames(16);
+            while (remaining > 0) {
+                const ssize_t read = reader.read(frames.data(), 1 + gen() % frames.size(),
+                        &kPoll);
+                // Another reader may have taken the frames which woke us.
+                if (read == 0 || read == -ETIMEDOUT || read == -EWOULDBLOCK || read == -EINTR) {
+                    continue;
+                }
+                ASSERT_GT(read, 0);
+                for (ssize_t i = 0; i < read; ++i) {
+                    ASSERT_GE(frames[i].writer, 1u);
+                    ASSERT_LE(frames[i].writer, writerCount);
+                    received[r * writerCount + frames[i].writer - 1].push_back(
+                            frames[i].sequence);
+                }
+                remaining -= read;
+            }
+        });
+    }
+
+    for (auto &thread : writers) {
+        thread.join();
+    }
+    for (auto &thread : readers) {
+        thread.join();
+    }
+    ASSERT_EQ(0u, remaining);
+
+    for (size_t w = 0; w < writerCount; ++w) {
+        std::vector<bool> seen(kFramesPerWriter);
+        for (size_t r = 0; r < readerCount; ++r) {
+            const std::vector<uint32_t> &sequences = received[r * writerCount + w];
+            for (size_t i = 0; i < sequences.size(); ++i) {
+                // Each reader sees the frames of a writer in order.
+                if (i > 0) {
+                    ASSERT_LT(sequences[i - 1], sequences[i]) << "writer=" << w;
+                }
+                ASSERT_LT(sequences[i], kFramesPerWriter);
+                ASSERT_FALSE(seen[sequences[i]]) << "writer=" << w << " sequence=" << i;
+                seen[sequences[i]] = true;
+            }
+        }
+    }
+}
+
+TEST(audio_utils_fifo_mpmc, stress_mpsc) {
+    stress(64 /*frameCount*/, 4 /*writerCount*/, 1 /*readerCount*/);
+}
+
+TEST(audio_utils_fifo_mpmc, stress_mpmc) {
+    stress(64 /*frameCount*/, 3 /*writerCount*/, 3 /*readerCount*/);
+}
+
+TEST(audio_utils_fifo_mpmc, stress_mpmc_not_power_of_2) {
+    // Exercises the wasted indices of a capacity which is not a power of 2.
+    stress(60 /*frameCount*/, 3 /*writerCount*/, 2 /*readerCount*/);
+}
@@ -35,6 +35,10 @@ int main(int argc __unused, char **argv __unused)
 {
     // TODO Add error checking for ashmem_create_region and mmap
 
+    // Each index is in its own region, so that each child can map the index written by the
+    // other child as read-only.  This also keeps them in separate cache lines; when the indices
+    // share a region, use the layout of audio_utils_fifo_control instead.
+
     const int frontFd = ashmem_create_region("front", sizeof(audio_utils_fifo_index));
     printf("frontFd=%d\n", frontFd);
 
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_view_tests"
+
+#include <unistd.h>
+#include <vector>
+
+#include <audio_utils/fifo_mirrored_buffer.h>
+#include <audio_utils/fifo_view.h>
+#include <gtest/gtest.h>
+
+static uint32_t pageSize()
+{
+    return (uint32_t) sysconf(_SC_PAGESIZE);
+}
+
+TEST(audio_utils_fifo_mirrored_buffer, align_frame_count) {
+    const uint32_t page = pageSize();
+    EXPECT_EQ(page / 4, audio_utils_fifo_mirrored_buffer::alignFrameCount(1, 4));
+    EXPECT_EQ(page / 2, audio_utils_fifo_mirrored_buffer::alignFrameCount(page / 2, 2));
+    EXPECT_EQ(page / 2, audio_utils_fifo_mirrored_buffer::alignFrameCount(page / 2 - 1, 2));
+    EXPECT_EQ(page, audio_utils_fifo_mirrored_buffer::alignFrameCount(page / 2 + 1, 2));
+    // A frame of 3 bytes needs a whole page of frames.
+    EXPECT_EQ(page, audio_utils_fifo_mirrored_buffer::alignFrameCount(100, 3));
+    EXPECT_EQ(0u, audio_utils_fifo_mirrored_buffer::alignFrameCount(UINT32_MAX, 3));
+}
+
+TEST(audio_utils_fifo_mirrored_buffer, mirrors) {
+    const uint32_t frameCount = pageSize() / sizeof(int32_t);
+    audio_utils_fifo_mirrored_buffer buffer(frameCount, sizeof(int32_t));
+    ASSERT_EQ(0, buffer.initCheck());
+    int32_t *data = (int32_t *) buffer.buffer();
+    ASSERT_NE(nullptr, data);
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        data[i] = i;
+    }
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        ASSERT_EQ((int32_t) i, data[frameCount + i]);
+    }
+    data[frameCount + 7] = -1;
+    EXPECT_EQ(-1, data[7]);
+
+    // Another mapping of the same region sees the same frames.
+    audio_utils_fifo_mirrored_buffer other(dup(buffer.fd()), frameCount, sizeof(int32_t));
+    ASSERT_EQ(0, other.initCheck());
+    EXPECT_EQ(-1, ((int32_t *) other.buffer())[frameCount + 7]);
+}
+
+TEST(audio_utils_fifo_mirrored_buffer, invalid_size) {
+    audio_utils_fifo_mirrored_buffer buffer(pageSize() / 2 + 1, 2);
+    EXPECT_EQ(-EINVAL, buffer.initCheck());
+    EXPECT_EQ(nullptr, buffer.buffer());
+}
+
+TEST(audio_utils_fifo_view, mirrored_slice_is_contiguous) {
+    // Stereo frames, so that each frame is two samples of the view.
+    const uint32_t frameCount = audio_utils_fifo_mirrored_buffer::alignFrameCount(
+            1000, 2 * sizeof(int16_t));
+    audio_utils_fifo_mirrored_buffer buffer(frameCount, 2 * sizeof(int16_t));
+    ASSERT_EQ(0, buffer.initCheck());
+    audio_utils_fifo fifo(buffer);
+    EXPECT_TRUE(fifo.isMirrored());
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    audio_utils_fifo_view<int16_t> writerView(writer);
+    audio_utils_fifo_view<const int16_t> readerView(reader);
+    EXPECT_EQ(2u, writerView.samplesPerFrame());
+
+    // Move the indices close to the end of the buffer.
+    const uint32_t start = frameCount - 10;
+    std::vector<int16_t> frames(2 * start);
+    ASSERT_EQ((ssize_t) start, writer.write(frames.data(), start));
+    ASSERT_EQ((ssize_t) start, reader.read(frames.data(), start));
+
+    // A slice which wraps around is a single fragment.
+    audio_utils_fifo_span<int16_t> spans[2];
+    ASSERT_EQ(100, writerView.obtain(spans, 100));
+    EXPECT_EQ(100u, spans[0].mFrames);
+    EXPECT_EQ(0u, spans[1].mFrames);
+    for (int i = 0; i < 2 * 100; ++i) {
+        spans[0].mData[i] = i;
+    }
+    writerView.release(100);
+
+    const int16_t *data;
+    ASSERT_EQ(100, readerView.obtainContiguous(&data));
+    for (int i = 0; i < 2 * 100; ++i) {
+        ASSERT_EQ(i, data[i]);
+    }
+    readerView.release(100);
+    EXPECT_EQ(0, readerView.available());
+
+    // Ordinary reads and writes see the same frames across the wrap.
+    std::vector<int16_t> in(2 * 50), out(2 * 50);
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = -(int16_t) i;
+    }
+    const uint32_t toEnd = frameCount - (start + 100) % frameCount;
+    ASSERT_EQ((ssize_t) toEnd - 20, writer.write(frames.data(), toEnd - 20));
+    ASSERT_EQ((ssize_t) toEnd - 20, reader.read(frames.data(), toEnd - 20));
+    ASSERT_EQ(50, writer.write(in.data(), 50));
+    ASSERT_EQ(50, reader.read(out.data(), 50));
+    EXPECT_EQ(in, out);
+}
+
+TEST(audio_utils_fifo_view, ordinary_slice_is_split) {
+    int16_t buffer[2 * 16];
+    audio_utils_fifo fifo(16, 2 * sizeof(int16_t), buffer);
+    EXPECT_FALSE(fifo.isMirrored());
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    audio_utils_fifo_view<int16_t> writerView(writer);
+    audio_utils_fifo_view<const int16_t> readerView(reader);
+
+    int16_t frames[2 * 12] = {};
+    ASSERT_EQ(12, writer.write(frames, 12));
+    ASSERT_EQ(12, reader.read(frames, 12));
+
+    audio_utils_fifo_span<int16_t> spans[2];
+    ASSERT_EQ(8, writerView.obtain(spans, 8));
+    EXPECT_EQ(buffer + 2 * 12, spans[0].mData);
+    EXPECT_EQ(4u, spans[0].mFrames);
+    EXPECT_EQ(buffer, spans[1].mData);
+    EXPECT_EQ(4u, spans[1].mFrames);
+    writerView.release(8);
+
+    // Only the frames up to the end of the buffer are contiguous.
+    const int16_t *data;
+    ASSERT_EQ(4, readerView.obtainContiguous(&data, 8));
+    EXPECT_EQ(buffer + 2 * 12, data);
+    readerView.release(4);
+    EXPECT_EQ(4, readerView.available());
+}
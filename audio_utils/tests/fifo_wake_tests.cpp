@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_fifo_wake_tests"
+
+#include <chrono>
+#include <limits.h>
+#include <thread>
+
+#include <audio_utils/fifo.h>
+#include <gtest/gtest.h>
+
+static const struct timespec kForever = {LONG_MAX /*tv_sec*/, 0 /*tv_nsec*/};
+
+TEST(audio_utils_fifo_wake, every_release_wakes_by_default) {
+    int32_t buffer[16];
+    audio_utils_fifo fifo(std::size(buffer), sizeof(int32_t), buffer);
+    audio_utils_fifo_writer writer(fifo);
+    const int32_t frame = 0;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(1, writer.write(&frame, 1));
+    }
+    EXPECT_EQ(5u, writer.totalWakes());
+    EXPECT_EQ(0u, writer.totalWakesAvoided());
+}
+
+TEST(audio_utils_fifo_wake, wake_batch_coalesces) {
+    int32_t buffer[16];
+    audio_utils_fifo fifo(std::size(buffer), sizeof(int32_t), buffer);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    writer.setWakeBatch(8);
+    EXPECT_EQ(8u, writer.getWakeBatch());
+
+    // Five releases trigger a wake, and the one which reaches 8 frames does the merged wake.
+    int32_t frames[8] = {};
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(1, writer.write(frames, 1));
+    }
+    EXPECT_EQ(0u, writer.totalWakes());
+    EXPECT_EQ(3u, writer.totalWakesAvoided());
+    // The frames are observable before the wake.
+    EXPECT_EQ(4, reader.available());
+    ASSERT_EQ(4, writer.write(frames, 4));
+    EXPECT_EQ(1u, writer.totalWakes());
+    EXPECT_EQ(4u, writer.totalWakesAvoided());
+
+    // Nothing is pending, so this does not wake.
+    writer.wakeNowIfNeeded();
+    EXPECT_EQ(1u, writer.totalWakes());
+
+    // A pending wake is done on request.
+    ASSERT_EQ(1, writer.write(frames, 1));
+    EXPECT_EQ(1u, writer.totalWakes());
+    writer.wakeNowIfNeeded();
+    EXPECT_EQ(2u, writer.totalWakes());
+    EXPECT_EQ(4u, writer.totalWakesAvoided());
+}
+
+TEST(audio_utils_fifo_wake, blocking_writer_wakes_reader) {
+    // The writer defers all wakes, so the blocked reader is woken only because the writer
+    // wakes it before blocking itself on the full FIFO.
+    constexpr int kFrames = 1000;
+    int32_t buffer[4];
+    audio_utils_fifo fifo(std::size(buffer), sizeof(int32_t), buffer);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    writer.setWakeBatch(UINT32_MAX);
+
+    std::thread readerThread([&reader]() {
+        int32_t frames[4];
+        for (int32_t expected = 0; expected < kFrames; ) {
+            const ssize_t actual = reader.read(frames, std::size(frames), &kForever);
+            if (actual == -EWOULDBLOCK || actual == -EINTR) {
+                continue;
+            }
+            ASSERT_GT(actual, 0);
+            for (ssize_t i = 0; i < actual; ++i) {
+                ASSERT_EQ(expected++, frames[i]);
+            }
+        }
+    });
+    for (int32_t frame = 0; frame < kFrames; ) {
+        const ssize_t actual = writer.write(&frame, 1, &kForever);
+        if (actual == 1) {
+            ++frame;
+        }
+    }
+    writer.wakeNowIfNeeded();
+    readerThread.join();
+}
+
+TEST(audio_utils_fifo_wake, spin_avoids_wait) {
+    int32_t buffer[16];
+    audio_utils_fifo fifo(std::size(buffer), sizeof(int32_t), buffer);
+    audio_utils_fifo_writer writer(fifo);
+    audio_utils_fifo_reader reader(fifo);
+    reader.setSpin(1000000000 /*spinNs*/);
+    EXPECT_EQ(1000000000u, reader.getSpin());
+
+    std::thread readerThread([&reader]() {
+        int32_t frame;
+        EXPECT_EQ(1, reader.read(&frame, 1, &kForever));
+        EXPECT_EQ(42, frame);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const int32_t frame = 42;
+    ASSERT_EQ(1, writer.write(&frame, 1));
+    readerThread.join();
+    EXPECT_EQ(0u, reader.totalWaits());
+    EXPECT_EQ(1u, reader.totalWaitsAvoided());
+}
+
+TEST(audio_utils_fifo_wake, spin_counts_towards_timeout) {
+    int32_t buffer[16];
+    audio_utils_fifo fifo(std::size(buffer), sizeof(int32_t), buffer);
+    audio_utils_fifo_reader reader(fifo);
+    int32_t frame;
+
+    // The spin is shorter than the timeout, so the reader then blocks for the rest of it.
+    reader.setSpin(1000000 /*spinNs*/);
+    const struct timespec timeout = {0 /*tv_sec*/, 20000000 /*tv_nsec*/};
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(-ETIMEDOUT, reader.read(&frame, 1, &timeout));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    EXPECT_EQ(1u, reader.totalWaits());
+
+    // The spin is longer than the timeout, so the reader does not block at all.
+    reader.setSpin(2000000000 /*spinNs*/);
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(-ETIMEDOUT, reader.read(&frame, 1, &timeout));
+    elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    EXPECT_EQ(1u, reader.totalWaits());
+    EXPECT_EQ(0u, reader.totalWaitsAvoided());
+}
@@ -108,6 +108,51 @@ TEST_P(FormatTest, memcpy_by_audio_format)
             memcmp(data, orig_data, SAMPLES * audio_bytes_per_sample(orig_encoding)));
 }
 
+TEST_P(FormatTest, memcpy_by_audio_format_get_function)
+{
+    const auto param = GetParam();
+    const audio_format_t src_encoding = std::get<0>(param);
+    const audio_format_t dst_encoding = std::get<1>(param);
+
+    const memcpy_by_audio_format_function_t function =
+            memcpy_by_audio_format_get_function(dst_encoding, src_encoding);
+    if (!is_common_format(src_encoding) && !is_common_format(dst_encoding)
+            && src_encoding != dst_encoding) {
+        // Some other conversions are supported, but not required.
+        if (function == nullptr) return;
+    }
+    ASSERT_NE(nullptr, function);
+
+    constexpr size_t SAMPLES = UINT8_MAX;
+    int16_t orig_data[SAMPLES];
+    fillRamp(orig_data);
+    uint32_t data[SAMPLES];
+    memcpy_by_audio_format(
+            data, src_encoding,
+            orig_data, AUDIO_FORMAT_PCM_16_BIT, SAMPLES);
+
+    // The cached function converts as memcpy_by_audio_format() does.
+    uint32_t expected[SAMPLES];
+    uint32_t check[SAMPLES];
+    memcpy_by_audio_format(
+            expected, dst_encoding,
+            data, src_encoding, SAMPLES);
+    function(check, data, SAMPLES);
+    EXPECT_EQ(0, memcmp(check, expected, SAMPLES * audio_bytes_per_sample(dst_encoding)));
+}
+
+TEST(audio_utils_format, memcpy_by_audio_format_get_function_invalid)
+{
+    EXPECT_EQ(nullptr, memcpy_by_audio_format_get_function(
+            AUDIO_FORMAT_PCM_16_BIT, AUDIO_FORMAT_INVALID));
+    EXPECT_EQ(nullptr, memcpy_by_audio_format_get_function(
+            AUDIO_FORMAT_AAC, AUDIO_FORMAT_PCM_16_BIT));
+    EXPECT_EQ(nullptr, memcpy_by_audio_format_get_function(
+            AUDIO_FORMAT_DEFAULT, AUDIO_FORMAT_DEFAULT));
+    EXPECT_EQ(nullptr, memcpy_by_audio_format_get_function(
+            AUDIO_FORMAT_PCM_8_BIT, AUDIO_FORMAT_PCM_32_BIT));
+}
+
 INSTANTIATE_TEST_CASE_P(FormatVariations, FormatTest, ::testing::Combine(
     ::testing::Values(
         AUDIO_FORMAT_PCM_8_BIT,
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <audio_utils/format.h>
+#include <audio_utils/Mixer.h>
+
+using namespace android::audio_utils;
+
+static constexpr size_t kSampleRate = 48000;
+static constexpr size_t kFrames = kSampleRate / 100; // a 10 ms mixer period.
+
+// Mixes state.range(0) stereo tracks into a stereo output, each track using the
+// next format of formats[]. The "tracks_per_ms" counter is the number of milliseconds of
+// track audio mixed per millisecond of CPU, that is, how many tracks could be mixed
+// in real time by one core (the counter is a rate, so it is printed with a "/s" suffix).
+static void BM_Mixer(benchmark::State& state, audio_format_t outputFormat,
+        std::vector<audio_format_t> formats) {
+    const size_t trackCount = state.range(0);
+    Mixer mixer(outputFormat, AUDIO_CHANNEL_OUT_STEREO, trackCount);
+
+    // Initialize track buffers with deterministic pseudo-random values
+    std::minstd_rand gen(trackCount);
+    std::uniform_real_distribution<> dis(-1., 1.);
+    std::vector<float> samples(kFrames * 2);
+    std::vector<std::vector<uint8_t>> buffers(trackCount);
+    for (size_t i = 0; i < trackCount; ++i) {
+        const audio_format_t format = formats[i % formats.size()];
+        for (auto &sample : samples) {
+            sample = dis(gen);
+        }
+        buffers[i].resize(samples.size() * audio_bytes_per_sample(format));
+        memcpy_by_audio_format(buffers[i].data(), format,
+                samples.data(), AUDIO_FORMAT_PCM_FLOAT, samples.size());
+        const int track = mixer.addTrack(format, AUDIO_CHANNEL_OUT_STEREO);
+        mixer.setBuffer(track, buffers[i].data());
+        mixer.setVolume(track, 1.f / trackCount);
+    }
+    std::vector<uint8_t> out(kFrames * 2 * audio_bytes_per_sample(outputFormat));
+
+    // Run the test
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(out.data());
+        mixer.process(out.data(), kFrames);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * trackCount * kFrames);
+    const double trackMs = trackCount * 1000. * kFrames / kSampleRate;
+    state.counters["tracks_per_ms"] = benchmark::Counter(
+            trackMs * state.iterations() / 1000., benchmark::Counter::kIsRate);
+}
+
+static void BM_MixerI16(benchmark::State& state) {
+    BM_Mixer(state, AUDIO_FORMAT_PCM_16_BIT, {AUDIO_FORMAT_PCM_16_BIT});
+}
+
+BENCHMARK(BM_MixerI16)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_MixerFloat(benchmark::State& state) {
+    BM_Mixer(state, AUDIO_FORMAT_PCM_FLOAT, {AUDIO_FORMAT_PCM_FLOAT});
+}
+
+BENCHMARK(BM_MixerFloat)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_MixerMixedFormats(benchmark::State& state) {
+    BM_Mixer(state, AUDIO_FORMAT_PCM_16_BIT, {AUDIO_FORMAT_PCM_16_BIT, AUDIO_FORMAT_PCM_FLOAT,
+            AUDIO_FORMAT_PCM_24_BIT_PACKED, AUDIO_FORMAT_PCM_32_BIT});
+}
+
+BENCHMARK(BM_MixerMixedFormats)->Arg(4)->Arg(16)->Arg(64);
+
+BENCHMARK_MAIN();
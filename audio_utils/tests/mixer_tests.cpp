@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_mixer_tests"
+
+#include <errno.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include <audio_utils/Mixer.h>
+#include <audio_utils/primitives.h>
+
+using namespace android::audio_utils;
+
+TEST(audio_utils_mixer, tracks) {
+    Mixer mixer(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_OUT_STEREO, 2 /* maxTracks */);
+
+    EXPECT_EQ(-EINVAL, mixer.addTrack(AUDIO_FORMAT_AAC, AUDIO_CHANNEL_OUT_STEREO));
+    EXPECT_EQ(-EINVAL, mixer.addTrack(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_NONE));
+    EXPECT_EQ(0, mixer.addTrack(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_OUT_STEREO));
+    EXPECT_EQ(1, mixer.addTrack(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_MONO));
+    EXPECT_EQ(-ENOSPC, mixer.addTrack(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_MONO));
+    EXPECT_EQ(0, mixer.removeTrack(0));
+    EXPECT_EQ(-EINVAL, mixer.removeTrack(0));
+    EXPECT_EQ(-EINVAL, mixer.setBuffer(0, nullptr));
+    EXPECT_EQ(-EINVAL, mixer.setVolume(2, 1.f));
+    EXPECT_EQ(0, mixer.addTrack(AUDIO_FORMAT_PCM_24_BIT_PACKED, AUDIO_CHANNEL_OUT_STEREO));
+    EXPECT_FALSE(mixer.toString().empty());
+
+    // With no buffers set, the output is silence.
+    std::vector<int16_t> out(64, 1);
+    mixer.process(out.data(), out.size() / 2);
+    EXPECT_EQ(std::vector<int16_t>(out.size()), out);
+}
+
+TEST(audio_utils_mixer, sum_and_clamp) {
+    Mixer mixer(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_OUT_STEREO, 4 /* maxTracks */);
+    // Cross several tiles, and end within one.
+    const size_t frames = mixer.getTileFrames() * 3 + 5;
+
+    std::vector<int16_t> i16(frames * 2);
+    for (size_t i = 0; i < i16.size(); ++i) {
+        i16[i] = (int16_t)(i * 37);
+    }
+    std::vector<float> f(frames * 2);
+    memcpy_to_float_from_i16(f.data(), i16.data(), f.size());
+    std::vector<uint8_t> p24(frames * 2 * 3);
+    memcpy_to_p24_from_i16(p24.data(), i16.data(), i16.size());
+
+    const int t0 = mixer.addTrack(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_OUT_STEREO);
+    ASSERT_LE(0, t0);
+    ASSERT_EQ(0, mixer.setBuffer(t0, i16.data()));
+    std::vector<int16_t> out(frames * 2);
+    mixer.process(out.data(), frames);
+    EXPECT_EQ(i16, out);
+
+    // Three tracks of the same signal in different formats, at volumes adding up to 1.
+    const int t1 = mixer.addTrack(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_STEREO);
+    const int t2 = mixer.addTrack(AUDIO_FORMAT_PCM_24_BIT_PACKED, AUDIO_CHANNEL_OUT_STEREO);
+    ASSERT_EQ(0, mixer.setBuffer(t1, f.data()));
+    ASSERT_EQ(0, mixer.setBuffer(t2, p24.data()));
+    ASSERT_EQ(0, mixer.setVolume(t0, 0.25f));
+    ASSERT_EQ(0, mixer.setVolume(t1, 0.25f));
+    ASSERT_EQ(0, mixer.setVolume(t2, 0.5f));
+    mixer.process(out.data(), frames);
+    EXPECT_EQ(i16, out);
+
+    // At unity volume, the sum is three times the signal, clamped.
+    ASSERT_EQ(0, mixer.setVolume(t0, 1.f));
+    ASSERT_EQ(0, mixer.setVolume(t1, 1.f));
+    ASSERT_EQ(0, mixer.setVolume(t2, 1.f));
+    mixer.process(out.data(), frames);
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(clamp16(i16[i] * 3), out[i]) << "i=" << i;
+    }
+}
+
+TEST(audio_utils_mixer, channels) {
+    Mixer mixer(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_5POINT1, 2 /* maxTracks */);
+    constexpr size_t frames = 100;
+    constexpr size_t channels = 6;
+    std::vector<int16_t> mono(frames);
+    std::vector<uint8_t> quad(frames * 4);
+    for (size_t i = 0; i < frames; ++i) {
+        mono[i] = (int16_t)(i * 100);
+        for (size_t j = 0; j < 4; ++j) {
+            quad[i * 4 + j] = (uint8_t)(0x80 + j * 16);
+        }
+    }
+    std::vector<float> out(frames * channels);
+
+    // Mono plays on front left and front right.
+    const int t0 = mixer.addTrack(AUDIO_FORMAT_PCM_16_BIT, AUDIO_CHANNEL_OUT_MONO);
+    ASSERT_EQ(0, mixer.setBuffer(t0, mono.data()));
+    mixer.process(out.data(), frames);
+    for (size_t i = 0; i < frames; ++i) {
+        const float expected = float_from_i16(mono[i]);
+        EXPECT_EQ(expected, out[i * channels]);
+        EXPECT_EQ(expected, out[i * channels + 1]);
+        for (size_t j = 2; j < channels; ++j) {
+            EXPECT_EQ(0.f, out[i * channels + j]);
+        }
+    }
+    ASSERT_EQ(0, mixer.removeTrack(t0));
+
+    // Quad plays on front left, front right, back left and back right,
+    // which are channels 0, 1, 4 and 5 of 5.1.
+    const int t1 = mixer.addTrack(AUDIO_FORMAT_PCM_8_BIT, AUDIO_CHANNEL_OUT_QUAD);
+    ASSERT_EQ(0, mixer.setBuffer(t1, quad.data()));
+    mixer.process(out.data(), frames);
+    const size_t fromQuad[channels] = {0, 1, SIZE_MAX, SIZE_MAX, 2, 3};
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t j = 0; j < channels; ++j) {
+            const float expected = fromQuad[j] == SIZE_MAX
+                    ? 0.f : float_from_u8(quad[i * 4 + fromQuad[j]]);
+            EXPECT_EQ(expected, out[i * channels + j]) << "i=" << i << " j=" << j;
+        }
+    }
+}
+
+TEST(audio_utils_mixer, volume_ramp) {
+    Mixer mixer(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_STEREO, 1 /* maxTracks */);
+    const size_t rampFrames = mixer.getTileFrames() + 100; // the ramp spans a tile boundary.
+    const size_t frames = rampFrames * 2;
+    const std::vector<float> ones(frames * 2, 1.f);
+    std::vector<float> out(frames * 2);
+
+    const int track = mixer.addTrack(AUDIO_FORMAT_PCM_FLOAT, AUDIO_CHANNEL_OUT_STEREO);
+    ASSERT_EQ(0, mixer.setBuffer(track, ones.data()));
+    ASSERT_EQ(0, mixer.setVolume(track, 0.f));
+    ASSERT_EQ(0, mixer.setVolume(track, 1.f, rampFrames));
+
+    // Process in two calls, the ramp continuing from one to the next.
+    mixer.process(out.data(), rampFrames / 2);
+    ASSERT_EQ(0, mixer.setBuffer(track, ones.data() + rampFrames / 2 * 2));
+    mixer.process(out.data() + rampFrames / 2 * 2, frames - rampFrames / 2);
+    for (size_t i = 0; i < frames; ++i) {
+        const float expected = i < rampFrames ? (float)(i + 1) / rampFrames : 1.f;
+        EXPECT_NEAR(expected, out[i * 2], 1e-5) << "i=" << i;
+        EXPECT_EQ(out[i * 2], out[i * 2 + 1]) << "i=" << i;
+    }
+
+    // A new ramp starts from the volume reached in the middle of the previous one.
+    ASSERT_EQ(0, mixer.setBuffer(track, ones.data()));
+    ASSERT_EQ(0, mixer.setVolume(track, 0.f, 100));
+    mixer.process(out.data(), 50);
+    ASSERT_EQ(0, mixer.setVolume(track, 1.f, 50));
+    mixer.process(out.data() + 100, 60);
+    EXPECT_NEAR(0.5f, out[49 * 2], 1e-5);
+    EXPECT_NEAR(0.51f, out[50 * 2], 1e-5);
+    EXPECT_EQ(1.f, out[109 * 2]);
+}
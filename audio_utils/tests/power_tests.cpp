@@ -19,8 +19,12 @@
 
 #include <cmath>
 #include <math.h>
+#include <random>
+#include <vector>
 
+#include <audio_utils/format.h>
 #include <audio_utils/power.h>
+#include <audio_utils/primitives.h>
 #include <gtest/gtest.h>
 #include <log/log.h>
 
@@ -171,3 +175,91 @@ TEST(audio_utils_power, power_from) {
     EXPECT_EQ(-INFINITY, audio_utils_power_from_energy(0.f));
     EXPECT_TRUE(std::isnan(audio_utils_power_from_energy(-1.f)));
 }
+
+// Per channel energy of interleaved frames, in double precision.
+static std::vector<double> energyByChannelRef(const std::vector<uint8_t> &buffer,
+        audio_format_t format, size_t frames, uint32_t channelCount) {
+    std::vector<float> f(frames * channelCount);
+    memcpy_by_audio_format(f.data(), AUDIO_FORMAT_PCM_FLOAT, buffer.data(), format, f.size());
+    std::vector<double> energies(channelCount);
+    for (size_t i = 0; i < f.size(); ++i) {
+        energies[i % channelCount] += (double)f[i] * f[i];
+    }
+    return energies;
+}
+
+TEST(audio_utils_power, energy_by_channel) {
+    const audio_utils_primitives_backend_t original = audio_utils_primitives_get_backend();
+    constexpr uint32_t maxChannels = 10;
+    constexpr size_t frameCounts[] = {0, 1, 15, 16, 17, 100, 1111};
+    std::minstd_rand gen(42);
+    std::uniform_int_distribution<> dis(0, UINT8_MAX);
+    std::uniform_real_distribution<float> fdis(-1.f, 1.f);
+
+    for (const audio_format_t format : {
+            AUDIO_FORMAT_PCM_8_BIT, AUDIO_FORMAT_PCM_16_BIT, AUDIO_FORMAT_PCM_24_BIT_PACKED,
+            AUDIO_FORMAT_PCM_8_24_BIT, AUDIO_FORMAT_PCM_32_BIT, AUDIO_FORMAT_PCM_FLOAT}) {
+        const size_t sampleSize = audio_bytes_per_sample(format);
+        const size_t maxSamples = frameCounts[std::size(frameCounts) - 1] * maxChannels;
+        std::vector<uint8_t> buffer(maxSamples * sampleSize);
+        if (format == AUDIO_FORMAT_PCM_FLOAT) {
+            for (size_t i = 0; i < maxSamples; ++i) {
+                reinterpret_cast<float *>(buffer.data())[i] = fdis(gen);
+            }
+        } else if (format == AUDIO_FORMAT_PCM_8_24_BIT) {
+            for (size_t i = 0; i < maxSamples; ++i) {
+                reinterpret_cast<int32_t *>(buffer.data())[i] =
+                        (int32_t)((uint32_t)dis(gen) << 24 | dis(gen) << 16 | dis(gen)) >> 8;
+            }
+        } else {
+            for (auto &byte : buffer) {
+                byte = dis(gen);
+            }
+        }
+        for (const audio_utils_primitives_backend_t backend : {
+                AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR,
+                AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1,
+                AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2,
+                AUDIO_UTILS_PRIMITIVES_BACKEND_NEON}) {
+            if (audio_utils_primitives_set_backend(backend) != 0) continue;
+            for (uint32_t channelCount = 1; channelCount <= maxChannels; ++channelCount) {
+                for (const size_t frames : frameCounts) {
+                    SCOPED_TRACE(testing::Message() << "backend " << backend
+                            << " format " << format << " " << channelCount << " channels, "
+                            << frames << " frames");
+                    const std::vector<double> expected =
+                            energyByChannelRef(buffer, format, frames, channelCount);
+                    float energies[maxChannels];
+                    audio_utils_compute_energy_by_channel(
+                            buffer.data(), format, frames, channelCount, energies);
+                    for (uint32_t ch = 0; ch < channelCount; ++ch) {
+                        EXPECT_NEAR(expected[ch], energies[ch], expected[ch] * 1e-4);
+                    }
+                    if (channelCount == 1) {
+                        EXPECT_EQ(energies[0],
+                                audio_utils_compute_energy_mono(buffer.data(), format, frames));
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(original));
+}
+
+// The vector kernels keep the precision of long sums, where a single float accumulator doesn't.
+TEST(audio_utils_power, energy_precision) {
+    const audio_utils_primitives_backend_t original = audio_utils_primitives_get_backend();
+    const size_t samples = 1 << 20;
+    const std::vector<float> buffer(samples, 0.1f);
+    const double expected = samples * ((double)0.1f * 0.1f);
+    for (const audio_utils_primitives_backend_t backend : {
+            AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1,
+            AUDIO_UTILS_PRIMITIVES_BACKEND_AVX2,
+            AUDIO_UTILS_PRIMITIVES_BACKEND_NEON}) {
+        if (audio_utils_primitives_set_backend(backend) != 0) continue;
+        SCOPED_TRACE(testing::Message() << "backend " << backend);
+        EXPECT_NEAR(expected, audio_utils_compute_energy_mono(
+                buffer.data(), AUDIO_FORMAT_PCM_FLOAT, samples), expected * 1e-6);
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(original));
+}
@@ -17,11 +17,16 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "audio_utils_powerlog_tests"
 
+#include <math.h>
+#include <string.h>
+
 #include <audio_utils/PowerLog.h>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <log/log.h>
 
+#include "alloc_counter.h"
+
 using namespace android;
 
 static size_t countNewLines(const std::string &s) {
@@ -101,3 +106,242 @@ TEST(audio_utils_powerlog, c) {
    12-31 16:00:00.000: [  -12.0 ] sum(-12.0)
      */
 }
+
+TEST(audio_utils_powerlog, multiple_entries_per_buffer) {
+    PowerLog plog(48000 /* sampleRate */, 1 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            100 /* entries */, 2 /* framesPerEntry */);
+
+    // Each entry is computed from its own frames of the buffer.
+    const int16_t frames[] = {0x4000, 0x4000, 0x2000, 0x2000, 0, 0};
+    plog.log(frames, std::size(frames), 0 /* nowNs */);
+    const std::string s = plog.dumpToString();
+    EXPECT_NE(std::string::npos, s.find("[   -6.0  -12.0 ]")) << s;
+}
+
+// Feeds the same sequence to a locked and a lock-free PowerLog, checking the dumps agree.
+static void checkLockFreeMatches(size_t entries, size_t bins, size_t binsPerDump,
+        bool perChannel = false, uint32_t bands = 0) {
+    PowerLog locked(48000 /* sampleRate */, 2 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            entries, 3 /* framesPerEntry */, false /* lockFree */, perChannel, bands);
+    PowerLog lockFree(48000 /* sampleRate */, 2 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            entries, 3 /* framesPerEntry */, true /* lockFree */, perChannel, bands);
+    // Signals of varying lengths separated by silences, in buffers of varying sizes.
+    int16_t buffer[2 * 4];
+    size_t frames = 0;
+    size_t buffers = 0;
+    for (size_t i = 0; i < bins * 3; ++i) {
+        const int16_t sample = (i / 3) % 7 < 2 ? 0 : 0x100 * ((i / 3) % 7);
+        buffer[frames * 2] = buffer[frames * 2 + 1] = sample;
+        if (++frames == (buffers % 4) + 1) {
+            const int64_t nowNs = (int64_t)i * 1000000000;
+            locked.log(buffer, frames, nowNs);
+            lockFree.log(buffer, frames, nowNs);
+            frames = 0;
+            ++buffers;
+        }
+        if (binsPerDump > 0 && i % (binsPerDump * 3) == 0) {
+            EXPECT_EQ(locked.dumpToString(), lockFree.dumpToString());
+            EXPECT_EQ(locked.dumpToBinary(), lockFree.dumpToBinary());
+        }
+    }
+    EXPECT_EQ(locked.dumpToString(), lockFree.dumpToString());
+    EXPECT_EQ(locked.dumpToBinary(), lockFree.dumpToBinary());
+}
+
+TEST(audio_utils_powerlog, lock_free) {
+    checkLockFreeMatches(100 /* entries */, 50 /* bins */, 0 /* binsPerDump */);
+    checkLockFreeMatches(100 /* entries */, 1000 /* bins */, 7 /* binsPerDump */);
+    // The ring overflows between dumps.
+    checkLockFreeMatches(10 /* entries */, 1000 /* bins */, 0 /* binsPerDump */);
+    checkLockFreeMatches(10 /* entries */, 1000 /* bins */, 37 /* binsPerDump */);
+    // The details are carried through the ring.
+    checkLockFreeMatches(100 /* entries */, 1000 /* bins */, 7 /* binsPerDump */,
+            true /* perChannel */, 3 /* bands */);
+    checkLockFreeMatches(10 /* entries */, 1000 /* bins */, 37 /* binsPerDump */,
+            true /* perChannel */, 3 /* bands */);
+}
+
+TEST(audio_utils_powerlog, lock_free_log_does_not_block_or_allocate) {
+    const int16_t frames[4] = {0x4000, 0x4000, 0, 0};
+    for (const bool lockFree : {false, true}) {
+        PowerLog plog(48000 /* sampleRate */, 1 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+                4 /* entries */, 1 /* framesPerEntry */, lockFree, true /* perChannel */,
+                2 /* bands */);
+        gAllocations = 0;
+        gLocks = 0;
+        tCounting = true;
+        for (int i = 0; i < 100; ++i) {
+            plog.log(frames, std::size(frames), i /* nowNs */);
+        }
+        tCounting = false;
+        plog.dumpToString();
+        if (lockFree) {
+            EXPECT_EQ(0, gAllocations);
+            EXPECT_EQ(0, gLocks);
+        } else {
+            // Checks the counting works.
+            EXPECT_EQ(100, gLocks);
+        }
+    }
+}
+
+// A decoder for the format of PowerLog::dumpToBinary().
+struct BinaryDump {
+    struct Bin {
+        bool mZero;
+        int64_t mTime;
+        int32_t mPower;
+        std::vector<int32_t> mDetails;
+    };
+    uint32_t mSampleRate;
+    uint32_t mChannelCount;
+    uint32_t mFramesPerEntry;
+    bool mPerChannel;
+    uint32_t mBands;
+    std::vector<Bin> mBins;
+
+    explicit BinaryDump(const std::vector<uint8_t> &in) {
+        EXPECT_GE(in.size(), 4u);
+        EXPECT_EQ(0, memcmp(in.data(), "PWR", 3));
+        EXPECT_EQ(PowerLog::kBinaryVersion, in[3]);
+        size_t pos = 4;
+        auto varint = [&]() {
+            uint64_t value = 0;
+            for (int shift = 0; pos < in.size(); shift += 7) {
+                const uint8_t byte = in[pos++];
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) break;
+            }
+            return value;
+        };
+        auto signedVarint = [&]() {
+            const uint64_t value = varint();
+            return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+        };
+        mSampleRate = varint();
+        mChannelCount = varint();
+        mFramesPerEntry = varint();
+        mPerChannel = varint();
+        mBands = varint();
+        const size_t count = varint();
+        const size_t detailCount = (mPerChannel ? mChannelCount : 0) + mBands;
+        const int64_t binNs = (int64_t)mFramesPerEntry * 1000000000 / mSampleRate;
+        Bin bin = {false, 0, 0, std::vector<int32_t>(detailCount)};
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t code = varint();
+            if (code == 0) {
+                mBins.push_back({true, 0, 0, {}});
+                continue;
+            }
+            bin.mPower += (int64_t)((code - 1) >> 2) ^ -(int64_t)(((code - 1) >> 1) & 1);
+            bin.mTime += binNs;
+            if ((code - 1) & 1) {
+                bin.mTime += signedVarint() * 1000000;
+            }
+            for (auto &detail : bin.mDetails) {
+                detail += signedVarint();
+            }
+            mBins.push_back(bin);
+        }
+        EXPECT_EQ(in.size(), pos);
+    }
+};
+
+TEST(audio_utils_powerlog, binary) {
+    PowerLog plog(48000 /* sampleRate */, 1 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            100 /* entries */, 480 /* framesPerEntry */);
+    EXPECT_EQ(0u, BinaryDump(plog.dumpToBinary()).mBins.size());
+
+    // Two signals, the second late by 25 ms.
+    std::vector<int16_t> frames(480);
+    const int64_t binNs = 10000000;
+    const int16_t levels[] = {0x4000, 0x2000, 0x2000, 0, 0x1000};
+    int64_t nowNs = 1000000000;
+    for (const int16_t level : levels) {
+        std::fill(frames.begin(), frames.end(), level);
+        plog.log(frames.data(), frames.size(), nowNs);
+        nowNs += level == 0 ? binNs + 25000000 : binNs;
+    }
+    const BinaryDump dump(plog.dumpToBinary());
+    EXPECT_EQ(48000u, dump.mSampleRate);
+    EXPECT_EQ(1u, dump.mChannelCount);
+    EXPECT_EQ(480u, dump.mFramesPerEntry);
+    EXPECT_FALSE(dump.mPerChannel);
+    EXPECT_EQ(0u, dump.mBands);
+    ASSERT_EQ(5u, dump.mBins.size());
+    const int32_t powers[] = {-60, -120, -120, 0, -181};
+    const int64_t times[] = {1000000000, 1010000000, 1020000000, 0, 1065000000};
+    for (size_t i = 0; i < dump.mBins.size(); ++i) {
+        EXPECT_EQ(levels[i] == 0, dump.mBins[i].mZero);
+        if (levels[i] != 0) {
+            EXPECT_EQ(powers[i], dump.mBins[i].mPower);
+            EXPECT_EQ(times[i], dump.mBins[i].mTime);
+        }
+    }
+
+    // truncating on time
+    EXPECT_EQ(1u, BinaryDump(plog.dumpToBinary(1030000000 /* limitNs */)).mBins.size());
+}
+
+TEST(audio_utils_powerlog, binary_per_channel) {
+    PowerLog plog(48000 /* sampleRate */, 2 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            10 /* entries */, 4 /* framesPerEntry */, false /* lockFree */,
+            true /* perChannel */);
+    const int16_t frames[] = {0x4000, 0x1000, 0x4000, 0x1000, -0x4000, -0x1000, 0x4000, 0x1000};
+    plog.log(frames, std::size(frames) / 2, 0 /* nowNs */);
+    const BinaryDump dump(plog.dumpToBinary());
+    EXPECT_TRUE(dump.mPerChannel);
+    ASSERT_EQ(1u, dump.mBins.size());
+    ASSERT_EQ(2u, dump.mBins[0].mDetails.size());
+    EXPECT_EQ(-60, dump.mBins[0].mDetails[0]);
+    EXPECT_EQ(-181, dump.mBins[0].mDetails[1]);
+    // The bin has the mean power of the channels.
+    EXPECT_EQ(-88, dump.mBins[0].mPower);
+}
+
+TEST(audio_utils_powerlog, binary_bands) {
+    const uint32_t sampleRate = 48000;
+    PowerLog plog(sampleRate, 1 /* channelCount */, AUDIO_FORMAT_PCM_FLOAT,
+            10 /* entries */, 18 * PowerLog::kFftFrames /* framesPerEntry */,
+            false /* lockFree */, false /* perChannel */, 2 /* bands */);
+    // A whole number of windows per bin, so that each window has a single tone.
+    std::vector<float> frames(18 * PowerLog::kFftFrames);
+    size_t n = 0;
+    for (const float frequency : {500.f, 15000.f}) {
+        for (auto &frame : frames) {
+            frame = 0.5f * sinf(2.f * (float)M_PI * frequency * n++ / sampleRate);
+        }
+        plog.log(frames.data(), frames.size(), n /* nowNs */);
+    }
+    const BinaryDump dump(plog.dumpToBinary());
+    ASSERT_EQ(2u, dump.mBins.size());
+    for (size_t i = 0; i < dump.mBins.size(); ++i) {
+        const BinaryDump::Bin &bin = dump.mBins[i];
+        ASSERT_EQ(2u, bin.mDetails.size());
+        // The tone is in the low band, then in the high band.
+        const int32_t in = bin.mDetails[i];
+        const int32_t out = bin.mDetails[1 - i];
+        EXPECT_GT(in - out, 300);
+        EXPECT_NEAR(bin.mPower, in, 1);
+        EXPECT_NEAR(-90, bin.mPower, 1); // a sine of amplitude 0.5 has power -9 dB
+    }
+}
+
+TEST(audio_utils_powerlog, binary_is_compact) {
+    PowerLog plog(48000 /* sampleRate */, 1 /* channelCount */, AUDIO_FORMAT_PCM_16_BIT,
+            1000 /* entries */, 480 /* framesPerEntry */);
+    // A slowly varying signal, with occasional pauses.
+    std::vector<int16_t> frames(480);
+    int64_t nowNs = 1000000000;
+    for (size_t i = 0; i < 1000; ++i) {
+        const int16_t level = i % 100 == 99 ? 0 : 0x100 + 0x40 * (i % 100);
+        std::fill(frames.begin(), frames.end(), level);
+        plog.log(frames.data(), frames.size(), nowNs);
+        nowNs += 10000000;
+    }
+    const std::string text = plog.dumpToString();
+    const std::vector<uint8_t> binary = plog.dumpToBinary();
+    EXPECT_EQ(1000u, BinaryDump(binary).mBins.size());
+    EXPECT_LE(binary.size() * 10, text.size())
+            << "binary " << binary.size() << " text " << text.size();
+}
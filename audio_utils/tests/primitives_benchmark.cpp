@@ -20,6 +20,7 @@
 
 #include <benchmark/benchmark.h>
 
+#include <audio_utils/format.h>
 #include <audio_utils/primitives.h>
 
 static void BM_MemcpyToFloatFromFloatWithClamping(benchmark::State& state) {
@@ -137,4 +138,227 @@ static void BM_MemcpyToI16FromFloat(benchmark::State& state) {
 
 BENCHMARK(BM_MemcpyToI16FromFloat)->RangeMultiplier(2)->Ranges({{10, 8<<12}});
 
+// The packed 24 bit benchmarks take a second argument,
+// 0 for the scalar backend and 1 for the backend selected for this device.
+static void setBackend(benchmark::State& state, audio_utils_primitives_backend_t backend) {
+    if (state.range(1) == 0) {
+        audio_utils_primitives_set_backend(AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR);
+    } else {
+        audio_utils_primitives_set_backend(backend);
+    }
+    state.SetLabel(state.range(1) == 0 ? "scalar" : "selected");
+}
+
+static void BM_MemcpyToFloatFromP24(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+
+    std::vector<int32_t> i32(count);
+    std::vector<uint8_t> src(count * 3);
+    std::vector<float> dst(count);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_int_distribution<> dis(INT32_MIN, INT32_MAX);
+    for (size_t i = 0; i < count; i++) {
+        i32[i] = dis(gen);
+    }
+    memcpy_to_p24_from_i32(src.data(), i32.data(), count);
+
+    // Run the test
+    setBackend(state, backend);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_to_float_from_p24(dst.data(), src.data(), count);
+        benchmark::ClobberMemory();
+    }
+    audio_utils_primitives_set_backend(backend);
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyToFloatFromP24)->RangeMultiplier(2)->Ranges({{10, 8<<12}, {0, 1}});
+
+static void BM_MemcpyToP24FromFloat(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+
+    std::vector<float> src(count);
+    std::vector<uint8_t> dst(count * 3);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_real_distribution<> dis(-1., 1.);
+    for (size_t i = 0; i < count; i++) {
+        src[i] = dis(gen);
+    }
+
+    // Run the test
+    setBackend(state, backend);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_to_p24_from_float(dst.data(), src.data(), count);
+        benchmark::ClobberMemory();
+    }
+    audio_utils_primitives_set_backend(backend);
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyToP24FromFloat)->RangeMultiplier(2)->Ranges({{10, 8<<12}, {0, 1}});
+
+static void BM_MemcpyToI32FromP24(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+
+    std::vector<int32_t> i32(count);
+    std::vector<uint8_t> src(count * 3);
+    std::vector<int32_t> dst(count);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_int_distribution<> dis(INT32_MIN, INT32_MAX);
+    for (size_t i = 0; i < count; i++) {
+        i32[i] = dis(gen);
+    }
+    memcpy_to_p24_from_i32(src.data(), i32.data(), count);
+
+    // Run the test
+    setBackend(state, backend);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_to_i32_from_p24(dst.data(), src.data(), count);
+        benchmark::ClobberMemory();
+    }
+    audio_utils_primitives_set_backend(backend);
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyToI32FromP24)->RangeMultiplier(2)->Ranges({{10, 8<<12}, {0, 1}});
+
+static void BM_MemcpyToP24FromI32(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+
+    std::vector<int32_t> src(count);
+    std::vector<uint8_t> dst(count * 3);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_int_distribution<> dis(INT32_MIN, INT32_MAX);
+    for (size_t i = 0; i < count; i++) {
+        src[i] = dis(gen);
+    }
+
+    // Run the test
+    setBackend(state, backend);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_to_p24_from_i32(dst.data(), src.data(), count);
+        benchmark::ClobberMemory();
+    }
+    audio_utils_primitives_set_backend(backend);
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyToP24FromI32)->RangeMultiplier(2)->Ranges({{10, 8<<12}, {0, 1}});
+
+// memcpy_by_audio_format() dispatches on the formats for every call, which matters
+// for the small buffers of low latency paths.
+static void BM_MemcpyByAudioFormat(benchmark::State& state) {
+    const size_t count = state.range(0);
+
+    std::vector<float> src(count);
+    std::vector<int16_t> dst(count);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_real_distribution<> dis(-1., 1.);
+    for (size_t i = 0; i < count; i++) {
+        src[i] = dis(gen);
+    }
+
+    // Run the test
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_by_audio_format(dst.data(), AUDIO_FORMAT_PCM_16_BIT,
+                src.data(), AUDIO_FORMAT_PCM_FLOAT, count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyByAudioFormat)->RangeMultiplier(2)->Range(64, 256);
+
+static void BM_MemcpyByAudioFormatGetFunction(benchmark::State& state) {
+    const size_t count = state.range(0);
+
+    std::vector<float> src(count);
+    std::vector<int16_t> dst(count);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_real_distribution<> dis(-1., 1.);
+    for (size_t i = 0; i < count; i++) {
+        src[i] = dis(gen);
+    }
+
+    // Run the test, with the function resolved once as a caller would cache it.
+    const memcpy_by_audio_format_function_t function =
+            memcpy_by_audio_format_get_function(AUDIO_FORMAT_PCM_16_BIT, AUDIO_FORMAT_PCM_FLOAT);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        function(dst.data(), src.data(), count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyByAudioFormatGetFunction)->RangeMultiplier(2)->Range(64, 256);
+
+// Reorders 8 channels of 16 bit samples, as from the AOSP to the WAVE channel order,
+// with the plan's vector shuffles or with memcpy_by_index_array().
+static void BM_MemcpyByIndexArrayWithPlan(benchmark::State& state) {
+    const size_t count = state.range(0);
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+    constexpr uint32_t kChannels = 8;
+    const int8_t idxary[kChannels] = {0, 1, 3, 2, 6, 7, 4, 5};
+
+    std::vector<int16_t> src(count * kChannels);
+    std::vector<int16_t> dst(count * kChannels);
+
+    // Initialize src buffer with deterministic pseudo-random values
+    std::minstd_rand gen(count);
+    std::uniform_int_distribution<> dis(INT16_MIN, INT16_MAX);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = dis(gen);
+    }
+
+    // Run the test
+    memcpy_by_index_array_plan_t plan;
+    memcpy_by_index_array_plan_init(&plan, kChannels, kChannels, idxary, sizeof(int16_t));
+    setBackend(state, backend);
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(src.data());
+        benchmark::DoNotOptimize(dst.data());
+        memcpy_by_index_array_with_plan(dst.data(), src.data(), &plan, count);
+        benchmark::ClobberMemory();
+    }
+    audio_utils_primitives_set_backend(backend);
+
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(BM_MemcpyByIndexArrayWithPlan)->RangeMultiplier(2)->Ranges({{10, 8<<12}, {0, 1}});
+
 BENCHMARK_MAIN();
@@ -17,7 +17,10 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "audio_utils_primitives_tests"
 
+#include <errno.h>
 #include <math.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -866,3 +869,287 @@ TEST(audio_utils_primitives, MemcpyToFloatFromFloatWithClamping) {
 
     ASSERT_EQ(dst, expected) << "src=" << testing::PrintToString(src);
 }
+
+// Runs fn on src with every supported backend, and checks the output is bit exact
+// with the scalar backend, for each count up to the number of samples in src,
+// both out-of-place and in-place.
+template <typename D, typename S>
+static void checkBackendsBitExact(const char *name, void (*fn)(D *, const S *, size_t),
+        const std::vector<S> &src,
+        size_t dstBytesPerSample = sizeof(D), size_t srcBytesPerSample = sizeof(S))
+{
+    const audio_utils_primitives_backend_t saved = audio_utils_primitives_get_backend();
+    const size_t samples = src.size() * sizeof(S) / srcBytesPerSample;
+    const size_t bufBytes = samples * std::max(srcBytesPerSample, dstBytesPerSample);
+
+    auto run = [&](audio_utils_primitives_backend_t backend, size_t count, bool inPlace) {
+        EXPECT_EQ(0, audio_utils_primitives_set_backend(backend));
+        std::vector<uint8_t> buf(bufBytes, 0xa5);
+        const S *in = src.data();
+        if (inPlace) {
+            memcpy(buf.data(), src.data(), count * srcBytesPerSample);
+            in = reinterpret_cast<const S *>(buf.data());
+        }
+        fn(reinterpret_cast<D *>(buf.data()), in, count);
+        buf.resize(count * dstBytesPerSample);
+        return buf;
+    };
+
+    for (int b = AUDIO_UTILS_PRIMITIVES_BACKEND_SSE4_1;
+            b <= AUDIO_UTILS_PRIMITIVES_BACKEND_NEON; ++b) {
+        const audio_utils_primitives_backend_t backend = (audio_utils_primitives_backend_t)b;
+        if (audio_utils_primitives_set_backend(backend) != 0) {
+            continue; // not available on this device
+        }
+        for (size_t count = 0; count <= samples; count += count < 40 ? 1 : 37) {
+            for (bool inPlace : {false, true}) {
+                const std::vector<uint8_t> expected =
+                        run(AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR, count, inPlace);
+                const std::vector<uint8_t> actual = run(backend, count, inPlace);
+                ASSERT_EQ(expected, actual) << name << " backend=" << b
+                        << " count=" << count << " inPlace=" << inPlace;
+            }
+        }
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(saved));
+}
+
+TEST(audio_utils_primitives, backends_bit_exact) {
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR));
+    EXPECT_EQ(-EINVAL, audio_utils_primitives_set_backend(
+            (audio_utils_primitives_backend_t)(AUDIO_UTILS_PRIMITIVES_BACKEND_NEON + 1)));
+
+    // Floats around every rounding boundary and limit, plus random values.
+    std::vector<float> fsrc = {0.f, -0.f, INFINITY, -INFINITY, NAN, -NAN,
+            1.f, -1.f, 2.f, -2.f, 16.f, -16.f, 1e30f, -1e30f, 1e-40f, -1e-40f};
+    for (int shift : {15, 23, 27, 31}) {
+        const float lsb = 1.f / (float)(1ULL << shift);
+        for (float k : {0.5f, 1.5f, 2.5f, 65535.5f, 0.49999997f}) {
+            fsrc.push_back(k * lsb);
+            fsrc.push_back(-k * lsb);
+        }
+        fsrc.push_back(nextafterf(1.f, 0.f));
+        fsrc.push_back(1.f - lsb);
+        fsrc.push_back(-1.f + lsb);
+    }
+    srand(42);
+    while (fsrc.size() < 1000) {
+        fsrc.push_back((float)rand() / RAND_MAX * 4.f - 2.f);
+    }
+    std::vector<int32_t> isrc = {0, -1, 1, INT32_MAX, INT32_MIN, lim16pos, lim16neg,
+            lim24pos, lim24neg, 0x7ffff, 0x80000, -0x80000, 0x7ffffff, -0x8000000};
+    while (isrc.size() < 1000) {
+        isrc.push_back((int32_t)((uint32_t)rand() << 16 ^ (uint32_t)rand()));
+    }
+    std::vector<int16_t> ssrc;
+    for (size_t i = 0; i < 1000; ++i) {
+        ssrc.push_back((int16_t)(i * 65537 / 1000 + INT16_MIN));
+    }
+
+    checkBackendsBitExact("i16_from_q4_27", memcpy_to_i16_from_q4_27, isrc);
+    checkBackendsBitExact("i16_from_i32", memcpy_to_i16_from_i32, isrc);
+    checkBackendsBitExact("i16_from_float", memcpy_to_i16_from_float, fsrc);
+    checkBackendsBitExact("float_from_q4_27", memcpy_to_float_from_q4_27, isrc);
+    checkBackendsBitExact("float_from_i16", memcpy_to_float_from_i16, ssrc);
+    checkBackendsBitExact("p24_from_float", memcpy_to_p24_from_float, fsrc, 3 /* bytes */);
+    checkBackendsBitExact("q8_23_from_i16", memcpy_to_q8_23_from_i16, ssrc);
+    checkBackendsBitExact("q8_23_from_float_with_clamp",
+            memcpy_to_q8_23_from_float_with_clamp, fsrc);
+    checkBackendsBitExact("q4_27_from_float", memcpy_to_q4_27_from_float, fsrc);
+    checkBackendsBitExact("i16_from_q8_23", memcpy_to_i16_from_q8_23, isrc);
+    checkBackendsBitExact("float_from_q8_23", memcpy_to_float_from_q8_23, isrc);
+    checkBackendsBitExact("i32_from_i16", memcpy_to_i32_from_i16, ssrc);
+    checkBackendsBitExact("i32_from_float", memcpy_to_i32_from_float, fsrc);
+    checkBackendsBitExact("float_from_i32", memcpy_to_float_from_i32, isrc);
+
+    std::vector<uint8_t> p24src(isrc.size() * 3);
+    memcpy_to_p24_from_i32(p24src.data(), isrc.data(), isrc.size());
+    checkBackendsBitExact("float_from_p24", memcpy_to_float_from_p24, p24src,
+            sizeof(float), 3 /* bytes */);
+    checkBackendsBitExact("i16_from_p24", memcpy_to_i16_from_p24, p24src,
+            sizeof(int16_t), 3 /* bytes */);
+    checkBackendsBitExact("i32_from_p24", memcpy_to_i32_from_p24, p24src,
+            sizeof(int32_t), 3 /* bytes */);
+    checkBackendsBitExact("q8_23_from_p24", memcpy_to_q8_23_from_p24, p24src,
+            sizeof(int32_t), 3 /* bytes */);
+    checkBackendsBitExact("p24_from_i16", memcpy_to_p24_from_i16, ssrc, 3 /* bytes */);
+    checkBackendsBitExact("p24_from_q8_23", memcpy_to_p24_from_q8_23, isrc, 3 /* bytes */);
+    checkBackendsBitExact("p24_from_i32", memcpy_to_p24_from_i32, isrc, 3 /* bytes */);
+}
+
+TEST(audio_utils_primitives, accumulate_float_from) {
+    const audio_utils_primitives_backend_t saved = audio_utils_primitives_get_backend();
+    constexpr size_t kFrames = 203; // not a multiple of any vector size
+    constexpr uint32_t kMaxChannels = 10;
+    const float gains[kMaxChannels] = {0.5f, -1.f, 2.f, 0.f, 1.f, 0.25f, -0.75f, 1.5f, 3.f, 0.1f};
+
+    std::vector<int32_t> i32(kFrames * kMaxChannels);
+    srand(42);
+    for (auto &v : i32) {
+        v = (int32_t)((uint32_t)rand() << 16 ^ (uint32_t)rand());
+    }
+    std::vector<int16_t> i16(i32.size());
+    std::vector<uint8_t> p24(i32.size() * 3);
+    std::vector<float> f(i32.size());
+    memcpy_to_i16_from_i32(i16.data(), i32.data(), i32.size());
+    memcpy_to_p24_from_i32(p24.data(), i32.data(), i32.size());
+    memcpy_to_float_from_i32(f.data(), i32.data(), i32.size());
+
+    // Checks dst against the initial contents plus the source scaled in double.
+    auto check = [&](const std::vector<float> &dst, const int32_t *src, double scale,
+            size_t count, uint32_t channels, const char *name, int backend) {
+        for (size_t i = 0; i < dst.size(); ++i) {
+            const double expected = i < count ? 0.5 + src[i] * scale * gains[i % channels] : 0.5;
+            ASSERT_NEAR(expected, dst[i], 1e-6) << name << " backend=" << backend
+                    << " channels=" << channels << " i=" << i;
+        }
+    };
+
+    for (int b = AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR;
+            b <= AUDIO_UTILS_PRIMITIVES_BACKEND_NEON; ++b) {
+        if (audio_utils_primitives_set_backend((audio_utils_primitives_backend_t)b) != 0) {
+            continue; // not available on this device
+        }
+        const double fromI32 = 1. / (1ULL << 31);
+        const double fromI16 = 1. / (1 << 15);
+        for (uint32_t channels = 1; channels <= kMaxChannels; ++channels) {
+            const size_t count = kFrames * channels;
+            std::vector<float> dst(count + 1);
+            const std::vector<int32_t> i16As32(i16.begin(), i16.end());
+
+            if (channels == 1) {
+                std::fill(dst.begin(), dst.end(), 0.5f);
+                accumulate_float_from_i16(dst.data(), i16.data(), count, gains[0]);
+                check(dst, i16As32.data(), fromI16, count, 1, "i16", b);
+                std::fill(dst.begin(), dst.end(), 0.5f);
+                accumulate_float_from_p24(dst.data(), p24.data(), count, gains[0]);
+                std::vector<int32_t> p24As32(count);
+                memcpy_to_i32_from_p24(p24As32.data(), p24.data(), count);
+                check(dst, p24As32.data(), fromI32, count, 1, "p24", b);
+                std::fill(dst.begin(), dst.end(), 0.5f);
+                accumulate_float_from_i32(dst.data(), i32.data(), count, gains[0]);
+                check(dst, i32.data(), fromI32, count, 1, "i32", b);
+                std::fill(dst.begin(), dst.end(), 0.5f);
+                accumulate_float_from_float(dst.data(), f.data(), count, gains[0]);
+                check(dst, i32.data(), fromI32, count, 1, "float", b);
+            }
+
+            std::fill(dst.begin(), dst.end(), 0.5f);
+            accumulate_float_from_i16_by_channel(dst.data(), i16.data(), kFrames, channels, gains);
+            check(dst, i16As32.data(), fromI16, count, channels, "i16_by_channel", b);
+            std::fill(dst.begin(), dst.end(), 0.5f);
+            accumulate_float_from_p24_by_channel(dst.data(), p24.data(), kFrames, channels, gains);
+            std::vector<int32_t> p24As32(count);
+            memcpy_to_i32_from_p24(p24As32.data(), p24.data(), count);
+            check(dst, p24As32.data(), fromI32, count, channels, "p24_by_channel", b);
+            std::fill(dst.begin(), dst.end(), 0.5f);
+            accumulate_float_from_i32_by_channel(dst.data(), i32.data(), kFrames, channels, gains);
+            check(dst, i32.data(), fromI32, count, channels, "i32_by_channel", b);
+            std::fill(dst.begin(), dst.end(), 0.5f);
+            accumulate_float_from_float_by_channel(dst.data(), f.data(), kFrames, channels, gains);
+            check(dst, i32.data(), fromI32, count, channels, "float_by_channel", b);
+        }
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(saved));
+}
+
+TEST(audio_utils_primitives, memcpy_by_index_array_plan_flags) {
+    memcpy_by_index_array_plan_t plan;
+    const int8_t identity[] = {0, 1, 2, 3};
+    EXPECT_EQ(0, memcpy_by_index_array_plan_init(&plan, 4, 4, identity, 2));
+    EXPECT_EQ(0u, plan.flags);
+    const int8_t reorder[] = {1, 0, 3, 2};
+    EXPECT_EQ(0, memcpy_by_index_array_plan_init(&plan, 4, 4, reorder, 2));
+    EXPECT_EQ((uint32_t)MEMCPY_BY_INDEX_ARRAY_REORDER, plan.flags);
+    EXPECT_EQ(0, memcpy_by_index_array_plan_init(&plan, 2, 4, identity, 2));
+    EXPECT_EQ((uint32_t)MEMCPY_BY_INDEX_ARRAY_DROP, plan.flags);
+    const int8_t duplicate[] = {0, 0};
+    EXPECT_EQ(0, memcpy_by_index_array_plan_init(&plan, 2, 1, duplicate, 2));
+    EXPECT_EQ((uint32_t)(MEMCPY_BY_INDEX_ARRAY_REORDER | MEMCPY_BY_INDEX_ARRAY_DUPLICATE),
+            plan.flags);
+    const int8_t zeroFill[] = {0, 1, -1, -1};
+    EXPECT_EQ(0, memcpy_by_index_array_plan_init(&plan, 4, 2, zeroFill, 2));
+    EXPECT_EQ((uint32_t)MEMCPY_BY_INDEX_ARRAY_ZERO_FILL, plan.flags);
+
+    const int8_t outOfRange[] = {0, 2};
+    EXPECT_EQ(-EINVAL, memcpy_by_index_array_plan_init(&plan, 2, 2, outOfRange, 2));
+    EXPECT_EQ(-EINVAL, memcpy_by_index_array_plan_init(&plan, 2, 2, identity, 5));
+    EXPECT_EQ(-EINVAL, memcpy_by_index_array_plan_init(&plan, 2,
+            MEMCPY_BY_INDEX_ARRAY_PLAN_MAX_CHANNELS + 1, identity, 2));
+}
+
+TEST(audio_utils_primitives, memcpy_by_index_array_with_plan) {
+    const audio_utils_primitives_backend_t saved = audio_utils_primitives_get_backend();
+    constexpr uint32_t kMaxChannels = 12;
+    constexpr size_t kMaxFrames = 67;
+    std::vector<uint8_t> src(kMaxFrames * kMaxChannels * 4);
+    srand(42);
+    for (auto &v : src) {
+        v = rand();
+    }
+    std::vector<uint8_t> expected(kMaxFrames * kMaxChannels * 4);
+    std::vector<uint8_t> actual(expected.size());
+
+    for (int trial = 0; trial < 200; ++trial) {
+        const uint32_t srcChannels = 1 + rand() % kMaxChannels;
+        const uint32_t dstChannels = 1 + rand() % kMaxChannels;
+        int8_t idxary[kMaxChannels];
+        const bool identity = trial % 10 == 0 && srcChannels == dstChannels;
+        for (uint32_t i = 0; i < dstChannels; ++i) {
+            idxary[i] = identity ? i : rand() % (srcChannels + 1) - 1;
+        }
+        for (size_t sampleSize = 1; sampleSize <= 4; ++sampleSize) {
+            memcpy_by_index_array_plan_t plan;
+            ASSERT_EQ(0, memcpy_by_index_array_plan_init(
+                    &plan, dstChannels, srcChannels, idxary, sampleSize));
+            for (int b = AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR;
+                    b <= AUDIO_UTILS_PRIMITIVES_BACKEND_NEON; ++b) {
+                if (audio_utils_primitives_set_backend(
+                        (audio_utils_primitives_backend_t)b) != 0) {
+                    continue; // not available on this device
+                }
+                for (size_t frames : {(size_t)0, (size_t)1, (size_t)5, (size_t)16, kMaxFrames}) {
+                    std::fill(expected.begin(), expected.end(), 0xa5);
+                    std::fill(actual.begin(), actual.end(), 0xa5);
+                    memcpy_by_index_array(expected.data(), dstChannels, src.data(), srcChannels,
+                            idxary, sampleSize, frames);
+                    memcpy_by_index_array_with_plan(actual.data(), src.data(), &plan, frames);
+                    ASSERT_EQ(expected, actual) << "backend=" << b
+                            << " src=" << srcChannels << " dst=" << dstChannels
+                            << " size=" << sampleSize << " frames=" << frames;
+                }
+            }
+        }
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(saved));
+}
+
+TEST(audio_utils_primitives, memcpy_by_index_array_with_plan_zero_fill) {
+    // The second vector of 4 byte samples is all zeros, and the first needs two gathers,
+    // so there are as many gathers as vectors but not one per vector.
+    const audio_utils_primitives_backend_t saved = audio_utils_primitives_get_backend();
+    constexpr uint32_t kChannels = 8;
+    constexpr size_t kFrames = 16;
+    const int8_t idxary[kChannels] = {0, 7, 1, 6, -1, -1, -1, -1};
+    const int32_t srcFrame[kChannels] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const int32_t expectedFrame[kChannels] = {1, 8, 2, 7, 0, 0, 0, 0};
+    std::vector<int32_t> src(kFrames * kChannels);
+    std::vector<int32_t> expected(src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = srcFrame[i % kChannels];
+        expected[i] = expectedFrame[i % kChannels];
+    }
+    memcpy_by_index_array_plan_t plan;
+    ASSERT_EQ(0, memcpy_by_index_array_plan_init(
+            &plan, kChannels, kChannels, idxary, sizeof(int32_t)));
+    for (int b = AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR;
+            b <= AUDIO_UTILS_PRIMITIVES_BACKEND_NEON; ++b) {
+        if (audio_utils_primitives_set_backend((audio_utils_primitives_backend_t)b) != 0) {
+            continue; // not available on this device
+        }
+        std::vector<int32_t> actual(src.size(), -1);
+        memcpy_by_index_array_with_plan(actual.data(), src.data(), &plan, kFrames);
+        EXPECT_EQ(expected, actual) << "backend=" << b;
+    }
+    EXPECT_EQ(0, audio_utils_primitives_set_backend(saved));
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <audio_utils/primitives.h>
+#include <audio_utils/resampler.h>
+
+static constexpr uint32_t kOutSampleRate = 48000;
+static constexpr size_t kOutFrames = kOutSampleRate / 100; // a 10 ms period.
+
+// The sample formats of the resampler entry points.
+enum class Path {
+    FLOAT,             // resample_from_input_float()
+    I16_ROUND_TRIP,    // float converted to int16_t, resample_from_input(), and back to float
+    I32,               // resample_from_input_i32()
+};
+
+typedef int (*create_resampler_t)(uint32_t inSampleRate, uint32_t outSampleRate,
+        uint32_t channelCount, uint32_t quality, struct resampler_buffer_provider *provider,
+        struct resampler_itfe **resampler);
+
+// Resamples 10 ms periods of state.range(0) channels from inSampleRate to 48 kHz,
+// by the resampler of create.
+// The "realtime" counter is the number of seconds of audio resampled per second of CPU.
+static void BM_Resampler(benchmark::State& state, uint32_t inSampleRate, Path path,
+        create_resampler_t create = create_polyphase_resampler) {
+    const uint32_t channelCount = state.range(0);
+    struct resampler_itfe *resampler;
+    if (create(inSampleRate, kOutSampleRate, channelCount,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler) != 0) {
+        state.SkipWithError("cannot create resampler");
+        return;
+    }
+
+    // Initialize the input with deterministic pseudo-random values, with enough frames
+    // for a period, and a few more in case the resampler buffers some.
+    const size_t inFrames = kOutFrames * inSampleRate / kOutSampleRate + 16;
+    std::minstd_rand gen(channelCount);
+    std::uniform_real_distribution<> dis(-1., 1.);
+    std::vector<float> in(inFrames * channelCount);
+    for (auto &sample : in) {
+        sample = dis(gen);
+    }
+    std::vector<float> out(kOutFrames * channelCount);
+    std::vector<int16_t> in16(in.size());
+    std::vector<int16_t> out16(out.size());
+    std::vector<int32_t> in32(in.size());
+    std::vector<int32_t> out32(out.size());
+    memcpy_to_i32_from_float(in32.data(), in.data(), in.size());
+
+    // Run the test
+    while (state.KeepRunning()) {
+        size_t inFrameCount = inFrames;
+        size_t outFrameCount = kOutFrames;
+        switch (path) {
+        case Path::FLOAT:
+            resampler->resample_from_input_float(resampler, in.data(), &inFrameCount,
+                    out.data(), &outFrameCount);
+            break;
+        case Path::I16_ROUND_TRIP:
+            memcpy_to_i16_from_float(in16.data(), in.data(), in.size());
+            resampler->resample_from_input(resampler, in16.data(), &inFrameCount,
+                    out16.data(), &outFrameCount);
+            memcpy_to_float_from_i16(out.data(), out16.data(), outFrameCount * channelCount);
+            break;
+        case Path::I32:
+            resampler->resample_from_input_i32(resampler, in32.data(), &inFrameCount,
+                    out32.data(), &outFrameCount);
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::DoNotOptimize(out32.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kOutFrames * channelCount);
+    state.counters["realtime"] = benchmark::Counter(
+            state.iterations() * kOutFrames / (double) kOutSampleRate,
+            benchmark::Counter::kIsRate);
+    release_resampler(resampler);
+}
+
+static void BM_ResamplerFloat_16000(benchmark::State& state) {
+    BM_Resampler(state, 16000, Path::FLOAT);
+}
+
+BENCHMARK(BM_ResamplerFloat_16000)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerI16RoundTrip_16000(benchmark::State& state) {
+    BM_Resampler(state, 16000, Path::I16_ROUND_TRIP);
+}
+
+BENCHMARK(BM_ResamplerI16RoundTrip_16000)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerFloat_44100(benchmark::State& state) {
+    BM_Resampler(state, 44100, Path::FLOAT);
+}
+
+BENCHMARK(BM_ResamplerFloat_44100)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerI16RoundTrip_44100(benchmark::State& state) {
+    BM_Resampler(state, 44100, Path::I16_ROUND_TRIP);
+}
+
+BENCHMARK(BM_ResamplerI16RoundTrip_44100)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerI32_44100(benchmark::State& state) {
+    BM_Resampler(state, 44100, Path::I32);
+}
+
+BENCHMARK(BM_ResamplerI32_44100)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerSpeexFloat_16000(benchmark::State& state) {
+    BM_Resampler(state, 16000, Path::FLOAT, create_speex_resampler);
+}
+
+BENCHMARK(BM_ResamplerSpeexFloat_16000)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerSpeexFloat_44100(benchmark::State& state) {
+    BM_Resampler(state, 44100, Path::FLOAT, create_speex_resampler);
+}
+
+BENCHMARK(BM_ResamplerSpeexFloat_44100)->Arg(1)->Arg(2)->Arg(8);
+
+static void BM_ResamplerSpeexI16RoundTrip_44100(benchmark::State& state) {
+    BM_Resampler(state, 44100, Path::I16_ROUND_TRIP, create_speex_resampler);
+}
+
+BENCHMARK(BM_ResamplerSpeexI16RoundTrip_44100)->Arg(1)->Arg(2)->Arg(8);
+
+// Creates and releases a stereo resampler of create from state.range(0) Hz to 48 kHz,
+// as a stream open. Cold, the resampler designs its filter; warm, another resampler of the
+// same rates is open, and a polyphase resampler shares its filter bank. A speex resampler
+// designs its filter at each open, warm or cold.
+static void BM_CreateResampler(benchmark::State& state, bool warm,
+        create_resampler_t create = create_polyphase_resampler) {
+    const uint32_t inSampleRate = state.range(0);
+    struct resampler_itfe *other = NULL;
+    if (warm && create(inSampleRate, kOutSampleRate, 2 /* channelCount */,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &other) != 0) {
+        state.SkipWithError("cannot create resampler");
+        return;
+    }
+
+    // Run the test
+    while (state.KeepRunning()) {
+        struct resampler_itfe *resampler;
+        if (create(inSampleRate, kOutSampleRate, 2 /* channelCount */,
+                RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler) != 0) {
+            state.SkipWithError("cannot create resampler");
+            break;
+        }
+        benchmark::DoNotOptimize(resampler);
+        release_resampler(resampler);
+    }
+    release_resampler(other);
+}
+
+static void BM_CreateResamplerCold(benchmark::State& state) {
+    BM_CreateResampler(state, false /* warm */);
+}
+
+BENCHMARK(BM_CreateResamplerCold)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+static void BM_CreateResamplerWarm(benchmark::State& state) {
+    BM_CreateResampler(state, true /* warm */);
+}
+
+BENCHMARK(BM_CreateResamplerWarm)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+// The default create_resampler(), which is speex on Android.
+static void BM_CreateResamplerDefaultCold(benchmark::State& state) {
+    BM_CreateResampler(state, false /* warm */, create_resampler);
+}
+
+BENCHMARK(BM_CreateResamplerDefaultCold)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+static void BM_CreateResamplerDefaultWarm(benchmark::State& state) {
+    BM_CreateResampler(state, true /* warm */, create_resampler);
+}
+
+BENCHMARK(BM_CreateResamplerDefaultWarm)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+static void BM_CreateResamplerSpeexCold(benchmark::State& state) {
+    BM_CreateResampler(state, false /* warm */, create_speex_resampler);
+}
+
+BENCHMARK(BM_CreateResamplerSpeexCold)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+static void BM_CreateResamplerSpeexWarm(benchmark::State& state) {
+    BM_CreateResampler(state, true /* warm */, create_speex_resampler);
+}
+
+BENCHMARK(BM_CreateResamplerSpeexWarm)->Arg(8000)->Arg(16000)->Arg(44100)->Arg(96000);
+
+BENCHMARK_MAIN();
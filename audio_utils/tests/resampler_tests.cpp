@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//#define LOG_NDEBUG 0
+#define LOG_TAG "audio_utils_resampler_tests"
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <log/log.h>
+
+#include <audio_utils/primitives.h>
+#include <audio_utils/resampler.h>
+
+#include "private/resampler_cache.h"
+
+// Sine waves of a frequency for each channel.
+static std::vector<float> makeSines(uint32_t sampleRate, size_t frames,
+        const std::vector<double> &frequencies, double amplitude = 0.5) {
+    const size_t channelCount = frequencies.size();
+    std::vector<float> sines(frames * channelCount);
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t ch = 0; ch < channelCount; ++ch) {
+            sines[i * channelCount + ch] =
+                    amplitude * sin(2. * M_PI * frequencies[ch] * i / sampleRate);
+        }
+    }
+    return sines;
+}
+
+// Resamples all of in by blocks of blockFrames, returning the output.
+template <typename T>
+static std::vector<T> resample(struct resampler_itfe *resampler, uint32_t channelCount,
+        const std::vector<T> &in, size_t blockFrames,
+        int (*resampleFrom)(struct resampler_itfe *, const T *, size_t *, T *, size_t *)) {
+    std::vector<T> out;
+    std::vector<T> block(blockFrames * 4 * channelCount);
+    const size_t frames = in.size() / channelCount;
+    for (size_t read = 0; read < frames; ) {
+        size_t inFrames = std::min(blockFrames, frames - read);
+        size_t outFrames = block.size() / channelCount;
+        EXPECT_EQ(0, resampleFrom(resampler, &in[read * channelCount], &inFrames,
+                block.data(), &outFrames));
+        EXPECT_GT(inFrames + outFrames, 0u);
+        read += inFrames;
+        out.insert(out.end(), block.begin(), block.begin() + outFrames * channelCount);
+    }
+    return out;
+}
+
+static int resampleFloat(struct resampler_itfe *resampler, const float *in,
+        size_t *inFrameCount, float *out, size_t *outFrameCount) {
+    return resampler->resample_from_input_float(resampler, in, inFrameCount,
+            out, outFrameCount);
+}
+
+static int resampleI16(struct resampler_itfe *resampler, const int16_t *in,
+        size_t *inFrameCount, int16_t *out, size_t *outFrameCount) {
+    return resampler->resample_from_input(resampler, const_cast<int16_t *>(in), inFrameCount,
+            out, outFrameCount);
+}
+
+static int resampleI32(struct resampler_itfe *resampler, const int32_t *in,
+        size_t *inFrameCount, int32_t *out, size_t *outFrameCount) {
+    return resampler->resample_from_input_i32(resampler, in, inFrameCount,
+            out, outFrameCount);
+}
+
+static std::vector<float> resampleSines(uint32_t inSampleRate, uint32_t outSampleRate,
+        const std::vector<double> &frequencies, size_t frames, size_t blockFrames = 480) {
+    const uint32_t channelCount = frequencies.size();
+    struct resampler_itfe *resampler;
+    EXPECT_EQ(0, create_polyphase_resampler(inSampleRate, outSampleRate, channelCount,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+    if (resampler == NULL) {
+        return {};
+    }
+    const std::vector<float> out = resample(resampler, channelCount,
+            makeSines(inSampleRate, frames, frequencies), blockFrames, resampleFloat);
+    release_resampler(resampler);
+    return out;
+}
+
+// The output frame n of a resampler is at time n / outSampleRate, so that the sines are
+// continued at the output rate, once the filter has its history.
+TEST(audio_utils_resampler, sine) {
+    const struct {
+        uint32_t in;
+        uint32_t out;
+    } rates[] = {
+        {48000, 16000}, {48000, 24000}, {44100, 48000}, {16000, 48000},
+        {8000, 44100}, {44100, 47999} /* interpolated phases */, {48000, 8000},
+    };
+    for (const auto &rate : rates) {
+        SCOPED_TRACE(testing::Message() << rate.in << " to " << rate.out);
+        const size_t frames = rate.in / 2;
+        const std::vector<float> out = resampleSines(rate.in, rate.out, {1000.}, frames);
+        // All but the frames of the half filter after the last input frame.
+        const size_t expected = (frames - 1) * rate.out / rate.in;
+        EXPECT_LE(out.size(), expected + 1);
+        EXPECT_GE(out.size(), expected - 200);
+        const std::vector<float> sines = makeSines(rate.out, out.size(), {1000.});
+        float maxError = 0.f;
+        for (size_t i = 200; i < out.size(); ++i) {
+            maxError = std::max(maxError, fabsf(out[i] - sines[i]));
+        }
+        EXPECT_LT(maxError, 1e-3f);
+    }
+}
+
+TEST(audio_utils_resampler, drift) {
+    // With an input clock drift, the output frame n is at time n * (1 + drift) / outSampleRate,
+    // so that the sines are continued at their frequency scaled by (1 + drift).
+    const struct {
+        uint32_t in;
+        uint32_t out;
+    } rates[] = {{48000, 16000}, {44100, 48000}, {48000, 48000}, {44100, 47999}};
+    for (const auto &rate : rates) {
+        for (const float driftPpm : {1000.f, -250.f}) {
+            SCOPED_TRACE(testing::Message() << rate.in << " to " << rate.out
+                    << " drift " << driftPpm);
+            struct resampler_itfe *resampler;
+            ASSERT_EQ(0, create_polyphase_resampler(rate.in, rate.out, 1 /* channelCount */,
+                    RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+            ASSERT_EQ(0, resampler->set_input_drift_ppm(resampler, driftPpm));
+            const size_t frames = rate.in / 2;
+            const std::vector<float> out = resample(resampler, 1 /* channelCount */,
+                    makeSines(rate.in, frames, {1000.}), 480 /* blockFrames */, resampleFloat);
+            release_resampler(resampler);
+            const double scale = 1. + driftPpm * 1e-6;
+            const size_t expected = (frames - 1) * rate.out / rate.in / scale;
+            EXPECT_LE(out.size(), expected + 1);
+            EXPECT_GE(out.size(), expected - 200);
+            const std::vector<float> sines = makeSines(rate.out, out.size(), {1000. * scale});
+            float maxError = 0.f;
+            for (size_t i = 200; i < out.size(); ++i) {
+                maxError = std::max(maxError, fabsf(out[i] - sines[i]));
+            }
+            EXPECT_LT(maxError, 1e-3f);
+        }
+    }
+
+    struct resampler_itfe *resampler;
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 16000, 1 /* channelCount */,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+    EXPECT_EQ(-EINVAL, resampler->set_input_drift_ppm(resampler, RESAMPLER_MAX_DRIFT_PPM * 2));
+    release_resampler(resampler);
+}
+
+TEST(audio_utils_resampler, stopband) {
+    // A tone above the output Nyquist frequency is removed.
+    const std::vector<float> out = resampleSines(48000, 16000, {12000.}, 24000);
+    ASSERT_GT(out.size(), 1000u);
+    double energy = 0.;
+    for (size_t i = 200; i < out.size(); ++i) {
+        energy += out[i] * out[i];
+    }
+    const double rms = sqrt(energy / (out.size() - 200));
+    EXPECT_LT(20. * log10(rms / (0.5 / sqrt(2.))), -60.);
+}
+
+TEST(audio_utils_resampler, channels_and_blocks) {
+    // Each channel is resampled as if alone, whatever the blocks.
+    const std::vector<double> frequencies = {100., 300., 1000., 2000., 3000., 5000., 7000.,
+            200., 400., 600.};
+    const std::vector<float> out = resampleSines(44100, 48000, frequencies, 22050);
+    for (const size_t blockFrames : {1, 7, 480, 4096}) {
+        EXPECT_EQ(out, resampleSines(44100, 48000, frequencies, 22050, blockFrames));
+    }
+    const size_t channelCount = frequencies.size();
+    for (size_t ch = 0; ch < channelCount; ++ch) {
+        const std::vector<float> mono = resampleSines(44100, 48000, {frequencies[ch]}, 22050);
+        ASSERT_EQ(out.size(), mono.size() * channelCount);
+        for (size_t i = 0; i < mono.size(); ++i) {
+            ASSERT_EQ(mono[i], out[i * channelCount + ch]) << "channel " << ch << " frame " << i;
+        }
+    }
+}
+
+TEST(audio_utils_resampler, formats) {
+    const uint32_t channelCount = 2;
+    const std::vector<float> in = makeSines(48000, 4800, {440., 1000.});
+    std::vector<int16_t> in16(in.size());
+    memcpy_to_i16_from_float(in16.data(), in.data(), in.size());
+    std::vector<int32_t> in32(in.size());
+    memcpy_to_i32_from_float(in32.data(), in.data(), in.size());
+
+    struct resampler_itfe *resampler;
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 16000, channelCount, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler));
+    const std::vector<float> out = resample(resampler, channelCount, in, 480, resampleFloat);
+    resampler->reset(resampler);
+    const std::vector<int16_t> out16 = resample(resampler, channelCount, in16, 480, resampleI16);
+    resampler->reset(resampler);
+    const std::vector<int32_t> out32 = resample(resampler, channelCount, in32, 480, resampleI32);
+    // Reset restores the initial state.
+    resampler->reset(resampler);
+    EXPECT_EQ(out, resample(resampler, channelCount, in, 480, resampleFloat));
+    release_resampler(resampler);
+
+    ASSERT_EQ(out.size(), out16.size());
+    ASSERT_EQ(out.size(), out32.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(out[i], float_from_i16(out16[i]), 2.f / (1 << 15));
+        EXPECT_NEAR(out[i], float_from_i32(out32[i]), 1e-6f);
+    }
+}
+
+TEST(audio_utils_resampler, backends) {
+    // The vector backends agree with the scalar code, up to the order of the additions.
+    const audio_utils_primitives_backend_t backend = audio_utils_primitives_get_backend();
+    const std::vector<double> frequencies = {1000., 3000., 5000.};
+    const std::vector<float> out = resampleSines(44100, 47999, frequencies, 22050);
+    ASSERT_EQ(0, audio_utils_primitives_set_backend(AUDIO_UTILS_PRIMITIVES_BACKEND_SCALAR));
+    const std::vector<float> scalar = resampleSines(44100, 47999, frequencies, 22050);
+    ASSERT_EQ(0, audio_utils_primitives_set_backend(backend));
+    ASSERT_EQ(out.size(), scalar.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_NEAR(scalar[i], out[i], 1e-6f);
+    }
+}
+
+// A provider of the frames of a buffer, in pieces of at most kMaxFrames.
+struct BufferProvider {
+    static constexpr size_t kMaxFrames = 100;
+    struct resampler_buffer_provider mProvider;
+    const int16_t *mFrames;
+    size_t mFrameCount;
+    uint32_t mChannelCount;
+    size_t mRead = 0;
+
+    BufferProvider(const std::vector<int16_t> &frames, uint32_t channelCount)
+        : mFrames(frames.data())
+        , mFrameCount(frames.size() / channelCount)
+        , mChannelCount(channelCount) {
+        mProvider.get_next_buffer = getNextBuffer;
+        mProvider.release_buffer = releaseBuffer;
+    }
+
+    static int getNextBuffer(struct resampler_buffer_provider *provider,
+            struct resampler_buffer *buffer) {
+        BufferProvider *self = reinterpret_cast<BufferProvider *>(provider);
+        buffer->frame_count = std::min({buffer->frame_count, kMaxFrames,
+                self->mFrameCount - self->mRead});
+        if (buffer->frame_count == 0) {
+            buffer->raw = NULL;
+            return -ENODATA;
+        }
+        buffer->raw = const_cast<int16_t *>(self->mFrames + self->mRead * self->mChannelCount);
+        return 0;
+    }
+
+    static void releaseBuffer(struct resampler_buffer_provider *provider,
+            struct resampler_buffer *buffer) {
+        reinterpret_cast<BufferProvider *>(provider)->mRead += buffer->frame_count;
+    }
+};
+
+TEST(audio_utils_resampler, provider) {
+    const uint32_t channelCount = 2;
+    std::vector<int16_t> in(9600 * channelCount);
+    memcpy_to_i16_from_float(in.data(), makeSines(48000, 9600, {440., 1000.}).data(),
+            in.size());
+    struct resampler_itfe *resampler;
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 44100, channelCount, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler));
+    const std::vector<int16_t> expected = resample(resampler, channelCount, in, 480, resampleI16);
+    release_resampler(resampler);
+
+    BufferProvider provider(in, channelCount);
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 44100, channelCount, RESAMPLER_QUALITY_DEFAULT,
+            &provider.mProvider, &resampler));
+    // The resampler only takes the frames it needs.
+    int16_t frames[441 * channelCount];
+    size_t outFrames = 441;
+    ASSERT_EQ(0, resampler->resample_from_provider(resampler, frames, &outFrames));
+    EXPECT_EQ(441u, outFrames);
+    EXPECT_LT(provider.mRead, 480u + 64u);
+    EXPECT_GT(resampler->delay_ns(resampler), 0);
+    std::vector<int16_t> out(frames, frames + outFrames * channelCount);
+    do {
+        outFrames = 441;
+        ASSERT_EQ(0, resampler->resample_from_provider(resampler, frames, &outFrames));
+        out.insert(out.end(), frames, frames + outFrames * channelCount);
+    } while (outFrames == 441);
+    EXPECT_EQ(expected, out);
+
+    // Only the provider may be used.
+    outFrames = 441;
+    size_t inFrames = 441;
+    EXPECT_EQ(-ENOSYS, resampler->resample_from_input(resampler, in.data(), &inFrames,
+            frames, &outFrames));
+    EXPECT_EQ(0u, outFrames);
+    release_resampler(resampler);
+}
+
+TEST(audio_utils_resampler, invalid) {
+    struct resampler_itfe *resampler;
+    EXPECT_EQ(-EINVAL, create_polyphase_resampler(48000, 16000, 1, RESAMPLER_QUALITY_MIN,
+            NULL /* provider */, &resampler));
+    EXPECT_EQ(-EINVAL, create_polyphase_resampler(48000, 16000, 0, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler));
+    EXPECT_EQ(-EINVAL, create_polyphase_resampler(48000, 16000, RESAMPLER_MAX_CHANNEL_COUNT + 1,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+    EXPECT_EQ(-EINVAL, create_polyphase_resampler(0, 16000, 1, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler));
+    EXPECT_EQ(NULL, resampler);
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 16000, RESAMPLER_MAX_CHANNEL_COUNT,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+    size_t frames = 0;
+    EXPECT_EQ(-EINVAL, resampler->resample_from_input_float(resampler, NULL, &frames,
+            NULL, &frames));
+    EXPECT_EQ(-ENOSYS, resampler->resample_from_provider(resampler, NULL, &frames));
+    release_resampler(resampler);
+}
+
+TEST(audio_utils_resampler, default_resampler) {
+    // create_resampler() is speex on Android, and the polyphase resampler elsewhere.
+    struct resampler_itfe *resampler;
+    ASSERT_EQ(0, create_resampler(48000, 16000, 2 /* channelCount */,
+            RESAMPLER_QUALITY_DEFAULT, NULL /* provider */, &resampler));
+    const std::vector<float> out = resample(resampler, 2 /* channelCount */,
+            makeSines(48000, 4800, {440., 1000.}), 480, resampleFloat);
+    EXPECT_GT(resampler->delay_ns(resampler), 0);
+    EXPECT_NEAR(1600. * 2, out.size(), 2. * 64);
+    EXPECT_EQ(0, resampler->set_input_drift_ppm(resampler, 100.f));
+    release_resampler(resampler);
+}
+
+TEST(audio_utils_resampler, filter_bank_cache) {
+    // The resamplers of the same ratio and quality share a filter bank,
+    // whatever their channel count, freed with the last of them.
+    const size_t count = resampler_get_filter_bank_count();
+    struct resampler_itfe *resampler1, *resampler2, *resampler3;
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 16000, 1, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler1));
+    EXPECT_EQ(count + 1, resampler_get_filter_bank_count());
+    ASSERT_EQ(0, create_polyphase_resampler(96000, 32000, 2, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler2));
+    EXPECT_EQ(count + 1, resampler_get_filter_bank_count());
+    ASSERT_EQ(0, create_polyphase_resampler(48000, 16000, 1, RESAMPLER_QUALITY_DESKTOP,
+            NULL /* provider */, &resampler3));
+    EXPECT_EQ(count + 2, resampler_get_filter_bank_count());
+    release_resampler(resampler1);
+    EXPECT_EQ(count + 2, resampler_get_filter_bank_count());
+    release_resampler(resampler2);
+    EXPECT_EQ(count + 1, resampler_get_filter_bank_count());
+    release_resampler(resampler3);
+    EXPECT_EQ(count, resampler_get_filter_bank_count());
+
+    // A resampler using a cached bank resamples as one designing it.
+    const std::vector<double> frequencies = {1000., 5000.};
+    const std::vector<float> cold = resampleSines(44100, 48000, frequencies, 4410);
+    ASSERT_EQ(0, create_polyphase_resampler(44100, 48000, 1, RESAMPLER_QUALITY_DEFAULT,
+            NULL /* provider */, &resampler1));
+    const std::vector<float> warm = resampleSines(44100, 48000, frequencies, 4410);
+    release_resampler(resampler1);
+    EXPECT_EQ(cold, warm);
+}
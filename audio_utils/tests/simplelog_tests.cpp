@@ -22,6 +22,8 @@
 #include <iostream>
 #include <log/log.h>
 
+#include "alloc_counter.h"
+
 using namespace android;
 
 static size_t countNewLines(const std::string &s) {
@@ -84,3 +86,104 @@ TEST(audio_utils_simplelog, basic) {
   12-31 16:00:02.000 Goodbye
      */
 }
+
+// Logs the same lines to a SimpleLog in each mode, checking the dumps agree.
+TEST(audio_utils_simplelog, real_time_matches) {
+    SimpleLog locked;
+    SimpleLog realTime(80 /* maxLogLines */, true /* realTime */);
+    const int64_t oneSecond = 1000000000;
+    int64_t nowNs = oneSecond;
+    for (SimpleLog *slog : {&locked, &realTime}) {
+        char name[] = "track";
+        slog->log(nowNs, "Hello %d", 9);
+        slog->log(nowNs, "%u %ld %lld %zu %zd %jd %td", 1u, -2L, -3LL, (size_t)4, (ssize_t)-5,
+                (intmax_t)6, (ptrdiff_t)-7);
+        slog->log(nowNs, "%hhd %hhu %hd %hu %#x %08X %o", 300, 300, 70000, 70000, 255, 255, 8);
+        slog->log(nowNs, "%5.2f %e %g %a %Lf", 3.14159, 1e-10, 0.5, 1.0, (long double)2.5);
+        slog->log(nowNs, "%-8s| %.3s %c %p %% %s", name, name, 'x', (void *)0x1234,
+                (const char *)nullptr);
+        slog->log(nowNs, "%*d|%-*.*f|%.*s", 6, 42, 8, 2, 1.5, 2, name);
+        slog->log(nowNs, "trailing newlines\n\n");
+        slog->log(nowNs, "%d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+        slog->logs(nowNs, "100% literal");
+        slog->logs(nowNs, std::string(name));
+    }
+    const std::string s = realTime.dumpToString();
+    EXPECT_EQ(locked.dumpToString(), s);
+    EXPECT_EQ((size_t)10, countNewLines(s));
+    std::cout << s << std::flush;
+
+    // The history is kept between dumps.
+    nowNs += oneSecond;
+    locked.log(nowNs, "%s", "more");
+    realTime.log(nowNs, "%s", "more");
+    EXPECT_EQ(locked.dumpToString("  " /* prefix */, 3 /* lines */),
+            realTime.dumpToString("  " /* prefix */, 3 /* lines */));
+    EXPECT_EQ(locked.dumpToString(), realTime.dumpToString());
+}
+
+TEST(audio_utils_simplelog, real_time_limits) {
+    SimpleLog slog(80 /* maxLogLines */, true /* realTime */);
+
+    // Strings are copied when logged.
+    char name[] = "before";
+    slog.log(0 /* nowNs */, "%s", name);
+    strcpy(name, "after");
+
+    // The strings of a line are truncated together.
+    const std::string longString(100, 'a');
+    slog.log(0 /* nowNs */, "%s %s", longString.c_str(), "b");
+    slog.logs(0 /* nowNs */, longString);
+
+    // A line is cut at its first conversion without an argument.
+    slog.log(0 /* nowNs */, "%d %d %d %d %d %d %d %d %d end", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+    slog.log(0 /* nowNs */, "%*d %*d %*d %*d %*d", 1, 1, 2, 2, 3, 3, 4, 4, 5, 5);
+
+    const std::string s = slog.dumpToString();
+    EXPECT_NE(std::string::npos, s.find(" before\n")) << s;
+    const std::string truncated(SimpleLog::kRtStringBytes - 1, 'a');
+    EXPECT_NE(std::string::npos, s.find(" " + truncated + " \n")) << s;
+    EXPECT_NE(std::string::npos, s.find(" " + truncated + "\n")) << s;
+    EXPECT_NE(std::string::npos, s.find(" 1 2 3 4 5 6 7 8 \n")) << s;
+    EXPECT_NE(std::string::npos, s.find(" 1  2   3    4 \n")) << s;
+}
+
+TEST(audio_utils_simplelog, real_time_overflow) {
+    // The ring overflows between dumps, but the lines lost are older than the history.
+    SimpleLog locked(10 /* maxLogLines */);
+    SimpleLog realTime(10 /* maxLogLines */, true /* realTime */);
+    for (int i = 0; i < 1000; ++i) {
+        locked.log(i /* nowNs */, "line %d", i);
+        realTime.log(i /* nowNs */, "line %d", i);
+        if (i % 37 == 0) {
+            EXPECT_EQ(locked.dumpToString(), realTime.dumpToString());
+        }
+    }
+    const std::string s = realTime.dumpToString();
+    EXPECT_EQ(locked.dumpToString(), s);
+    EXPECT_EQ((size_t)10, countNewLines(s));
+    EXPECT_NE(std::string::npos, s.find(" line 999\n")) << s;
+}
+
+TEST(audio_utils_simplelog, real_time_log_does_not_block_or_allocate) {
+    const std::string name("name");
+    for (const bool realTime : {false, true}) {
+        SimpleLog slog(4 /* maxLogLines */, realTime);
+        gAllocations = 0;
+        gLocks = 0;
+        tCounting = true;
+        for (int i = 0; i < 100; ++i) {
+            slog.log("%s %d %f", "line", i, 0.5);
+            slog.logs(-1 /* nowNs */, name);
+        }
+        tCounting = false;
+        slog.dumpToString();
+        if (realTime) {
+            EXPECT_EQ(0, gAllocations);
+            EXPECT_EQ(0, gLocks);
+        } else {
+            // Checks the counting works.
+            EXPECT_EQ(200, gLocks);
+        }
+    }
+}
@@ -59,6 +59,32 @@ static void BM_MeanVariance(benchmark::State& state, int iterlimit, int alphalim
     state.SetComplexityN(count);
 }
 
+// As BM_MeanVariance, but adding the data in one call.
+template <typename Stats>
+static void BM_MeanVarianceBulk(benchmark::State& state, int iterlimit, int alphalimit) {
+    const float alpha = 1. - alphalimit * std::numeric_limits<float>::epsilon();
+    Stats stat(alpha);
+    using T = decltype(stat.getMin());
+    constexpr size_t count = 1 << 20; // exactly one "mega" samples from the distribution.
+    constexpr T range = 1.;
+    std::vector<T> data(count);
+    initUniform(data, -range, range);
+
+    // Run the test
+    int iters = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(data.data());
+        stat.add(data.data(), data.size());
+        benchmark::ClobberMemory();
+        if (++iters % iterlimit == 0) {
+            printf("%d>  alpha:%f  mean:%.17g  variance:%.17g\n",
+                    iters, alpha, (double)stat.getMean(), (double)stat.getPopVariance());
+            stat.reset();
+        }
+    }
+    state.SetComplexityN(count);
+}
+
 
 // Test case:
 // Do we work correctly within the capacity of float statistics when alpha == 1?
@@ -92,6 +118,30 @@ static auto BM_MeanVariance_float_double_double(benchmark::State &state) {
 
 BENCHMARK(BM_MeanVariance_float_double_double);
 
+// benchmark running double, adding the data in one call
+static auto BM_MeanVarianceBulk_float_double_double(benchmark::State &state) {
+    BM_MeanVarianceBulk<android::audio_utils::Statistics<float, double, double>>(state,
+        float_iterlimit, alpha_equals_one_alphalimit);
+}
+
+BENCHMARK(BM_MeanVarianceBulk_float_double_double);
+
+// benchmark running double + Kahan, the default, adding the data one value at a time
+static auto BM_MeanVariance_float_double_Kahan(benchmark::State &state) {
+    BM_MeanVariance<android::audio_utils::Statistics<float>>(state,
+        float_iterlimit, alpha_equals_one_alphalimit);
+}
+
+BENCHMARK(BM_MeanVariance_float_double_Kahan);
+
+// benchmark running double + Kahan, the default, adding the data in one call
+static auto BM_MeanVarianceBulk_float_double_Kahan(benchmark::State &state) {
+    BM_MeanVarianceBulk<android::audio_utils::Statistics<float>>(state,
+        float_iterlimit, alpha_equals_one_alphalimit);
+}
+
+BENCHMARK(BM_MeanVarianceBulk_float_double_Kahan);
+
 // benchmark reference double
 static auto BM_RefMeanVariance_float_double(benchmark::State &state) {
     BM_MeanVariance<android::audio_utils::ReferenceStatistics<float, double>>(state,
@@ -145,4 +195,33 @@ static auto BM_MeanVariance_float_double_double_alpha(benchmark::State &state) {
 
 BENCHMARK(BM_MeanVariance_float_double_double_alpha);
 
+// benchmark running double at alpha, adding the data in one call
+static auto BM_MeanVarianceBulk_float_double_double_alpha(benchmark::State &state) {
+    BM_MeanVarianceBulk<android::audio_utils::Statistics<float, double, double>>(state,
+        float_overflow_iterlimit, alpha_safe_upperbound_iterlimit);
+}
+
+BENCHMARK(BM_MeanVarianceBulk_float_double_double_alpha);
+
+// benchmark running double + Kahan, the default, adding the data in parallel
+// over state.range(0) threads, and merging the results.
+static void BM_MeanVarianceParallel_float_double_Kahan(benchmark::State &state) {
+    android::audio_utils::Statistics<float> stat;
+    constexpr size_t count = 1 << 22;
+    std::vector<float> data(count);
+    initUniform(data, -1.f, 1.f);
+    const size_t threads = state.range(0);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(data.data());
+        android::audio_utils::addParallel(stat, data.data(), data.size(), threads);
+        benchmark::ClobberMemory();
+        stat.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_MeanVarianceParallel_float_double_Kahan)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -348,6 +348,213 @@ TEST(StatisticsTest, stat_variable_alpha)
     verify(stat, rstat);
 }
 
+TEST(StatisticsTest, stat_bulk_add)
+{
+    constexpr size_t TEST_SIZE = 1 << 16;
+    std::vector<double> data(TEST_SIZE);
+    initUniform(data, -1., 1.);
+    data[100] = 3.; // a max and a min in different lanes
+    data[1001] = -3.;
+
+    for (const double alpha : {1., 0.999, 0.9}) {
+        android::audio_utils::ReferenceStatistics<double> rstat(alpha);
+        android::audio_utils::Statistics<double> stat(alpha);
+        android::audio_utils::Statistics<double> bulk(alpha);
+        // Chunks of varying sizes, some too small for the lanes,
+        // and some not a multiple of the lanes.
+        size_t chunk = 1;
+        for (size_t i = 0; i < TEST_SIZE; i += chunk, chunk = chunk * 3 % 1001) {
+            chunk = std::min(chunk, TEST_SIZE - i);
+            bulk.add(&data[i], chunk);
+            for (size_t j = i; j < i + chunk; ++j) {
+                rstat.add(data[j]);
+                stat.add(data[j]);
+            }
+        }
+        printf("alpha: %lf bulk statistics: %s\n", alpha, bulk.toString().c_str());
+        // The order of the additions differs, so the rounding errors differ, and
+        // accumulate over the 1 << 16 values as they do in the recurrence of add().
+        for (const auto *s : {&stat, &bulk}) {
+            EXPECT_EQ(rstat.getN(), s->getN());
+            EXPECT_EQ(rstat.getMin(), s->getMin());
+            EXPECT_EQ(rstat.getMax(), s->getMax());
+            EXPECT_NEAR(rstat.getWeight(), s->getWeight(), rstat.getWeight() * 1e-12);
+            EXPECT_NEAR(rstat.getMean(), s->getMean(), 1e-12);
+            EXPECT_NEAR(rstat.getVariance(), s->getVariance(), rstat.getVariance() * 1e-12);
+            EXPECT_NEAR(rstat.getPopVariance(), s->getPopVariance(),
+                    rstat.getPopVariance() * 1e-12);
+        }
+    }
+
+    // Float data in lanes, with float summation.
+    std::vector<float> floats(TEST_SIZE);
+    initUniform(floats, -1.f, 1.f);
+    floats[7] = std::nanf(""); // a NaN is not a min or max, but is in the mean
+    android::audio_utils::Statistics<float, float, android::audio_utils::KahanSum<float>, float,
+            float> floatStat;
+    floatStat.add(floats.data() + 8, floats.size() - 8);
+    android::audio_utils::ReferenceStatistics<float, double> floatRstat;
+    for (size_t i = 8; i < floats.size(); ++i) {
+        floatRstat.add(floats[i]);
+    }
+    EXPECT_EQ(floatRstat.getMin(), floatStat.getMin());
+    EXPECT_EQ(floatRstat.getMax(), floatStat.getMax());
+    EXPECT_NEAR(floatRstat.getMean(), floatStat.getMean(), 1e-6);
+    EXPECT_NEAR(floatRstat.getVariance(), floatStat.getVariance(), 1e-6);
+    floatStat.add(floats.data(), 8);
+    EXPECT_TRUE(std::isnan(floatStat.getMean()));
+    EXPECT_EQ(floatRstat.getMin(), floatStat.getMin());
+
+    // Vector data is added value by value.
+    using array_t = std::array<double, 2>;
+    std::vector<array_t> arrays(100);
+    initUniform(arrays, -1., 1.);
+    android::audio_utils::Statistics<array_t, array_t, array_t, double,
+            double, android::audio_utils::innerProduct_scalar<array_t>> stat_array, bulk_array;
+    for (const auto &array : arrays) {
+        stat_array.add(array);
+    }
+    bulk_array.add(arrays.data(), arrays.size());
+    EXPECT_EQ(stat_array.getPopVariance(), bulk_array.getPopVariance());
+}
+
+TEST(StatisticsTest, stat_merge)
+{
+    constexpr size_t TEST_SIZE = 1 << 16;
+    std::vector<double> data(TEST_SIZE);
+    initNormal(data, 1000., 1.); // a large mean, so the variance is prone to cancellation
+
+    for (const double alpha : {1., 0.999}) {
+        android::audio_utils::Statistics<double> stat(alpha);
+        stat.add(data.data(), data.size());
+
+        // Shards of different sizes, merged in order.
+        android::audio_utils::Statistics<double> merged(alpha);
+        for (const auto &range : {std::make_pair(0, 1000), std::make_pair(1000, 1001),
+                std::make_pair(1001, 40000), std::make_pair(40000, (int) TEST_SIZE)}) {
+            android::audio_utils::Statistics<double> shard(alpha);
+            shard.add(data.data() + range.first, range.second - range.first);
+            merged.merge(shard);
+        }
+        EXPECT_EQ(stat.getN(), merged.getN());
+        EXPECT_EQ(stat.getMin(), merged.getMin());
+        EXPECT_EQ(stat.getMax(), merged.getMax());
+        EXPECT_NEAR(stat.getWeight(), merged.getWeight(), stat.getWeight() * 1e-12);
+        EXPECT_NEAR(stat.getMean(), merged.getMean(), stat.getMean() * 1e-14);
+        EXPECT_NEAR(stat.getVariance(), merged.getVariance(), stat.getVariance() * 1e-10);
+
+        // Merging nothing, or into nothing, changes nothing.
+        android::audio_utils::Statistics<double> empty(alpha);
+        merged = stat;
+        merged.merge(empty);
+        EXPECT_EQ(stat.getMean(), merged.getMean());
+        EXPECT_EQ(stat.getVariance(), merged.getVariance());
+        empty.merge(stat);
+        EXPECT_EQ(stat.getMean(), empty.getMean());
+        EXPECT_EQ(stat.getVariance(), empty.getVariance());
+    }
+
+    // With rectangular weighting, the order of the merges does not matter.
+    android::audio_utils::Statistics<double> first, second;
+    first.add(data.data(), 100);
+    second.add(data.data() + 100, 200);
+    android::audio_utils::Statistics<double> forward = first, backward = second;
+    forward.merge(second);
+    backward.merge(first);
+    TEST_EXPECT_NEAR(forward.getMean(), backward.getMean());
+    TEST_EXPECT_NEAR(forward.getVariance(), backward.getVariance());
+}
+
+TEST(StatisticsTest, stat_add_parallel)
+{
+    constexpr size_t TEST_SIZE = 1 << 18;
+    std::vector<double> data(TEST_SIZE);
+    initUniform(data, -1., 1.);
+
+    for (const double alpha : {1., 0.9999}) {
+        for (const size_t threads : {1, 3, 8}) {
+            android::audio_utils::Statistics<double> stat(alpha);
+            android::audio_utils::Statistics<double> parallel(alpha);
+            stat.add(data.data(), data.size());
+            android::audio_utils::addParallel(parallel, data.data(), data.size(), threads);
+            EXPECT_EQ(stat.getN(), parallel.getN());
+            EXPECT_EQ(stat.getMin(), parallel.getMin());
+            EXPECT_EQ(stat.getMax(), parallel.getMax());
+            EXPECT_NEAR(stat.getMean(), parallel.getMean(), 1e-12);
+            EXPECT_NEAR(stat.getVariance(), parallel.getVariance(),
+                    stat.getVariance() * 1e-12);
+        }
+    }
+
+    // A linear fit over a noisy line.
+    using array_t = std::array<double, 2>;
+    std::vector<array_t> points(TEST_SIZE);
+    initUniform(points, -1., 1.);
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = {(double) i, 2. + 0.5 * i + points[i][1]};
+    }
+    android::audio_utils::LinearLeastSquaresFit<double> fit, parallelFit;
+    for (const auto &point : points) {
+        fit.add(point);
+    }
+    android::audio_utils::addParallel(parallelFit, points.data(), points.size(), 4);
+    double a, b, r2, pa, pb, pr2;
+    fit.computeYLine(a, b, r2);
+    parallelFit.computeYLine(pa, pb, pr2);
+    EXPECT_NEAR(a, pa, 1e-8); // extrapolated from the mean x of 1 << 17
+    EXPECT_NEAR(b, pb, 1e-12);
+    EXPECT_NEAR(r2, pr2, 1e-12);
+    EXPECT_NEAR(2., pa, 0.01);
+    EXPECT_NEAR(0.5, pb, 1e-6);
+}
+
+TEST(StatisticsTest, quantile_histogram)
+{
+    android::audio_utils::QuantileHistogram<double> histogram;
+    EXPECT_EQ("unavail", histogram.toString());
+    EXPECT_TRUE(std::isnan(histogram.getQuantile(0.5)));
+
+    constexpr size_t TEST_SIZE = 1 << 16;
+    std::vector<double> data(TEST_SIZE);
+    initNormal(data, 1., 3.); // positive and negative values
+    data[0] = 0.;
+    data[1] = 1e-6;  // counted as zero
+    data[2] = 1e6;   // counted in the largest bucket
+    data[3] = std::nan("");
+    for (const double value : data) {
+        histogram.add(value);
+    }
+    EXPECT_EQ((int64_t)TEST_SIZE - 1, histogram.getN());
+    EXPECT_EQ(1e6, histogram.getMax());
+
+    std::vector<double> sorted(data.begin() + 4, data.end());
+    sorted.insert(sorted.end(), {0., 1e-6, 1e6});
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted.front(), histogram.getMin());
+    for (const double q : {0., 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 1.}) {
+        const size_t rank = std::max((size_t)std::ceil(q * sorted.size()), (size_t)1);
+        const double expected = sorted[rank - 1];
+        EXPECT_NEAR(expected, histogram.getQuantile(q), std::abs(expected) / 32 + 1e-9)
+                << "q:" << q;
+    }
+    printf("quantiles: %s\n", histogram.toString().c_str());
+
+    // Merging the histograms of halves gives the histogram of the whole.
+    android::audio_utils::QuantileHistogram<double> first, second;
+    for (size_t i = 0; i < TEST_SIZE; ++i) {
+        (i < TEST_SIZE / 3 ? first : second).add(data[i]);
+    }
+    first.merge(second);
+    EXPECT_EQ(histogram.getN(), first.getN());
+    EXPECT_EQ(histogram.getMin(), first.getMin());
+    EXPECT_EQ(histogram.toString(), first.toString());
+
+    histogram.reset();
+    EXPECT_EQ(0, histogram.getN());
+    histogram.add(-2.);
+    EXPECT_EQ(-2., histogram.getQuantile(0.5));
+}
+
 TEST(StatisticsTest, stat_vector)
 {
     // for operator overloading...
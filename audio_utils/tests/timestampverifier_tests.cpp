@@ -17,6 +17,7 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "audio_utils_timestampverifier_tests"
 
+#include <memory>
 #include <stdio.h>
 
 #include <audio_utils/TimestampVerifier.h>
@@ -99,3 +100,40 @@ TEST(TimestampVerifier, sanity)
     EXPECT_EQ(48000., b);
     EXPECT_NEAR(1., r2, std::numeric_limits<double>::epsilon());
 }
+
+TEST(TimestampVerifier, jitter_quantiles)
+{
+    android::TimestampVerifier<int64_t, int64_t> tv;
+    EXPECT_EQ(nullptr, tv.getJitterMsQuantiles());
+    auto quantiles = std::make_unique<decltype(tv)::JitterQuantiles>();
+    tv.setJitterMsQuantiles(quantiles.get());
+    static_assert(std::is_trivially_copyable<decltype(tv)>::value,
+        "TimestampVerifier must be trivially copyable");
+    static_assert(sizeof(tv) < sizeof(decltype(tv)::JitterQuantiles),
+        "TimestampVerifier must not embed the quantiles");
+
+    // 1000 timestamps 10 ms apart, one in 100 late by 2 ms, one in 1000 late by 20 ms.
+    constexpr uint32_t sampleRate = 48000;
+    int64_t frames = 0;
+    int64_t timeNs = 0;
+    int64_t lateNs = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        tv.add(frames, timeNs + lateNs, sampleRate);
+        frames += sampleRate / 100;
+        timeNs += 10000000;
+        lateNs = i % 1000 == 500 ? 20000000 : i % 100 == 50 ? 2000000 : 0;
+    }
+    // Each late timestamp has a jitter of +late then of -late.
+    EXPECT_EQ(quantiles.get(), tv.getJitterMsQuantiles());
+    EXPECT_EQ(tv.getJitterMs().getN(), quantiles->getN());
+    EXPECT_EQ(0., quantiles->getQuantile(0.5));
+    EXPECT_EQ(0., quantiles->getQuantile(0.98));
+    EXPECT_NEAR(2., quantiles->getQuantile(0.995), 2. / 32);
+    EXPECT_EQ(20., quantiles->getQuantile(1.));
+    EXPECT_EQ(-20., quantiles->getQuantile(0.));
+    EXPECT_NE(std::string::npos, tv.toString().find("jitterMsQuantiles(p50=0 "))
+            << tv.toString();
+
+    tv.setJitterMsQuantiles(nullptr);
+    EXPECT_EQ(std::string::npos, tv.toString().find("jitterMsQuantiles"));
+}